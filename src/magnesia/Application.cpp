@@ -16,6 +16,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <set>
 #include <span>
 #include <utility>
 
@@ -94,10 +95,65 @@ namespace magnesia {
         s_instance = this;
 
         m_settings_manager->defineSettingDomain(
-            "general", {std::make_shared<magnesia::IntSetting>(
-                           "opcua_poll_intervall", "OPC UA Polling Interval",
-                           // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-                           "in milliseconds; reload the application to apply", 500, 10, 30000)});
+            "general",
+            {
+                std::make_shared<magnesia::IntSetting>(
+                    "log_capacity", "Log Capacity",
+                    "log entries kept in memory per connection, older ones are dropped; applies to new connections",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    100000, 100, 10000000),
+                std::make_shared<magnesia::EnumSetting>(
+                    "log_min_level", "Log Level",
+                    "log entries of the OPC UA client below this level are discarded right away; applies to new "
+                    "connections",
+                    "Trace",
+                    std::set<magnesia::EnumSettingValue>{"Trace", "Debug", "Info", "Warning", "Error", "Fatal"}),
+                std::make_shared<magnesia::BooleanSetting>(
+                    "log_persist", "Persist Logs",
+                    "write the log entries of every established connection to rotating files in the data directory, so "
+                    "they can be browsed after the connection is closed; applies to new connections",
+                    false),
+                std::make_shared<magnesia::IntSetting>(
+                    "log_persist_size", "Persisted Log Size",
+                    "megabytes of log files kept for all connections together, the oldest entries are deleted first; "
+                    "applies to new connections",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    1024, 1, 1048576),
+                std::make_shared<magnesia::IntSetting>(
+                    "log_rate_limit", "Log Rate Limit",
+                    "log entries per second and category, further ones are only counted; 0 disables the limit; applies "
+                    "to new connections",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    1000, 0, 1000000),
+                std::make_shared<magnesia::IntSetting>(
+                    "opcua_poll_intervall", "OPC UA Polling Interval",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    "idle fallback and retry delay in milliseconds; reload the application to apply", 500, 10, 30000),
+                std::make_shared<magnesia::IntSetting>(
+                    "opcua_attribute_retry_delay", "OPC UA Attribute Retry Delay",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    "seconds before attributes that failed to be read are read again, unless the node doesn't have "
+                    "them; applies to new connections",
+                    30, 1, 3600),
+                std::make_shared<magnesia::IntSetting>(
+                    "opcua_max_monitored_items_per_subscription", "OPC UA Monitored Items per Subscription",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    "monitored items packed into a single subscription; applies to new connections", 1000, 1, 100000),
+                std::make_shared<magnesia::IntSetting>(
+                    "opcua_time_series_capacity", "OPC UA History Samples",
+                    "numeric values kept in memory per monitored node; applies to new connections",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    100000, 1, 100000000),
+                std::make_shared<magnesia::IntSetting>(
+                    "opcua_time_series_max_age", "OPC UA History Duration",
+                    "seconds numeric values of monitored nodes are kept in memory; applies to new connections",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    3600, 1, 604800),
+                std::make_shared<magnesia::IntSetting>(
+                    "ui_max_refresh_rate", "UI Refresh Rate",
+                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                    "maximum number of times per second live values are redrawn; applies to new panels", 30, 1, 240),
+            });
 
         m_tab_widget->setTabsClosable(true);
         m_tab_widget->setDocumentMode(true);
@@ -153,6 +209,10 @@ namespace magnesia {
         return *m_router;
     }
 
+    const QDir& Application::getDataDir() const noexcept {
+        return m_data_dir;
+    }
+
     void Application::openActivity(Activity* activity, const QString& title, const QString& disambiguator,
                                    bool closable) {
         Q_ASSERT(activity != nullptr);
@@ -94,6 +94,11 @@ namespace magnesia {
          */
         Router& getRouter();
 
+        /**
+         * Provides the directory application data like the database and recordings is kept in.
+         */
+        [[nodiscard]] const QDir& getDataDir() const noexcept;
+
         /**
          * Opens a new tab that contains the activity.
          *
@@ -90,6 +90,21 @@ namespace magnesia::activities::dataviewer {
             return {};
         }
 
+        QString to_qstring(Connection::ConnectStage stage) {
+            switch (stage) {
+                case Connection::ConnectStage::TCP:
+                    return "Opening secure channel...";
+                case Connection::ConnectStage::SECURE_CHANNEL:
+                    return "Creating session...";
+                case Connection::ConnectStage::SESSION:
+                    return "Activating session...";
+                case Connection::ConnectStage::ACTIVATED:
+                    return "Connected";
+            }
+            Q_ASSERT(false);
+            return {};
+        }
+
         QString format_security_policy(QString uri) {
             return uri.remove("http://opcfoundation.org/UA/SecurityPolicy#");
         }
@@ -128,8 +143,10 @@ namespace magnesia::activities::dataviewer {
             return true;
         }
 
-        void open_dataviewer(Connection* connection, opcua_qt::Logger* logger) {
-            Application::instance().openActivity(new DataViewer(connection, logger), "DataViewer",
+        void open_dataviewer(Connection* connection) {
+            // only established connections leave a log behind
+            connection->getLogger()->startPersistingHistory();
+            Application::instance().openActivity(new DataViewer(connection, connection->getLogger()), "DataViewer",
                                                  connection->getEndpointUrl().toString());
         }
     } // namespace
@@ -197,6 +214,19 @@ namespace magnesia::activities::dataviewer {
             connect(m_connect_button, &QPushButton::clicked, this, &ConfigWidget::onConnect);
             layout->addRow(m_connect_button);
         }
+        {
+            auto* status_layout = new QHBoxLayout;
+
+            m_connect_status = new QLabel;
+            status_layout->addWidget(m_connect_status, 1);
+
+            m_cancel_button = new QPushButton("Cancel");
+            m_cancel_button->setHidden(true);
+            connect(m_cancel_button, &QPushButton::clicked, this, &ConfigWidget::onCancelConnect);
+            status_layout->addWidget(m_cancel_button);
+
+            layout->addRow(status_layout);
+        }
 
         return layout;
     }
@@ -255,7 +285,6 @@ namespace magnesia::activities::dataviewer {
 
             auto builder = std::make_unique<ConnectionBuilder>();
             (*builder)
-                .logger(new opcua_qt::Logger)
                 .url(historic.server_url)
                 .trustList(historic.trust_list_certificate_ids)
                 .revokedList(historic.revoked_list_certificate_ids)
@@ -280,8 +309,9 @@ namespace magnesia::activities::dataviewer {
             // signal connection is destroyed
             connect(connection, &Connection::connected, this, [connection, conid, builder = std::move(builder)] {
                 record_recent_connection(*builder, conid);
-                open_dataviewer(connection, builder->getLogger());
+                open_dataviewer(connection);
             });
+            trackConnectionAttempt(connection);
             connection->connectAndRun();
         });
 
@@ -304,7 +334,6 @@ namespace magnesia::activities::dataviewer {
                               << "\n  password:" << m_password->text();
 
         m_current_connection_builder = std::make_shared<ConnectionBuilder>();
-        m_current_connection_builder->logger(new opcua_qt::Logger);
 
         m_current_connection_builder->url(m_address->text());
         if (auto username = m_username->text(); !username.isEmpty()) {
@@ -367,12 +396,54 @@ namespace magnesia::activities::dataviewer {
         connect(connection, &Connection::connected, this, [this, connection, builder = m_current_connection_builder] {
             record_recent_connection(*builder);
             reset();
-            open_dataviewer(connection, builder->getLogger());
+            open_dataviewer(connection);
         });
+        connect(connection, &Connection::connectFailed, this, [this] { m_connect_button->setEnabled(true); });
         m_connect_button->setEnabled(false);
+        trackConnectionAttempt(connection);
         connection->connectAndRun();
     }
 
+    void ConfigWidget::onCancelConnect() {
+        if (m_pending_connection.isNull()) {
+            return;
+        }
+        qCDebug(lc_dv_config) << "cancelling connection to" << m_pending_connection->getEndpointUrl();
+
+        // deleting the connection right away would wait for its network thread
+        connect(m_pending_connection, &Connection::disconnected, m_pending_connection, &QObject::deleteLater);
+        m_pending_connection->cancelConnect();
+        m_pending_connection = nullptr;
+
+        m_connect_status->setText("Connection cancelled");
+        m_cancel_button->setHidden(true);
+        m_connect_button->setEnabled(m_endpoint_selector->selectionModel()->hasSelection());
+    }
+
+    void ConfigWidget::trackConnectionAttempt(Connection* connection) {
+        // only one connection attempt at a time
+        onCancelConnect();
+
+        m_pending_connection = connection;
+        m_connect_status->setText("Connecting to " + connection->getEndpointUrl().toString() + "...");
+        m_cancel_button->setHidden(false);
+
+        connect(connection, &Connection::connectStageReached, this, [this](Connection::ConnectStage stage) {
+            m_connect_status->setText(to_qstring(stage));
+        });
+        connect(connection, &Connection::connected, this, [this] {
+            m_pending_connection = nullptr;
+            m_connect_status->clear();
+            m_cancel_button->setHidden(true);
+        });
+        connect(connection, &Connection::connectFailed, this, [this, connection](const QString& reason) {
+            m_pending_connection = nullptr;
+            m_connect_status->setText("Connection failed: " + reason);
+            m_cancel_button->setHidden(true);
+            connection->deleteLater();
+        });
+    }
+
     namespace detail {
         int EndpointTableModel::rowCount(const QModelIndex& /*parent*/) const {
             return static_cast<int>(m_endpoints.size());
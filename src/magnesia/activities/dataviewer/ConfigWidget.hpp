@@ -5,6 +5,7 @@
 #include "../../StorageManager.hpp"
 #include "../../database_types.hpp"
 #include "../../opcua_qt/ApplicationCertificate.hpp"
+#include "../../opcua_qt/Connection.hpp"
 #include "../../opcua_qt/ConnectionBuilder.hpp"
 #include "../../opcua_qt/abstraction/Endpoint.hpp"
 
@@ -18,10 +19,12 @@
 #include <QAbstractListModel>
 #include <QAbstractTableModel>
 #include <QComboBox>
+#include <QLabel>
 #include <QLayout>
 #include <QLineEdit>
 #include <QModelIndex>
 #include <QObject>
+#include <QPointer>
 #include <QPushButton>
 #include <QTableView>
 #include <QVariant>
@@ -52,11 +55,18 @@ namespace magnesia::activities::dataviewer {
         QLayout* buildQuickConnect();
         QLayout* buildRecentConnections();
         void     reset();
+        /**
+         * @brief Shows the progress of a connection attempt and aborts the previous attempt, if any.
+         *
+         * @param connection the connection that is being established
+         */
+        void trackConnectionAttempt(opcua_qt::Connection* connection);
 
       private slots:
         void onFindEndpoints();
         void onEndpointsFound(const opcua::Result<std::vector<opcua_qt::Endpoint>>& result);
         void onConnect();
+        void onCancelConnect();
 
       private:
         std::size_t m_count{};
@@ -74,6 +84,11 @@ namespace magnesia::activities::dataviewer {
         QTableView*                 m_endpoint_selector{nullptr};
 
         QPushButton* m_connect_button{nullptr};
+
+        // connection attempt
+        QPointer<opcua_qt::Connection> m_pending_connection;
+        QLabel*                        m_connect_status{nullptr};
+        QPushButton*                   m_cancel_button{nullptr};
     };
 
     namespace detail {
@@ -7,6 +7,9 @@
 #include "../../database_types.hpp"
 #include "../../opcua_qt/Connection.hpp"
 #include "../../opcua_qt/Logger.hpp"
+#include "../../opcua_qt/RecordingReplay.hpp"
+#include "../../opcua_qt/RecordingSegment.hpp"
+#include "../../opcua_qt/SubscriptionManager.hpp"
 #include "../../qt_version_check.hpp"
 #include "layout.hpp"
 
@@ -14,9 +17,13 @@
 #include <cstddef>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include <QAbstractItemModel>
 #include <QComboBox>
+#include <QDateTime>
+#include <QDir>
+#include <QFileDialog>
 #include <QHBoxLayout>
 #include <QLayout>
 #include <QLineEdit>
@@ -38,6 +45,8 @@
 
 namespace {
     Q_LOGGING_CATEGORY(lc_data_viewer, "magnesia.dataviewer.configwidget")
+
+    constexpr auto c_recordings_dir = "recordings";
 } // namespace
 
 namespace magnesia::activities::dataviewer {
@@ -57,6 +66,7 @@ namespace magnesia::activities::dataviewer {
         address_view->setText(m_connection->getEndpointUrl().toString());
         address_layout->addWidget(address_view, Qt::AlignCenter);
 
+        address_layout->addLayout(buildRecordingControls());
         address_layout->addLayout(buildLayoutSelector());
 
         layout->addLayout(address_layout);
@@ -74,6 +84,87 @@ namespace magnesia::activities::dataviewer {
         return m_logger;
     }
 
+    QLayout* DataViewer::buildRecordingControls() {
+        using opcua_qt::RecordingReplay;
+
+        auto* layout = new QHBoxLayout;
+
+        auto* record_button = new QPushButton("Record");
+        record_button->setCheckable(true);
+        record_button->setToolTip("Record all received values to disk");
+        layout->addWidget(record_button);
+
+        auto* replay_button = new QPushButton("Replay...");
+        replay_button->setCheckable(true);
+        replay_button->setToolTip("Show the values of a recording instead of the received ones");
+        layout->addWidget(replay_button);
+
+        auto* speed_selector = new QComboBox;
+        speed_selector->addItem("1x", QVariant::fromValue(RecordingReplay::Speed::REAL_TIME));
+        speed_selector->addItem("10x", QVariant::fromValue(RecordingReplay::Speed::TEN_TIMES));
+        speed_selector->addItem("Max", QVariant::fromValue(RecordingReplay::Speed::MAXIMUM));
+        layout->addWidget(speed_selector);
+
+        const QDir recordings{Application::instance().getDataDir().absoluteFilePath(c_recordings_dir)};
+
+        connect(record_button, &QPushButton::toggled, this, [this, record_button, recordings](bool checked) {
+            auto* manager = m_connection->getSubscriptionManager();
+            if (!checked) {
+                manager->stopRecording();
+                return;
+            }
+            const auto name = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+            if (!manager->startRecording(QDir{recordings.absoluteFilePath(name)})) {
+                QMessageBox::warning(this, "Recording failed", "Could not create a recording in " + recordings.path());
+                record_button->setChecked(false);
+                return;
+            }
+            qCInfo(lc_data_viewer) << "Recording to" << recordings.absoluteFilePath(name);
+        });
+
+        connect(replay_button, &QPushButton::toggled, this,
+                [this, replay_button, speed_selector, recordings](bool checked) {
+                    auto* manager = m_connection->getSubscriptionManager();
+                    if (!checked) {
+                        if (m_replay == nullptr) {
+                            return;
+                        }
+                        // may be unchecked by the replay's own finished signal, no step may run until it is deleted
+                        m_replay->pause();
+                        m_replay->deleteLater();
+                        m_replay = nullptr;
+                        manager->setReplay(nullptr);
+                        return;
+                    }
+
+                    const auto directory =
+                        QFileDialog::getExistingDirectory(this, "Open recording", recordings.absolutePath());
+                    m_replay = directory.isEmpty() ? nullptr : RecordingReplay::open(QDir{directory}, this);
+                    if (m_replay == nullptr) {
+                        replay_button->setChecked(false);
+                        return;
+                    }
+                    manager->setReplay(m_replay);
+                    connect(m_replay, &RecordingReplay::recordsReplayed, manager,
+                            [manager](const std::vector<opcua_qt::RecordingSegment::Record>& records) {
+                                manager->replay(records);
+                            });
+                    // received values are shown again once the recording is over
+                    connect(m_replay, &RecordingReplay::finished, replay_button,
+                            [replay_button] { replay_button->setChecked(false); });
+                    m_replay->setSpeed(speed_selector->currentData().value<RecordingReplay::Speed>());
+                    m_replay->start();
+                });
+
+        connect(speed_selector, &QComboBox::currentIndexChanged, this, [this, speed_selector](int index) {
+            if (m_replay != nullptr) {
+                m_replay->setSpeed(speed_selector->itemData(index).value<RecordingReplay::Speed>());
+            }
+        });
+
+        return layout;
+    }
+
     QLayout* DataViewer::buildLayoutSelector() {
         auto* layout = new QHBoxLayout;
 
@@ -6,6 +6,7 @@
 #include "../../database_types.hpp"
 #include "../../opcua_qt/Connection.hpp"
 #include "../../opcua_qt/Logger.hpp"
+#include "../../opcua_qt/RecordingReplay.hpp"
 #include "../../opcua_qt/abstraction/NodeId.hpp"
 #include "dataviewer_fwd.hpp"
 
@@ -65,11 +66,14 @@ namespace magnesia::activities::dataviewer {
 
       private:
         QLayout* buildLayoutSelector();
+        QLayout* buildRecordingControls();
 
       private:
         layout::PanelLayout*  m_root_layout;
         opcua_qt::Connection* m_connection;
         opcua_qt::Logger*     m_logger;
+        // replaces the received values while set
+        opcua_qt::RecordingReplay* m_replay{nullptr};
 
         int m_old_layout_index{-1};
     };
@@ -6,14 +6,32 @@
 #include "dataviewer_fwd.hpp"
 #include "panels.hpp"
 
+#include <chrono>
+
 #include <QJsonObject>
+#include <QTimer>
 #include <QWidget>
+#include <QtEvents>
+
+namespace {
+    constexpr std::chrono::seconds c_hide_delay{1};
+} // namespace
 
 namespace magnesia::activities::dataviewer {
     Panel::Panel(DataViewer* dataviewer, panels::PanelType panel, PanelMetadata metadata, QWidget* parent)
-        : QWidget(parent), m_panel_type(panel), m_metadata(metadata), m_dataviewer(dataviewer) {
+        : QWidget(parent), m_panel_type(panel), m_metadata(metadata), m_dataviewer(dataviewer),
+          m_hide_timer(new QTimer(this)) {
         connect(this, &Panel::nodeSelected, dataviewer, &DataViewer::nodeSelected);
         connect(m_dataviewer, &DataViewer::nodeSelected, this, &Panel::selectNodeAll);
+
+        m_hide_timer->setSingleShot(true);
+        m_hide_timer->setInterval(c_hide_delay);
+        connect(m_hide_timer, &QTimer::timeout, this, [this] {
+            m_visible = false;
+            onVisibilityChanged(false);
+        });
+        // panels created in a hidden tab never receive a hide event
+        m_hide_timer->start();
     }
 
     void Panel::selectNodeAll(const opcua_qt::abstraction::NodeId& node, panels::PanelTypes recipients) {
@@ -26,6 +44,41 @@ namespace magnesia::activities::dataviewer {
         // don't do anything in the default implementation
     }
 
+    void Panel::onVisibilityChanged(bool /*visible*/) {
+        // don't do anything in the default implementation
+    }
+
+    void Panel::showEvent(QShowEvent* event) {
+        QWidget::showEvent(event);
+        updateVisibility();
+    }
+
+    void Panel::hideEvent(QHideEvent* event) {
+        QWidget::hideEvent(event);
+        updateVisibility();
+    }
+
+    void Panel::resizeEvent(QResizeEvent* event) {
+        QWidget::resizeEvent(event);
+        // collapsed splitter panes stay visible but have no size
+        updateVisibility();
+    }
+
+    void Panel::updateVisibility() {
+        if (!isVisible() || size().isEmpty()) {
+            if (m_visible && !m_hide_timer->isActive()) {
+                m_hide_timer->start();
+            }
+            return;
+        }
+
+        m_hide_timer->stop();
+        if (!m_visible) {
+            m_visible = true;
+            onVisibilityChanged(true);
+        }
+    }
+
     QJsonObject Panel::saveState() const {
         // don't do anything in the default implementation
         return {};
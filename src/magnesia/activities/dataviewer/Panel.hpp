@@ -5,7 +5,9 @@
 #include "dataviewer_fwd.hpp"
 
 #include <QJsonObject>
+#include <QTimer>
 #include <QWidget>
+#include <QtEvents>
 #include <qtmetamacros.h>
 
 namespace magnesia::activities::dataviewer {
@@ -58,6 +60,21 @@ namespace magnesia::activities::dataviewer {
          */
         [[nodiscard]] DataViewer* getDataViewer() const noexcept;
 
+        /**
+         * Called when the panel stops or starts being on screen, e.g. because its tab was switched or its splitter pane
+         * collapsed. Panels can use this to stop processing updates nobody sees. Hiding is reported with a short
+         * delay, so quickly switching back and forth doesn't cause any work. The default implementation is a no-op.
+         *
+         * @param visible whether the panel is on screen now.
+         */
+        virtual void onVisibilityChanged(bool visible);
+
+      protected:
+        // track the visibility for onVisibilityChanged, only called by Qt
+        void showEvent(QShowEvent* event) override;
+        void hideEvent(QHideEvent* event) override;
+        void resizeEvent(QResizeEvent* event) override;
+
       protected slots:
         /**
          * Called when any Panel signals that a node was selected. The default implementation filters calls to the ones
@@ -76,9 +93,19 @@ namespace magnesia::activities::dataviewer {
          */
         virtual void selectNode(const opcua_qt::abstraction::NodeId& node);
 
+      private:
+        /**
+         * Reports visibility changes to `Panel::onVisibilityChanged`.
+         */
+        void updateVisibility();
+
       private:
         panels::PanelType m_panel_type;
         PanelMetadata     m_metadata;
         DataViewer*       m_dataviewer;
+        // delays reporting that the panel was hidden
+        QTimer*           m_hide_timer;
+        // as last reported to onVisibilityChanged
+        bool              m_visible{true};
     };
 } // namespace magnesia::activities::dataviewer
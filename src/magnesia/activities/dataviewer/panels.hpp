@@ -6,6 +6,7 @@
 #include "panels/NodeViewPanel.hpp"
 #include "panels/ReferenceViewPanel.hpp"
 #include "panels/TreeViewPanel.hpp"
+#include "panels/TrendPlotPanel.hpp"
 
 #include <array>
 
@@ -15,7 +16,7 @@ namespace magnesia::activities::dataviewer::panels {
      */
     inline constexpr std::array all{
         treeview_panel::metadata,  attribute_view_panel::metadata, reference_view_panel::metadata,
-        node_view_panel::metadata, log_view_panel::metadata,
+        node_view_panel::metadata, log_view_panel::metadata,       trend_plot_panel::metadata,
     };
 
     /**
@@ -28,5 +29,6 @@ namespace magnesia::activities::dataviewer::panels {
         logview       = 0x1 << 3,
         referenceview = 0x1 << 4,
         nodeview      = 0x1 << 5,
+        trendplot     = 0x1 << 6,
     };
 } // namespace magnesia::activities::dataviewer::panels
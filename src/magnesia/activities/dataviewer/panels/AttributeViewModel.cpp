@@ -1,6 +1,8 @@
 #include "AttributeViewModel.hpp"
 
 #include "../../../opcua_qt/Connection.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
+#include "../../../opcua_qt/SubscriptionManager.hpp"
 #include "../../../opcua_qt/abstraction/AccessLevel.hpp"
 #include "../../../opcua_qt/abstraction/AccessLevelBitmask.hpp"
 #include "../../../opcua_qt/abstraction/AttributeId.hpp"
@@ -18,14 +20,18 @@
 #include "../../../qt_version_check.hpp"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include <QAbstractItemModel>
 #include <QModelIndex>
+#include <QPointer>
 #include <QString>
 #include <QVariant>
 #include <Qt>
@@ -38,6 +44,8 @@
 #endif
 
 using magnesia::opcua_qt::Connection;
+using magnesia::opcua_qt::MonitoredItemSet;
+using magnesia::opcua_qt::SubscriptionManager;
 using magnesia::opcua_qt::abstraction::access_level_to_string;
 using magnesia::opcua_qt::abstraction::AccessLevelBitmask;
 using magnesia::opcua_qt::abstraction::AttributeId;
@@ -50,7 +58,6 @@ using magnesia::opcua_qt::abstraction::node_class_to_string;
 using magnesia::opcua_qt::abstraction::NodeClass;
 using magnesia::opcua_qt::abstraction::NodeId;
 using magnesia::opcua_qt::abstraction::QualifiedName;
-using magnesia::opcua_qt::abstraction::Subscription;
 using magnesia::opcua_qt::abstraction::value_rank_to_string;
 using magnesia::opcua_qt::abstraction::ValueRank;
 using magnesia::opcua_qt::abstraction::write_mask_to_string;
@@ -63,13 +70,33 @@ namespace {
     constexpr unsigned int c_sub_id_size          = 8;
     constexpr unsigned int c_attribute_id_mask    = 0xFF;
 
-    void append_if(bool append, AttributeId value, std::vector<AttributeId>& target) {
-        if (!append) {
-            return;
-        }
-
-        target.push_back(value);
-    }
+    constexpr std::chrono::milliseconds c_publishing_interval{500};
+
+    // in the order they are shown
+    constexpr std::array c_attributes{
+        AttributeId::NODE_ID,
+        AttributeId::NODE_CLASS,
+        AttributeId::BROWSE_NAME,
+        AttributeId::DISPLAY_NAME,
+        AttributeId::DESCRIPTION,
+        AttributeId::WRITE_MASK,
+        AttributeId::USER_WRITE_MASK,
+        AttributeId::IS_ABSTRACT,
+        AttributeId::SYMMETRIC,
+        AttributeId::INVERSE_NAME,
+        AttributeId::CONTAINS_NO_LOOPS,
+        AttributeId::EVENT_NOTFIER,
+        AttributeId::VALUE,
+        AttributeId::DATA_TYPE,
+        AttributeId::VALUE_RANK,
+        AttributeId::ARRAY_DIMENSIONS,
+        AttributeId::ACCESS_LEVEL,
+        AttributeId::USER_ACCESS_LEVEL,
+        AttributeId::MINIMUM_SAMPLING_INTERVAL,
+        AttributeId::HISTORIZING,
+        AttributeId::EXECUTABLE,
+        AttributeId::USER_EXECUTABLE,
+    };
 
     constexpr AttributeId attribute_id(std::uint32_t item_id) noexcept {
         return static_cast<AttributeId>(item_id & c_attribute_id_mask);
@@ -231,9 +258,9 @@ namespace {
         return title ? name : value->getValue().toQVariant();
     }
 
-    QVariant data_type_data(bool title, const std::optional<NodeId>& value, Connection* connection,
+    QVariant data_type_data(bool title, const std::optional<NodeId>& value, const std::optional<QString>& type_name,
                             const QString& name) {
-        if (!value.has_value() || connection == nullptr) {
+        if (!value.has_value()) {
             return {};
         }
 
@@ -241,13 +268,8 @@ namespace {
             return name;
         }
 
-        if (auto node = connection->getNode(*value); node.has_value()) {
-            if (const auto* display_name = (*node)->getDisplayName(); display_name != nullptr) {
-                return display_name->getText();
-            }
-        }
-
-        return {};
+        // the node id is shown until the name of the data type has been read
+        return type_name.value_or(value->toString());
     }
 } // namespace
 
@@ -255,49 +277,91 @@ namespace magnesia::activities::dataviewer::panels::attribute_view_panel {
     AttributeViewModel::AttributeViewModel(QObject* parent) : QAbstractItemModel(parent) {}
 
     void AttributeViewModel::setNode(Node* node, Connection* connection) {
-        beginResetModel();
+        if (m_node != nullptr) {
+            disconnect(m_node, &Node::attributesLoaded, this, nullptr);
+        }
+        if (m_monitored_items != nullptr) {
+            m_monitored_items->deleteLater();
+            m_monitored_items = nullptr;
+        }
 
+        beginResetModel();
         m_connection = connection;
         m_node       = node;
+        m_data_type_name.reset();
+        updateAvailableAttributes();
+        endResetModel();
 
-        m_available_attributes.clear();
+        if (node->areAttributesLoaded()) {
+            subscribeAttributes();
+            return;
+        }
+        // Show the cached attributes right away, the others are added once they have been read.
+        connect(node, &Node::attributesLoaded, this, &AttributeViewModel::attributesLoaded);
+        node->loadAttributesAsync();
+    }
 
-        m_available_attributes.push_back(AttributeId::NODE_ID);
-        m_available_attributes.push_back(AttributeId::NODE_CLASS);
-        m_available_attributes.push_back(AttributeId::BROWSE_NAME);
-        m_available_attributes.push_back(AttributeId::DISPLAY_NAME);
-        append_if(node->getDescription() != nullptr, AttributeId::DESCRIPTION, m_available_attributes);
-        append_if(node->getWriteMask().has_value(), AttributeId::WRITE_MASK, m_available_attributes);
-        append_if(node->getUserWriteMask().has_value(), AttributeId::USER_WRITE_MASK, m_available_attributes);
-        append_if(node->isAbstract().has_value(), AttributeId::IS_ABSTRACT, m_available_attributes);
-        append_if(node->isSymmetric().has_value(), AttributeId::SYMMETRIC, m_available_attributes);
-        append_if(node->getInverseName() != nullptr, AttributeId::INVERSE_NAME, m_available_attributes);
-        append_if(node->containsNoLoops().has_value(), AttributeId::CONTAINS_NO_LOOPS, m_available_attributes);
-        append_if(node->getEventNotifierType().has_value(), AttributeId::EVENT_NOTFIER, m_available_attributes);
-        append_if(node->getDataValue() != nullptr, AttributeId::VALUE, m_available_attributes);
-        append_if(node->getDataType().has_value(), AttributeId::DATA_TYPE, m_available_attributes);
-        append_if(node->getValueRank().has_value(), AttributeId::VALUE_RANK, m_available_attributes);
-        append_if(node->getArrayDimensions() != nullptr, AttributeId::ARRAY_DIMENSIONS, m_available_attributes);
-        append_if(node->getAccessLevel().has_value(), AttributeId::ACCESS_LEVEL, m_available_attributes);
-        append_if(node->getUserAccessLevel().has_value(), AttributeId::USER_ACCESS_LEVEL, m_available_attributes);
-        append_if(node->getMinimumSamplingInterval().has_value(), AttributeId::MINIMUM_SAMPLING_INTERVAL,
-                  m_available_attributes);
-        append_if(node->isHistorizing().has_value(), AttributeId::HISTORIZING, m_available_attributes);
-        append_if(node->isExecutable().has_value(), AttributeId::EXECUTABLE, m_available_attributes);
-        append_if(node->isUserExecutable().has_value(), AttributeId::USER_EXECUTABLE, m_available_attributes);
-
-        if (m_subscription != nullptr) {
-            m_subscription->deleteLater();
-        }
-
-        auto* subscription = connection->createSubscription(node, m_available_attributes);
-        if (subscription != nullptr) {
-            m_subscription = subscription;
-            m_subscription->setPublishingMode(true);
-            connect(m_subscription, &Subscription::valueChanged, this, &AttributeViewModel::valueChanged);
+    void AttributeViewModel::setPaused(bool paused) {
+        m_paused = paused;
+        if (m_monitored_items != nullptr) {
+            m_monitored_items->setPaused(paused);
         }
+    }
 
+    void AttributeViewModel::attributesLoaded() {
+        beginResetModel();
+        updateAvailableAttributes();
         endResetModel();
+
+        // the node class is read before the attributes depending on it
+        if (!m_node->areAttributesLoaded()) {
+            return;
+        }
+        disconnect(m_node, &Node::attributesLoaded, this, nullptr);
+        subscribeAttributes();
+    }
+
+    void AttributeViewModel::updateAvailableAttributes() {
+        // Only cached attributes are shown, so data never has to wait for the server.
+        m_available_attributes.clear();
+        std::ranges::copy_if(c_attributes, std::back_inserter(m_available_attributes),
+                             [this](AttributeId attribute) { return m_node->isCached(attribute); });
+    }
+
+    void AttributeViewModel::subscribeAttributes() {
+        std::vector<SubscriptionManager::MonitoredAttribute> attributes;
+        attributes.reserve(m_available_attributes.size());
+        for (const auto attribute_id : m_available_attributes) {
+            attributes.emplace_back(m_node, attribute_id);
+        }
+        m_monitored_items = new MonitoredItemSet(m_connection->getSubscriptionManager(), c_publishing_interval, this);
+        connect(m_monitored_items, &MonitoredItemSet::valueChanged, this, &AttributeViewModel::valueChanged);
+        m_monitored_items->setPaused(m_paused);
+        m_monitored_items->monitor(attributes);
+
+        if (m_node->isCached(AttributeId::DATA_TYPE)) {
+            loadDataTypeName();
+        }
+    }
+
+    void AttributeViewModel::loadDataTypeName() {
+        const auto data_type = m_node->getDataType();
+        if (!data_type.has_value()) {
+            return;
+        }
+
+        const std::array attributes{std::pair{*data_type, AttributeId::DISPLAY_NAME}};
+        m_connection->readAttributesAsync(
+            attributes, [model = QPointer{this}, node = m_node](const std::vector<DataValue>& values) {
+                if (model.isNull() || model->m_node != node || values.front().getStatusCode().handle().isBad()) {
+                    return;
+                }
+                if (const auto display_name = values.front().getValue().getScalar<LocalizedText>();
+                    display_name.has_value()) {
+                    model->m_data_type_name = display_name->getText();
+                    model->valueChanged(node, AttributeId::DATA_TYPE);
+                }
+            });
     }
 
     QModelIndex AttributeViewModel::index(int row, int column, const QModelIndex& parent) const {
@@ -449,7 +513,7 @@ namespace magnesia::activities::dataviewer::panels::attribute_view_panel {
             case AttributeId::VALUE:
                 return value_data(title, m_node->getDataValue(), "Value");
             case AttributeId::DATA_TYPE:
-                return data_type_data(title, m_node->getDataType(), m_connection, "Data Type");
+                return data_type_data(title, m_node->getDataType(), m_data_type_name, "Data Type");
             case AttributeId::VALUE_RANK:
                 return value_rank_data(title, m_node->getValueRank(), "Value Rank");
             case AttributeId::ARRAY_DIMENSIONS:
@@ -1,14 +1,17 @@
 #pragma once
 
 #include "../../../opcua_qt/Connection.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
 #include "../../../opcua_qt/abstraction/AttributeId.hpp"
 #include "../../../opcua_qt/abstraction/node/Node.hpp"
 
+#include <optional>
 #include <vector>
 
 #include <QAbstractItemModel>
 #include <QModelIndex>
 #include <QObject>
+#include <QString>
 #include <QVariant>
 #include <Qt>
 #include <qtmetamacros.h>
@@ -43,13 +46,30 @@ namespace magnesia::activities::dataviewer::panels::attribute_view_panel {
          */
         void setNode(opcua_qt::abstraction::Node* node, opcua_qt::Connection* connection);
 
+        /**
+         * Pauses or resumes value updates, e.g. while the view is hidden. The latest values are reported right after
+         * resuming.
+         *
+         * @param paused Whether to pause updates.
+         */
+        void setPaused(bool paused);
+
       private slots:
         void valueChanged(opcua_qt::abstraction::Node* node, opcua_qt::abstraction::AttributeId attribute_id);
+        void attributesLoaded();
+
+      private:
+        void updateAvailableAttributes();
+        void subscribeAttributes();
+        void loadDataTypeName();
 
       private:
         std::vector<opcua_qt::abstraction::AttributeId> m_available_attributes;
         opcua_qt::abstraction::Node*                    m_node{nullptr};
         opcua_qt::Connection*                           m_connection{nullptr};
-        opcua_qt::abstraction::Subscription*            m_subscription{nullptr};
+        opcua_qt::MonitoredItemSet*                     m_monitored_items{nullptr};
+        bool                                            m_paused{false};
+        // display name of the node's data type, read in the background
+        std::optional<QString>                          m_data_type_name;
     };
 } // namespace magnesia::activities::dataviewer::panels::attribute_view_panel
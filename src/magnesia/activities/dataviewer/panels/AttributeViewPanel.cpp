@@ -35,6 +35,10 @@ namespace magnesia::activities::dataviewer::panels::attribute_view_panel {
         setLayout(layout);
     }
 
+    void AttributeViewPanel::onVisibilityChanged(bool visible) {
+        m_model->setPaused(!visible);
+    }
+
     void AttributeViewPanel::selectNode(const NodeId& node_id) {
         auto* connection = getDataViewer()->getConnection();
         if (auto node = connection->getNode(node_id); node.has_value()) {
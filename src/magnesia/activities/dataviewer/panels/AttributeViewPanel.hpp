@@ -24,6 +24,9 @@ namespace magnesia::activities::dataviewer::panels::attribute_view_panel {
          */
         explicit AttributeViewPanel(DataViewer* dataviewer, QWidget* parent = nullptr);
 
+      protected:
+        void onVisibilityChanged(bool visible) override;
+
       private slots:
         void selectNode(const opcua_qt::abstraction::NodeId& node_id) override;
 
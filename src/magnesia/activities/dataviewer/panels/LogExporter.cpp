@@ -0,0 +1,197 @@
+#include "LogExporter.hpp"
+
+#include "../../../opcua_qt/LogEntry.hpp"
+#include "../../../opcua_qt/Logger.hpp"
+#include "../../../opcua_qt/abstraction/LogCategory.hpp"
+#include "../../../opcua_qt/abstraction/LogLevel.hpp"
+#include "../../../qt_version_check.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMetaObject>
+#include <QObject>
+#include <QSaveFile>
+#include <QString>
+#include <Qt>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtTypes>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_log_exporter, "magnesia.dataviewer.log_exporter")
+
+    // entries copied from the Logger at once
+    constexpr std::uint64_t c_chunk_size    = 16384;
+    // chunks copied but not yet written, bounds the memory used while the worker is busy
+    constexpr std::size_t   c_max_in_flight = 2;
+
+    void append_csv_field(QByteArray& out, const QString& field) {
+        if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+            QString escaped = field;
+            out += '"' + escaped.replace('\\', "\\\\").replace('"', "\\\"").toUtf8() + '"';
+        } else {
+            out += field.toUtf8();
+        }
+    }
+
+    QString format_time(magnesia::opcua_qt::LogEntry::TimePoint time) {
+        const auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString(Qt::ISODateWithMs);
+    }
+} // namespace
+
+namespace magnesia::activities::dataviewer::panels::log_view_panel {
+    LogExporter::LogExporter(std::unique_ptr<QSaveFile> file, Format format, const opcua_qt::Logger* logger,
+                             std::uint64_t first_index, std::function<bool(const opcua_qt::LogEntry&)> filter,
+                             QObject* parent)
+        : QObject(parent), m_file(std::move(file)), m_format(format), m_logger(logger), m_filter(std::move(filter)),
+          m_first_index(first_index), m_next_index(first_index),
+          m_end_index(std::max(first_index, logger->getEndIndex())) {
+        m_pool.setMaxThreadCount(1);
+    }
+
+    LogExporter* LogExporter::start(const QString& path, Format format, const opcua_qt::Logger* logger,
+                                    std::uint64_t first_index, std::function<bool(const opcua_qt::LogEntry&)> filter,
+                                    QObject* parent) {
+        auto file = std::make_unique<QSaveFile>(path);
+        if (!file->open(QIODevice::WriteOnly)) {
+            qCWarning(lc_log_exporter) << "Failed to open" << path << file->errorString();
+            return nullptr;
+        }
+        if (format == Format::CSV) {
+            file->write("Time,Level,Category,Count,Message\n");
+        }
+
+        auto* exporter = new LogExporter{std::move(file), format, logger, first_index, std::move(filter), parent};
+        // start once the caller had the chance to connect to the signals
+        QMetaObject::invokeMethod(exporter, &LogExporter::produceChunks, Qt::QueuedConnection);
+        return exporter;
+    }
+
+    LogExporter::~LogExporter() {
+        m_cancelled = true;
+        m_pool.waitForDone();
+    }
+
+    void LogExporter::cancel() {
+        m_cancelled = true;
+    }
+
+    std::uint64_t LogExporter::getTotal() const noexcept {
+        return m_end_index - m_first_index;
+    }
+
+    QString LogExporter::getErrorString() const {
+        return m_file->errorString();
+    }
+
+    QByteArray LogExporter::formatEntries(std::span<const opcua_qt::LogEntry> entries, Format format) {
+        QByteArray out;
+        for (const auto& entry : entries) {
+            switch (format) {
+                case Format::CSV:
+                    append_csv_field(out, format_time(entry.getTime()));
+                    out += ',';
+                    append_csv_field(out, opcua_qt::log_level_to_string(entry.getLevel()));
+                    out += ',';
+                    append_csv_field(out, opcua_qt::log_category_to_string(entry.getCategory()));
+                    out += ',';
+                    out += QByteArray::number(entry.getRepeatCount());
+                    out += ',';
+                    append_csv_field(out, entry.getMessage());
+                    break;
+                case Format::NDJSON:
+                    out += QJsonDocument{QJsonObject{
+                                             {"time", format_time(entry.getTime())},
+                                             {"last_time", format_time(entry.getLastTime())},
+                                             {"count", static_cast<qint64>(entry.getRepeatCount())},
+                                             {"level", opcua_qt::log_level_to_string(entry.getLevel())},
+                                             {"category", opcua_qt::log_category_to_string(entry.getCategory())},
+                                             {"message", entry.getMessage()},
+                                         }}
+                               .toJson(QJsonDocument::Compact);
+                    break;
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    void LogExporter::produceChunks() {
+        if (m_cancelled || m_failed) {
+            finish();
+            return;
+        }
+
+        while (m_in_flight < c_max_in_flight && m_next_index < m_end_index) {
+            const auto chunk_end = std::min(m_next_index + c_chunk_size, m_end_index);
+
+            // The messages are implicitly shared, copying the entries is cheap and leaves the Logger to this thread.
+            std::vector<opcua_qt::LogEntry> chunk;
+            for (auto index = std::max(m_next_index, m_logger->getFirstIndex()); index < chunk_end; ++index) {
+                if (const auto& entry = m_logger->at(index); m_filter(entry)) {
+                    chunk.push_back(entry);
+                }
+            }
+            m_next_index = chunk_end;
+
+            ++m_in_flight;
+            m_pool.start([this, chunk = std::move(chunk), done = chunk_end - m_first_index] {
+                if (!m_cancelled && !m_failed) {
+                    const auto data = formatEntries(chunk, m_format);
+                    if (m_file->write(data) != data.size()) {
+                        m_failed = true;
+                    }
+                }
+                QMetaObject::invokeMethod(this, [this, done] { onChunkWritten(done); }, Qt::QueuedConnection);
+            });
+        }
+
+        if (m_in_flight == 0) {
+            finish();
+        }
+    }
+
+    void LogExporter::onChunkWritten(std::uint64_t done) {
+        --m_in_flight;
+        Q_EMIT progressChanged(done);
+        produceChunks();
+    }
+
+    void LogExporter::finish() {
+        if (m_finished || m_in_flight > 0) {
+            return;
+        }
+        m_finished = true;
+
+        // Without a commit the temporary file is discarded and the target file left untouched.
+        if (m_cancelled) {
+            Q_EMIT finished(false);
+            return;
+        }
+        if (m_failed || !m_file->commit()) {
+            qCWarning(lc_log_exporter) << "Failed to write" << m_file->fileName() << m_file->errorString();
+            Q_EMIT finished(false);
+            return;
+        }
+        Q_EMIT finished(true);
+    }
+} // namespace magnesia::activities::dataviewer::panels::log_view_panel
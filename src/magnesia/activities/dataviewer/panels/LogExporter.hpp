@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../../../opcua_qt/LogEntry.hpp"
+#include "../../../opcua_qt/Logger.hpp"
+#include "../../../qt_version_check.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+
+#include <QByteArray>
+#include <QObject>
+#include <QSaveFile>
+#include <QString>
+#include <QThreadPool>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::activities::dataviewer::panels::log_view_panel {
+    /**
+     * @class LogExporter
+     * @brief Writes log entries to a file in the background.
+     *
+     * The entries are copied from the Logger a chunk at a time and formatted and written by a worker thread, so neither
+     * the whole log nor the whole file content is ever held in memory. Entries dropped by the Logger before they were
+     * copied are skipped. The file is only replaced once the export succeeded.
+     */
+    class LogExporter : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(LogExporter)
+
+      public:
+        /**
+         * @brief File formats.
+         */
+        enum class Format : std::uint8_t {
+            /// Comma separated time, level, category, repeat count and message.
+            CSV,
+            /// One JSON object per line.
+            NDJSON,
+        };
+
+        /**
+         * @brief Starts an export.
+         *
+         * @param path the file to write
+         * @param format the file format
+         * @param logger the logger to read from, must outlive the export
+         * @param first_index index of the first entry to export. Entries up to the current end of the log are
+         *                    exported.
+         * @param filter selects the exported entries, called in this thread
+         * @param parent the QObject parent
+         *
+         * @return the export or nullptr if the file can't be opened
+         */
+        [[nodiscard]] static LogExporter* start(const QString& path, Format format, const opcua_qt::Logger* logger,
+                                                std::uint64_t                                  first_index,
+                                                std::function<bool(const opcua_qt::LogEntry&)> filter,
+                                                QObject*                                       parent = nullptr);
+
+        ~LogExporter() override;
+
+        /**
+         * @brief Cancels the export. The file is left untouched. finished is emitted once the worker stopped.
+         */
+        void cancel();
+
+        /**
+         * @brief Gets the number of entries to look at, including the ones not matching the filter.
+         */
+        [[nodiscard]] std::uint64_t getTotal() const noexcept;
+
+        /**
+         * @brief Gets the reason the export failed.
+         */
+        [[nodiscard]] QString getErrorString() const;
+
+        /**
+         * @brief Formats log entries.
+         *
+         * @param entries the entries
+         * @param format the file format
+         *
+         * @return the formatted entries, each ending with a newline
+         */
+        [[nodiscard]] static QByteArray formatEntries(std::span<const opcua_qt::LogEntry> entries, Format format);
+
+      signals:
+        /**
+         * Emitted whenever a chunk has been written.
+         *
+         * @param done number of entries looked at, between 0 and getTotal
+         */
+        void progressChanged(std::uint64_t done);
+
+        /**
+         * Emitted once the export is complete, failed or was cancelled.
+         *
+         * @param success true if the file has been written
+         */
+        void finished(bool success);
+
+      private:
+        LogExporter(std::unique_ptr<QSaveFile> file, Format format, const opcua_qt::Logger* logger,
+                    std::uint64_t first_index, std::function<bool(const opcua_qt::LogEntry&)> filter,
+                    QObject* parent);
+
+        // hands chunks to the worker while few enough are in flight
+        void produceChunks();
+        void onChunkWritten(std::uint64_t done);
+        void finish();
+
+      private:
+        std::unique_ptr<QSaveFile>                     m_file;
+        Format                                         m_format;
+        const opcua_qt::Logger*                        m_logger;
+        std::function<bool(const opcua_qt::LogEntry&)> m_filter;
+        std::uint64_t                                  m_first_index;
+        std::uint64_t                                  m_next_index;
+        std::uint64_t                                  m_end_index;
+        std::size_t                                    m_in_flight{0};
+        bool                                           m_finished{false};
+
+        // single thread, so chunks are written in order
+        QThreadPool      m_pool;
+        std::atomic_bool m_cancelled{false};
+        std::atomic_bool m_failed{false};
+    };
+} // namespace magnesia::activities::dataviewer::panels::log_view_panel
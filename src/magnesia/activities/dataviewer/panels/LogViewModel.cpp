@@ -1,15 +1,34 @@
 #include "LogViewModel.hpp"
 
+#include "../../../opcua_qt/LogArchive.hpp"
+#include "../../../opcua_qt/LogEntry.hpp"
 #include "../../../opcua_qt/Logger.hpp"
 #include "../../../opcua_qt/abstraction/LogCategory.hpp"
 #include "../../../opcua_qt/abstraction/LogLevel.hpp"
 #include "../../../qt_version_check.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
+#include <QAbstractProxyModel>
 #include <QAbstractTableModel>
+#include <QDateTime>
+#include <QMetaObject>
 #include <QModelIndex>
 #include <QObject>
+#include <QRegularExpression>
+#include <QString>
 #include <QVariant>
 #include <Qt>
 
@@ -19,21 +38,71 @@
 #include <QtGlobal>
 #endif
 
+namespace {
+    // messages searched before the matches are handed to the model
+    constexpr std::size_t c_search_chunk_size = 4096;
+
+    struct SearchCandidate {
+        std::uint64_t index;
+        QString       message;
+    };
+
+    bool message_matches(const QString& message, const QString& text,
+                         const std::optional<QRegularExpression>& expression) {
+        if (expression.has_value()) {
+            return expression->match(message).hasMatch();
+        }
+        return message.contains(text, Qt::CaseInsensitive);
+    }
+
+    QDateTime to_date_time(magnesia::opcua_qt::LogEntry::TimePoint time) {
+        const auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+        return QDateTime::fromMSecsSinceEpoch(msecs);
+    }
+
+    // time of day for the entries kept in memory, archives span days
+    constexpr auto c_time_format      = "hh:mm:ss.zzz";
+    constexpr auto c_date_time_format = "yyyy-MM-dd hh:mm:ss.zzz";
+
+    void trim_front(std::deque<std::uint64_t>& indexes, std::uint64_t first_index) {
+        while (!indexes.empty() && indexes.front() < first_index) {
+            indexes.pop_front();
+        }
+    }
+} // namespace
+
 namespace magnesia::activities::dataviewer::panels::log_view_panel {
     LogViewModel::LogViewModel(opcua_qt::Logger* logger, QObject* parent)
         : QAbstractTableModel(parent), m_logger(logger) {
         Q_ASSERT(m_logger != nullptr);
 
-        connect(logger, &opcua_qt::Logger::logEntryAdded, this, [this](std::size_t index) {
-            auto row = static_cast<int>(index);
-            // TODO: How broken is this? This adds the entry before calling beginInsertRows.
-            beginInsertRows({}, row, row);
-            endInsertRows();
+        // Rows are the kept entries, starting with the oldest. Dropping entries removes rows from the top.
+        connect(logger, &opcua_qt::Logger::logEntriesAboutToBeAdded, this,
+                [this](std::uint64_t first_index, std::size_t count) {
+                    auto row = static_cast<int>(first_index - m_logger->getFirstIndex());
+                    beginInsertRows({}, row, row + static_cast<int>(count) - 1);
+                });
+        connect(logger, &opcua_qt::Logger::logEntriesAdded, this, [this] { endInsertRows(); });
+        connect(logger, &opcua_qt::Logger::logEntriesAboutToBeDropped, this,
+                [this](std::size_t count) { beginRemoveRows({}, 0, static_cast<int>(count) - 1); });
+        connect(logger, &opcua_qt::Logger::logEntriesDropped, this, [this] { endRemoveRows(); });
+        connect(logger, &opcua_qt::Logger::logEntryRepeated, this, [this](std::uint64_t log_index) {
+            const auto row = static_cast<int>(log_index - m_logger->getFirstIndex());
+            Q_EMIT dataChanged(index(row, TimeColumn), index(row, CountColumn));
         });
     }
 
+    LogViewModel::LogViewModel(std::unique_ptr<opcua_qt::LogArchive> archive, QObject* parent)
+        : QAbstractTableModel(parent), m_archive(std::move(archive)) {
+        Q_ASSERT(m_archive != nullptr);
+    }
+
     int LogViewModel::rowCount(const QModelIndex& /*parent*/) const {
-        return static_cast<int>(m_logger->getEntries().size());
+        if (m_archive != nullptr) {
+            // views can't show more rows
+            return static_cast<int>(std::min<std::uint64_t>(m_archive->size(), std::numeric_limits<int>::max()));
+        }
+        return static_cast<int>(m_logger->size());
     }
 
     int LogViewModel::columnCount(const QModelIndex& /*parent*/) const {
@@ -45,30 +114,56 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
             return {};
         }
 
-        auto        row   = static_cast<std::size_t>(index.row());
-        const auto& entry = m_logger->getEntries()[row];
+        const auto entry = getEntry(index.row());
+        if (!entry.has_value()) {
+            return {};
+        }
 
         if (role == Qt::DisplayRole) {
             switch (index.column()) {
+                case TimeColumn: {
+                    const auto* format = m_archive != nullptr ? c_date_time_format : c_time_format;
+                    if (entry->getRepeatCount() > 1) {
+                        return to_date_time(entry->getTime()).toString(format) + " - "
+                             + to_date_time(entry->getLastTime()).toString(format);
+                    }
+                    return to_date_time(entry->getTime()).toString(format);
+                }
+                case CountColumn:
+                    if (entry->getRepeatCount() > 1) {
+                        return QString::number(entry->getRepeatCount());
+                    }
+                    return {};
                 case LevelColumn:
-                    return opcua_qt::log_level_to_string(entry.getLevel());
+                    return opcua_qt::log_level_to_string(entry->getLevel());
                 case CategoryColumn:
-                    return opcua_qt::log_category_to_string(entry.getCategory());
+                    return opcua_qt::log_category_to_string(entry->getCategory());
                 case MessageColumn:
-                    return entry.getMessage();
+                    return entry->getMessage();
                 default:
                     Q_ASSERT(false);
             }
         }
 
+        if (role == Qt::ToolTipRole && entry->getRepeatCount() > 1) {
+            return QString{"Repeated %1 times between %2 and %3"}
+                .arg(entry->getRepeatCount())
+                .arg(to_date_time(entry->getTime()).toString(c_date_time_format),
+                     to_date_time(entry->getLastTime()).toString(c_date_time_format));
+        }
+
         if (role == Qt::UserRole) {
             switch (index.column()) {
+                case TimeColumn:
+                    return to_date_time(entry->getTime());
+                case CountColumn:
+                    return QVariant::fromValue(entry->getRepeatCount());
                 case LevelColumn:
-                    return QVariant::fromValue(entry.getLevel());
+                    return QVariant::fromValue(entry->getLevel());
                 case CategoryColumn:
-                    return QVariant::fromValue(entry.getCategory());
+                    return QVariant::fromValue(entry->getCategory());
                 case MessageColumn:
-                    return entry.getMessage();
+                    return entry->getMessage();
                 default:
                     Q_ASSERT(false);
             }
@@ -87,10 +182,14 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
         }
 
         switch (section) {
+            case TimeColumn:
+                return "Time";
             case LevelColumn:
                 return "Level";
             case CategoryColumn:
                 return "Category";
+            case CountColumn:
+                return "Count";
             case MessageColumn:
                 return "Message";
             default:
@@ -100,22 +199,307 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
         return {};
     }
 
-    bool LogFilterModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const {
-        if (source_row < m_min_row) {
-            return false;
+    std::uint64_t LogViewModel::getLogIndex(int row) const noexcept {
+        if (m_archive != nullptr) {
+            return static_cast<std::uint64_t>(row);
+        }
+        return m_logger->getFirstIndex() + static_cast<std::uint64_t>(row);
+    }
+
+    std::optional<opcua_qt::LogEntry> LogViewModel::getEntry(int row) const {
+        if (m_archive != nullptr) {
+            return m_archive->at(getLogIndex(row));
         }
-        auto index = sourceModel()->index(source_row, LogViewModel::LevelColumn, source_parent);
-        auto level = sourceModel()->data(index, Qt::UserRole).value<opcua_qt::LogLevel>();
-        return level >= m_min_level;
+        return m_logger->at(getLogIndex(row));
+    }
+
+    LogFilterModel::LogFilterModel(LogViewModel* source, QObject* parent)
+        : QAbstractProxyModel(parent), m_logger(source->m_logger),
+          m_candidates(&m_logger->getIndexesWithMinLevel(m_min_level)) {
+        // only entries kept in memory are indexed
+        Q_ASSERT(source->m_archive == nullptr);
+
+        m_search_pool.setMaxThreadCount(1);
+        setSourceModel(source);
+        updateRange();
+
+        connect(m_logger, &opcua_qt::Logger::logEntriesAdded, this, &LogFilterModel::onEntriesAdded);
+        connect(m_logger, &opcua_qt::Logger::logEntriesAboutToBeDropped, this,
+                &LogFilterModel::onEntriesAboutToBeDropped);
+        connect(m_logger, &opcua_qt::Logger::logEntriesDropped, this, &LogFilterModel::onEntriesDropped);
+        connect(m_logger, &opcua_qt::Logger::logEntryRepeated, this, &LogFilterModel::onEntryRepeated);
+    }
+
+    LogFilterModel::~LogFilterModel() {
+        // the search posts its matches to this model
+        cancelSearch();
+        m_search_pool.waitForDone();
+    }
+
+    QModelIndex LogFilterModel::index(int row, int column, const QModelIndex& parent) const {
+        if (!hasIndex(row, column, parent)) {
+            return {};
+        }
+        return createIndex(row, column);
+    }
+
+    QModelIndex LogFilterModel::parent(const QModelIndex& /*child*/) const {
+        return {};
+    }
+
+    int LogFilterModel::rowCount(const QModelIndex& parent) const {
+        if (parent.isValid()) {
+            return 0;
+        }
+        return static_cast<int>(m_row_count);
+    }
+
+    int LogFilterModel::columnCount(const QModelIndex& parent) const {
+        if (parent.isValid()) {
+            return 0;
+        }
+        return LogViewModel::COLUMN_COUNT;
+    }
+
+    QVariant LogFilterModel::headerData(int section, Qt::Orientation orientation, int role) const {
+        if (orientation == Qt::Horizontal) {
+            return sourceModel()->headerData(section, orientation, role);
+        }
+        return QAbstractProxyModel::headerData(section, orientation, role);
+    }
+
+    QModelIndex LogFilterModel::mapToSource(const QModelIndex& proxy_index) const {
+        if (!proxy_index.isValid()) {
+            return {};
+        }
+        const auto log_index = getLogIndex(proxy_index.row());
+        return sourceModel()->index(static_cast<int>(log_index - m_logger->getFirstIndex()), proxy_index.column());
+    }
+
+    QModelIndex LogFilterModel::mapFromSource(const QModelIndex& source_index) const {
+        if (!source_index.isValid()) {
+            return {};
+        }
+        const auto log_index = static_cast<const LogViewModel*>(sourceModel())->getLogIndex(source_index.row());
+        const auto first     = std::next(m_candidates->begin(), static_cast<std::ptrdiff_t>(m_skip));
+        const auto last      = std::next(first, static_cast<std::ptrdiff_t>(m_row_count));
+        const auto found     = std::lower_bound(first, last, log_index);
+        if (found == last || *found != log_index) {
+            return {};
+        }
+        return index(static_cast<int>(std::distance(first, found)), source_index.column());
+    }
+
+    std::uint64_t LogFilterModel::getLogIndex(int row) const noexcept {
+        return (*m_candidates)[m_skip + static_cast<std::size_t>(row)];
     }
 
     void LogFilterModel::setMinLevel(opcua_qt::LogLevel min_level) {
         m_min_level = min_level;
-        invalidateFilter();
+        rebuild();
+    }
+
+    void LogFilterModel::setCategory(std::optional<opcua_qt::LogCategory> category) {
+        m_category = category;
+        rebuild();
+    }
+
+    void LogFilterModel::setMinimumIndex(std::uint64_t index) {
+        beginResetModel();
+        m_min_index = index;
+        updateRange();
+        endResetModel();
+    }
+
+    void LogFilterModel::setSearch(const QString& text, bool regex) {
+        m_search_text = text;
+        m_search_expression.reset();
+        if (regex && !text.isEmpty()) {
+            m_search_expression.emplace(text, QRegularExpression::CaseInsensitiveOption);
+        }
+        rebuild();
+    }
+
+    std::uint64_t LogFilterModel::getMinimumIndex() const noexcept {
+        return m_min_index;
+    }
+
+    std::function<bool(const opcua_qt::LogEntry&)> LogFilterModel::getEntryFilter() const {
+        return [min_level = m_min_level, category = m_category, text = m_search_text,
+                expression = m_search_expression](const opcua_qt::LogEntry& entry) {
+            return entry.getLevel() >= min_level && (!category.has_value() || entry.getCategory() == *category)
+                && message_matches(entry.getMessage(), text, expression);
+        };
+    }
+
+    void LogFilterModel::rebuild() {
+        beginResetModel();
+        cancelSearch();
+        m_filtered.clear();
+        m_search_pending.clear();
+
+        const auto& by_level = m_logger->getIndexesWithMinLevel(m_min_level);
+        if (m_search_text.isEmpty() && !m_category.has_value()) {
+            m_candidates = &by_level;
+        } else if (m_search_text.isEmpty() && m_min_level == opcua_qt::LogLevel::TRACE) {
+            m_candidates = &m_logger->getIndexesOfCategory(*m_category);
+        } else {
+            m_candidates = &m_filtered;
+
+            // the other filter is checked for each entry of the shorter index
+            const auto* base = &by_level;
+            if (m_category.has_value()) {
+                if (const auto& by_category = m_logger->getIndexesOfCategory(*m_category);
+                    by_category.size() < base->size()) {
+                    base = &by_category;
+                }
+            }
+
+            const auto first = std::lower_bound(base->begin(), base->end(), m_min_index);
+            if (m_search_text.isEmpty()) {
+                std::copy_if(first, base->end(), std::back_inserter(m_filtered),
+                             [this](std::uint64_t index) { return acceptsEntry(m_logger->at(index)); });
+            } else {
+                startSearch(first, base->end());
+            }
+        }
+
+        updateRange();
+        endResetModel();
+    }
+
+    void LogFilterModel::updateRange() {
+        m_skip = static_cast<std::size_t>(std::distance(
+            m_candidates->begin(), std::lower_bound(m_candidates->begin(), m_candidates->end(), m_min_index)));
+        m_row_count = m_candidates->size() - m_skip;
+    }
+
+    void LogFilterModel::insertNewRows() {
+        const auto row_count = m_candidates->size() - m_skip;
+        if (row_count == m_row_count) {
+            return;
+        }
+        beginInsertRows({}, static_cast<int>(m_row_count), static_cast<int>(row_count) - 1);
+        m_row_count = row_count;
+        endInsertRows();
+    }
+
+    void LogFilterModel::startSearch(std::deque<std::uint64_t>::const_iterator first,
+                                     std::deque<std::uint64_t>::const_iterator last) {
+        // The messages are implicitly shared, copying them is cheap and leaves the Logger to this thread.
+        std::vector<SearchCandidate> candidates;
+        for (auto index = first; index != last; ++index) {
+            if (const auto& entry = m_logger->at(*index); acceptsEntry(entry)) {
+                candidates.push_back({.index = *index, .message = entry.getMessage()});
+            }
+        }
+
+        m_searching        = true;
+        m_search_cancelled = std::make_shared<std::atomic_bool>(false);
+        m_search_pool.start([this, candidates = std::move(candidates), cancelled = m_search_cancelled,
+                             generation = ++m_search_generation, text = m_search_text,
+                             expression = m_search_expression] {
+            std::vector<std::uint64_t> matches;
+            for (std::size_t offset = 0; offset < candidates.size(); offset += c_search_chunk_size) {
+                if (cancelled->load(std::memory_order_relaxed)) {
+                    return;
+                }
+                const auto chunk_end = std::min(offset + c_search_chunk_size, candidates.size());
+                for (auto candidate = offset; candidate < chunk_end; ++candidate) {
+                    if (message_matches(candidates[candidate].message, text, expression)) {
+                        matches.push_back(candidates[candidate].index);
+                    }
+                }
+                const bool done = chunk_end == candidates.size();
+                if (!matches.empty() || done) {
+                    QMetaObject::invokeMethod(
+                        this,
+                        [this, generation, matches = std::move(matches), done] {
+                            addSearchMatches(generation, matches, done);
+                        },
+                        Qt::QueuedConnection);
+                    matches.clear();
+                }
+            }
+            if (candidates.empty()) {
+                QMetaObject::invokeMethod(
+                    this, [this, generation] { addSearchMatches(generation, {}, true); }, Qt::QueuedConnection);
+            }
+        });
+    }
+
+    void LogFilterModel::cancelSearch() {
+        if (m_search_cancelled != nullptr) {
+            m_search_cancelled->store(true, std::memory_order_relaxed);
+            m_search_cancelled.reset();
+        }
+        m_searching = false;
+    }
+
+    void LogFilterModel::addSearchMatches(std::uint64_t generation, const std::vector<std::uint64_t>& matches,
+                                          bool done) {
+        if (generation != m_search_generation || !m_searching) {
+            return;
+        }
+
+        // entries dropped or cleared while searching aren't shown anymore
+        const auto first_index = std::max(m_logger->getFirstIndex(), m_min_index);
+        std::copy_if(matches.begin(), matches.end(), std::back_inserter(m_filtered),
+                     [first_index](std::uint64_t index) { return index >= first_index; });
+        if (done) {
+            m_filtered.insert(m_filtered.end(), m_search_pending.begin(), m_search_pending.end());
+            m_search_pending.clear();
+            m_searching = false;
+            m_search_cancelled.reset();
+        }
+        insertNewRows();
+    }
+
+    void LogFilterModel::onEntriesAdded(std::uint64_t first_index, std::size_t count) {
+        if (m_candidates == &m_filtered) {
+            auto& target = m_searching ? m_search_pending : m_filtered;
+            for (auto index = first_index; index < first_index + count; ++index) {
+                const auto& entry = m_logger->at(index);
+                if (acceptsEntry(entry) && message_matches(entry.getMessage(), m_search_text, m_search_expression)) {
+                    target.push_back(index);
+                }
+            }
+        }
+        insertNewRows();
+    }
+
+    void LogFilterModel::onEntriesAboutToBeDropped(std::size_t count) {
+        const auto end   = m_logger->getFirstIndex() + count;
+        const auto first = std::next(m_candidates->begin(), static_cast<std::ptrdiff_t>(m_skip));
+        const auto last  = std::next(first, static_cast<std::ptrdiff_t>(m_row_count));
+        m_dropped_rows   = static_cast<std::size_t>(std::distance(first, std::lower_bound(first, last, end)));
+        if (m_dropped_rows > 0) {
+            beginRemoveRows({}, 0, static_cast<int>(m_dropped_rows) - 1);
+        }
+    }
+
+    void LogFilterModel::onEntriesDropped() {
+        // the indexes of the Logger are already up to date
+        trim_front(m_filtered, m_logger->getFirstIndex());
+        trim_front(m_search_pending, m_logger->getFirstIndex());
+        updateRange();
+        if (m_dropped_rows > 0) {
+            endRemoveRows();
+        }
+    }
+
+    void LogFilterModel::onEntryRepeated(std::uint64_t index) {
+        const auto first = std::next(m_candidates->begin(), static_cast<std::ptrdiff_t>(m_skip));
+        const auto last  = std::next(first, static_cast<std::ptrdiff_t>(m_row_count));
+        const auto found = std::lower_bound(first, last, index);
+        if (found == last || *found != index) {
+            return;
+        }
+        const auto row = static_cast<int>(std::distance(first, found));
+        Q_EMIT dataChanged(this->index(row, LogViewModel::TimeColumn), this->index(row, LogViewModel::CountColumn));
     }
 
-    void LogFilterModel::setMinimumRow(int row) {
-        m_min_row = row;
-        invalidateFilter();
+    bool LogFilterModel::acceptsEntry(const opcua_qt::LogEntry& entry) const {
+        return entry.getLevel() >= m_min_level && (!m_category.has_value() || entry.getCategory() == *m_category);
     }
 } // namespace magnesia::activities::dataviewer::panels::log_view_panel
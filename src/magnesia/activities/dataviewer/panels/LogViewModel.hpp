@@ -1,29 +1,60 @@
 #pragma once
 
+#include "../../../opcua_qt/LogArchive.hpp"
+#include "../../../opcua_qt/LogEntry.hpp"
 #include "../../../opcua_qt/Logger.hpp"
+#include "../../../opcua_qt/abstraction/LogCategory.hpp"
 #include "../../../opcua_qt/abstraction/LogLevel.hpp"
+#include "../../../qt_version_check.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QAbstractProxyModel>
 #include <QAbstractTableModel>
-#include <QComboBox>
 #include <QModelIndex>
 #include <QObject>
-#include <QSortFilterProxyModel>
-#include <QTableView>
+#include <QRegularExpression>
+#include <QString>
+#include <QThreadPool>
 #include <QVariant>
-#include <QWidget>
 #include <Qt>
 #include <qtmetamacros.h>
 
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
 namespace magnesia::activities::dataviewer::panels::log_view_panel {
     /**
      * @class LogViewModel
      * @brief Model for the LogViewPanel
+     *
+     * Shows either the entries kept by a Logger or a persisted LogArchive. Archives are read through their memory
+     * mapping as rows are shown, so they are never loaded as a whole.
+     *
+     * Repeated entries are shown as a single row with the number of repeats and the time of the first and last one.
      */
     class LogViewModel : public QAbstractTableModel {
         Q_OBJECT
 
       public:
         explicit LogViewModel(opcua_qt::Logger* logger, QObject* parent = nullptr);
+        /**
+         * Shows a persisted log. Only the entries present when the archive was opened are shown.
+         *
+         * @param archive the archive
+         * @param parent the QObject parent
+         */
+        explicit LogViewModel(std::unique_ptr<opcua_qt::LogArchive> archive, QObject* parent = nullptr);
 
         [[nodiscard]] int      rowCount(const QModelIndex& parent = QModelIndex()) const override;
         [[nodiscard]] int      columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -31,32 +62,73 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
         [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation,
                                           int role = Qt::DisplayRole) const override;
 
+        /**
+         * Gets the Logger index of the entry shown in a row. Unlike rows, indexes don't change when old entries are
+         * dropped. For archives this is the number of the entry in the archive.
+         *
+         * @param row the row
+         */
+        [[nodiscard]] std::uint64_t getLogIndex(int row) const noexcept;
+
+        /**
+         * Gets the entry shown in a row.
+         *
+         * @param row the row
+         *
+         * @return the entry or nullopt if it can't be read from the archive
+         */
+        [[nodiscard]] std::optional<opcua_qt::LogEntry> getEntry(int row) const;
+
       private:
         friend class LogFilterModel;
 
         enum {
+            TimeColumn,
             LevelColumn,
             CategoryColumn,
+            CountColumn,
             MessageColumn,
 
             COLUMN_COUNT,
         };
 
       private:
-        opcua_qt::Logger* m_logger;
+        // exactly one of them is set
+        opcua_qt::Logger*                     m_logger{};
+        std::unique_ptr<opcua_qt::LogArchive> m_archive;
     };
 
     /**
      * @class LogFilterModel
      * @brief Proxy model to enable the LogViewPanel to filter log entries
+     *
+     * Filtering by level or category alone uses the indexes kept by the Logger, so changing these filters doesn't
+     * depend on the size of the log. Other combinations scan the shorter index. Searching the messages runs on a worker
+     * thread, matches are added as they are found.
      */
-    class LogFilterModel : public QSortFilterProxyModel {
+    class LogFilterModel : public QAbstractProxyModel {
         Q_OBJECT
+        Q_DISABLE_COPY_MOVE(LogFilterModel)
 
       public:
-        using QSortFilterProxyModel::QSortFilterProxyModel;
+        explicit LogFilterModel(LogViewModel* source, QObject* parent = nullptr);
+        ~LogFilterModel() override;
 
-        [[nodiscard]] bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
+        [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+        [[nodiscard]] QModelIndex parent(const QModelIndex& child) const override;
+        [[nodiscard]] int         rowCount(const QModelIndex& parent = QModelIndex()) const override;
+        [[nodiscard]] int         columnCount(const QModelIndex& parent = QModelIndex()) const override;
+        [[nodiscard]] QVariant    headerData(int section, Qt::Orientation orientation,
+                                             int role = Qt::DisplayRole) const override;
+        [[nodiscard]] QModelIndex mapToSource(const QModelIndex& proxy_index) const override;
+        [[nodiscard]] QModelIndex mapFromSource(const QModelIndex& source_index) const override;
+
+        /**
+         * Gets the Logger index of the entry shown in a row.
+         *
+         * @param row the row
+         */
+        [[nodiscard]] std::uint64_t getLogIndex(int row) const noexcept;
 
         /**
          * Set minimum log level used to filter rows
@@ -65,14 +137,76 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
          */
         void setMinLevel(opcua_qt::LogLevel min_level);
         /**
-         * Set minimum log entry row. Used to clear a panel without clearing underlying data.
+         * Set the category used to filter rows
          *
-         * @param row the new minimum log entry row
+         * @param category the category or nullopt to show all categories
          */
-        void setMinimumRow(int row);
+        void setCategory(std::optional<opcua_qt::LogCategory> category);
+        /**
+         * Set minimum Logger index of shown entries. Used to clear a panel without clearing underlying data.
+         *
+         * @param index the new minimum Logger index
+         */
+        void setMinimumIndex(std::uint64_t index);
+        /**
+         * Set the text searched for in the messages, ignoring case. Cancels a running search.
+         *
+         * @param text the text or regular expression, an empty text shows all messages
+         * @param regex whether the text is a regular expression. An invalid expression matches nothing.
+         */
+        void setSearch(const QString& text, bool regex);
+
+        /**
+         * Gets the minimum Logger index of shown entries.
+         */
+        [[nodiscard]] std::uint64_t getMinimumIndex() const noexcept;
+        /**
+         * Gets the current level, category and search filter. Later changes to this model don't affect it.
+         *
+         * @return a function returning true for entries passing the filter
+         */
+        [[nodiscard]] std::function<bool(const opcua_qt::LogEntry&)> getEntryFilter() const;
 
       private:
-        opcua_qt::LogLevel m_min_level{};
-        int                m_min_row{};
+        // rebuilds the rows after a filter changed
+        void rebuild();
+        // sets the range of m_candidates shown
+        void updateRange();
+        void insertNewRows();
+        void startSearch(std::deque<std::uint64_t>::const_iterator first,
+                         std::deque<std::uint64_t>::const_iterator last);
+        void cancelSearch();
+        void addSearchMatches(std::uint64_t generation, const std::vector<std::uint64_t>& matches, bool done);
+
+        void onEntriesAdded(std::uint64_t first_index, std::size_t count);
+        void onEntriesAboutToBeDropped(std::size_t count);
+        void onEntriesDropped();
+        void onEntryRepeated(std::uint64_t index);
+
+        [[nodiscard]] bool acceptsEntry(const opcua_qt::LogEntry& entry) const;
+
+      private:
+        opcua_qt::Logger*                    m_logger;
+        opcua_qt::LogLevel                   m_min_level{};
+        std::optional<opcua_qt::LogCategory> m_category;
+        std::uint64_t                        m_min_index{};
+        QString                              m_search_text;
+        std::optional<QRegularExpression>    m_search_expression;
+
+        // Either an index of the Logger or m_filtered. The shown rows are a contiguous range of it.
+        const std::deque<std::uint64_t>* m_candidates;
+        std::deque<std::uint64_t>        m_filtered;
+        // candidates before the first shown row, i.e. below m_min_index
+        std::size_t                      m_skip{0};
+        std::size_t                      m_row_count{0};
+        std::size_t                      m_dropped_rows{0};
+
+        // single thread, so searches run one after another
+        QThreadPool                       m_search_pool;
+        std::shared_ptr<std::atomic_bool> m_search_cancelled;
+        std::uint64_t                     m_search_generation{0};
+        bool                              m_searching{false};
+        // matches of entries added while searching, added once the search is done to keep the rows sorted
+        std::deque<std::uint64_t>         m_search_pending;
     };
 } // namespace magnesia::activities::dataviewer::panels::log_view_panel
@@ -1,24 +1,48 @@
 #include "LogViewPanel.hpp"
 
+#include "../../../opcua_qt/LogArchive.hpp"
+#include "../../../opcua_qt/LogEntry.hpp"
+#include "../../../opcua_qt/Logger.hpp"
+#include "../../../opcua_qt/abstraction/LogCategory.hpp"
 #include "../../../opcua_qt/abstraction/LogLevel.hpp"
 #include "../../../qt_version_check.hpp"
 #include "../DataViewer.hpp"
 #include "../Panel.hpp"
 #include "../PanelMetadata.hpp"
 #include "../panels.hpp"
+#include "LogExporter.hpp"
 #include "LogViewModel.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
 #include <QAbstractItemView>
+#include <QAction>
+#include <QActionGroup>
+#include <QCheckBox>
 #include <QComboBox>
-#include <QFile>
+#include <QDateTime>
+#include <QDialog>
+#include <QDir>
 #include <QFileDialog>
 #include <QFrame>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QLineEdit>
+#include <QMenu>
 #include <QMessageBox>
+#include <QModelIndex>
+#include <QProgressDialog>
 #include <QPushButton>
-#include <QStringBuilder>
+#include <QString>
+#include <QStringList>
 #include <QTableView>
+#include <QToolButton>
 #include <QVBoxLayout>
 #include <QVariant>
 #include <QWidget>
@@ -27,14 +51,48 @@
 #ifdef MAGNESIA_HAS_QT_6_5
 #include <QtAssert>
 #include <QtTypeTraits>
+#include <QtTypes>
 #else
 #include <QtGlobal>
 #endif
 
+namespace {
+    // milliseconds before the progress of an export is shown
+    constexpr int c_export_progress_delay = 500;
+
+    QString format_time(magnesia::opcua_qt::LogEntry::TimePoint time) {
+        const auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString("yyyy-MM-dd hh:mm:ss.zzz");
+    }
+
+    constexpr std::array c_levels{
+        magnesia::opcua_qt::LogLevel::TRACE,
+        magnesia::opcua_qt::LogLevel::DEBUG,
+        magnesia::opcua_qt::LogLevel::INFO,
+        magnesia::opcua_qt::LogLevel::WARNING,
+        magnesia::opcua_qt::LogLevel::ERROR,
+        magnesia::opcua_qt::LogLevel::FATAL,
+    };
+
+    constexpr std::array c_categories{
+        magnesia::opcua_qt::LogCategory::NETWORK,
+        magnesia::opcua_qt::LogCategory::SECURE_CHANNEL,
+        magnesia::opcua_qt::LogCategory::SESSION,
+        magnesia::opcua_qt::LogCategory::SERVER,
+        magnesia::opcua_qt::LogCategory::CLIENT,
+        magnesia::opcua_qt::LogCategory::USERLAND,
+        magnesia::opcua_qt::LogCategory::SECURITY_POLYCY,
+        magnesia::opcua_qt::LogCategory::PANEL,
+        magnesia::opcua_qt::LogCategory::ACTIVITY,
+        magnesia::opcua_qt::LogCategory::APPLICATION,
+    };
+} // namespace
+
 namespace magnesia::activities::dataviewer::panels::log_view_panel {
     LogViewPanel::LogViewPanel(DataViewer* dataviewer, QWidget* parent)
         : Panel(dataviewer, PanelType::logview, log_view_panel::metadata, parent), m_table(new QTableView),
-          m_level_selector(new QComboBox) {
+          m_level_selector(new QComboBox), m_category_selector(new QComboBox), m_search(new QLineEdit),
+          m_logger(dataviewer->getLogger()) {
         auto* layout = new QVBoxLayout;
         layout->setContentsMargins(0, 0, 0, 0);
 
@@ -49,13 +107,14 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
         m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
         m_table->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
-        auto* model = new LogViewModel(dataviewer->getLogger(), this);
+        auto* model = new LogViewModel(m_logger, this);
 
-        auto* filter_model = new LogFilterModel(this);
-        filter_model->setSourceModel(model);
+        auto* filter_model = new LogFilterModel(model, this);
+        m_filter_model     = filter_model;
         filter_model->setMinLevel(opcua_qt::LogLevel::DEBUG);
 
         m_table->setModel(filter_model);
+        connect(m_table, &QTableView::activated, this, &LogViewPanel::showRepeats);
 
         layout->addWidget(m_table);
 
@@ -63,9 +122,14 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
         connect(export_button, &QPushButton::clicked, this, &LogViewPanel::exportLog);
         tool_layout->addWidget(export_button);
 
+        auto* history_button = new QPushButton("History...");
+        history_button->setToolTip("Browse logs persisted to disk");
+        connect(history_button, &QPushButton::clicked, this, &LogViewPanel::openHistory);
+        tool_layout->addWidget(history_button);
+
         auto* clear_button = new QPushButton("Clear");
         connect(clear_button, &QPushButton::clicked, this,
-                [model, filter_model] { filter_model->setMinimumRow(model->rowCount()); });
+                [this, filter_model] { filter_model->setMinimumIndex(m_logger->getEndIndex()); });
         tool_layout->addWidget(clear_button);
 
         connect(m_level_selector, &QComboBox::currentIndexChanged, filter_model, [this, filter_model](int index) {
@@ -73,61 +137,175 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
             filter_model->setMinLevel(new_level);
         });
 
-        for (auto level : {
-                 opcua_qt::LogLevel::TRACE,
-                 opcua_qt::LogLevel::DEBUG,
-                 opcua_qt::LogLevel::INFO,
-                 opcua_qt::LogLevel::WARNING,
-                 opcua_qt::LogLevel::ERROR,
-                 opcua_qt::LogLevel::FATAL,
-             }) {
+        for (auto level : c_levels) {
             m_level_selector->addItem(opcua_qt::log_level_to_string(level), QVariant::fromValue(level));
         }
         // TODO: setCurrentText or setCurrentIndex?
         m_level_selector->setCurrentText(opcua_qt::log_level_to_string(opcua_qt::LogLevel::INFO));
         tool_layout->addWidget(m_level_selector);
 
+        m_category_selector->addItem("All Categories");
+        for (auto category : c_categories) {
+            m_category_selector->addItem(opcua_qt::log_category_to_string(category), QVariant::fromValue(category));
+        }
+        connect(m_category_selector, &QComboBox::currentIndexChanged, filter_model, [this, filter_model](int index) {
+            const auto data = m_category_selector->itemData(index);
+            filter_model->setCategory(data.isValid() ? std::optional{data.value<opcua_qt::LogCategory>()}
+                                                     : std::nullopt);
+        });
+        tool_layout->addWidget(m_category_selector);
+
+        m_search->setPlaceholderText("Search");
+        m_search->setClearButtonEnabled(true);
+        auto* regex_check_box = new QCheckBox("Regex");
+        auto  update_search   = [this, filter_model, regex_check_box] {
+            filter_model->setSearch(m_search->text(), regex_check_box->isChecked());
+        };
+        connect(m_search, &QLineEdit::textChanged, filter_model, update_search);
+        connect(regex_check_box, &QCheckBox::toggled, filter_model, update_search);
+        tool_layout->addWidget(m_search);
+        tool_layout->addWidget(regex_check_box);
+
+        tool_layout->addWidget(buildCaptureButton());
+
         setLayout(layout);
     }
 
+    QToolButton* LogViewPanel::buildCaptureButton() {
+        auto* button = new QToolButton;
+        button->setText("Capture");
+        button->setToolTip("Minimum levels logged per category, entries below them are discarded for all panels");
+        button->setPopupMode(QToolButton::InstantPopup);
+
+        auto* menu = new QMenu(button);
+        for (auto category : c_categories) {
+            auto* category_menu = menu->addMenu(opcua_qt::log_category_to_string(category));
+            category_menu->menuAction()->setData(QVariant::fromValue(category));
+            auto* group = new QActionGroup(category_menu);
+            for (auto level : c_levels) {
+                auto* action = category_menu->addAction(opcua_qt::log_level_to_string(level));
+                action->setCheckable(true);
+                action->setData(QVariant::fromValue(level));
+                group->addAction(action);
+                connect(action, &QAction::triggered, this,
+                        [this, category, level] { m_logger->setMinLevel(category, level); });
+            }
+        }
+        // other panels of the connection can change the levels as well
+        connect(menu, &QMenu::aboutToShow, this, [this, menu] {
+            for (auto* category_action : menu->actions()) {
+                const auto min_level = m_logger->getMinLevel(category_action->data().value<opcua_qt::LogCategory>());
+                for (auto* level_action : category_action->menu()->actions()) {
+                    level_action->setChecked(level_action->data().value<opcua_qt::LogLevel>() == min_level);
+                }
+            }
+        });
+        button->setMenu(menu);
+        return button;
+    }
+
     void LogViewPanel::exportLog() {
-        auto*     model   = m_table->model();
-        const int rows    = model->rowCount();
-        const int columns = model->columnCount();
+        const auto csv_filter    = QString{"CSV Files (*.csv)"};
+        const auto ndjson_filter = QString{"NDJSON Files (*.ndjson)"};
+        QString    selected_filter;
+        auto       url
+            = QFileDialog::getSaveFileUrl(this, "Save Log", {}, csv_filter + ";;" + ndjson_filter, &selected_filter);
+        if (url.isEmpty()) {
+            return;
+        }
+        const auto format = selected_filter == csv_filter ? LogExporter::Format::CSV : LogExporter::Format::NDJSON;
 
-        // cppcheck doesn't like Q_ASSERT(columns > 0) or assert(columns > 0)
-        if (columns < 1) {
-            Q_ASSERT(false);
+        auto* exporter = LogExporter::start(url.toLocalFile(), format, m_logger,
+                                            std::max(m_filter_model->getMinimumIndex(), m_logger->getFirstIndex()),
+                                            m_filter_model->getEntryFilter(), this);
+        if (exporter == nullptr) {
+            QMessageBox::critical(this, "Export failed", "Couldn't open file for writing", QMessageBox::Close);
             return;
         }
 
-        QString result;
+        // the total is at most the log capacity, which fits into an int
+        auto* progress = new QProgressDialog("Exporting log...", "Cancel", 0, static_cast<int>(exporter->getTotal()),
+                                             this);
+        progress->setWindowModality(Qt::WindowModal);
+        progress->setMinimumDuration(c_export_progress_delay);
+        connect(progress, &QProgressDialog::canceled, exporter, &LogExporter::cancel);
+        connect(exporter, &LogExporter::progressChanged, progress,
+                [progress](std::uint64_t done) { progress->setValue(static_cast<int>(done)); });
+        connect(exporter, &LogExporter::finished, this, [this, exporter, progress](bool success) {
+            if (!success && !progress->wasCanceled()) {
+                QMessageBox::critical(this, "Export failed", exporter->getErrorString(), QMessageBox::Close);
+            }
+            progress->deleteLater();
+            exporter->deleteLater();
+        });
+    }
 
-        for (int column = 0; column < columns; column++) {
-            result += model->headerData(column, Qt::Horizontal).toString() % ',';
+    void LogViewPanel::openHistory() {
+        const auto start     = m_logger->getPersistDirectory().value_or(opcua_qt::Logger::historyDirectory());
+        const auto directory = QFileDialog::getExistingDirectory(this, "Open Log History", start.absolutePath());
+        if (directory.isEmpty()) {
+            return;
         }
-        result[result.size() - 1] = '\n';
-        for (int row = 0; row < rows; row++) {
-            for (int column = 0; column < columns; column++) {
-                auto column_data = model->data(model->index(row, column)).toString();
-                if (column_data.contains(',')) {
-                    result += '"' % column_data.replace('\\', "\\\\").replace('"', "\\\"") % "\",";
-                } else {
-                    result += column_data % ',';
-                }
-            }
-            result[result.size() - 1] = '\n';
+        auto archive = opcua_qt::LogArchive::open(QDir{directory});
+        if (archive == nullptr) {
+            QMessageBox::warning(this, "Opening log failed", "No persisted log in " + directory, QMessageBox::Close);
+            return;
         }
 
-        auto url = QFileDialog::getSaveFileUrl(this, "Save Log", {}, "Log Files (*.csv)");
-        if (url.isEmpty()) {
+        auto* dialog = new QDialog(this);
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->setWindowTitle("Log History - " + directory);
+
+        auto* table = new QTableView;
+        table->setFrameShape(QFrame::Shape::NoFrame);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->setSelectionMode(QAbstractItemView::SingleSelection);
+        // Rows are read from disk as they are shown, resizing to the contents would read all of them.
+        table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->setModel(new LogViewModel(std::move(archive), dialog));
+        table->scrollToBottom();
+
+        auto* layout = new QVBoxLayout;
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addWidget(table);
+        dialog->setLayout(layout);
+        dialog->resize(size());
+        dialog->show();
+    }
+
+    void LogViewPanel::showRepeats(const QModelIndex& index) {
+        const auto log_index = m_filter_model->getLogIndex(index.row());
+        if (log_index < m_logger->getFirstIndex()) {
             return;
         }
-        QFile file{url.toLocalFile()};
-        if (!file.open(QFile::WriteOnly | QFile::Text)) {
-            QMessageBox::critical(this, "Export failed", "Couldn't open file for writing", QMessageBox::Close);
+        const auto& entry = m_logger->at(log_index);
+        if (entry.getRepeatCount() == 1) {
+            return;
+        }
+
+        const auto& repeat_times = entry.getRepeatTimes();
+        QStringList times;
+        // the first time only continues the list if no repeat in between was discarded
+        if (repeat_times.size() + 1 == entry.getRepeatCount()) {
+            times.append(format_time(entry.getTime()));
+        }
+        for (auto time : repeat_times) {
+            times.append(format_time(time));
+        }
+
+        QMessageBox message_box{QMessageBox::Information, "Repeated Message",
+                                QString{"Logged %1 times between %2 and %3.\n\n%4"}
+                                    .arg(entry.getRepeatCount())
+                                    .arg(format_time(entry.getTime()), format_time(entry.getLastTime()),
+                                         entry.getMessage()),
+                                QMessageBox::Close, this};
+        if (times.size() < static_cast<qsizetype>(entry.getRepeatCount())) {
+            message_box.setInformativeText(QString{"Only the last %1 times are kept."}.arg(times.size()));
         }
-        file.write(result.toUtf8());
+        message_box.setDetailedText(times.join('\n'));
+        message_box.exec();
     }
 
     QJsonObject LogViewPanel::saveState() const {
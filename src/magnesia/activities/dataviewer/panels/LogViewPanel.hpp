@@ -1,15 +1,18 @@
 #pragma once
 
+#include "../../../opcua_qt/Logger.hpp"
 #include "../Panel.hpp"
 #include "../PanelMetadata.hpp"
 #include "../dataviewer_fwd.hpp"
+#include "LogViewModel.hpp"
 
 #include <QAbstractTableModel>
 #include <QComboBox>
+#include <QLineEdit>
 #include <QModelIndex>
 #include <QObject>
-#include <QSortFilterProxyModel>
 #include <QTableView>
+#include <QToolButton>
 #include <QVariant>
 #include <QWidget>
 #include <Qt>
@@ -35,10 +38,22 @@ namespace magnesia::activities::dataviewer::panels::log_view_panel {
 
       private slots:
         void exportLog();
+        // browses a persisted log
+        void openHistory();
+        // shows the times of a repeated entry
+        void showRepeats(const QModelIndex& index);
+
+      private:
+        QToolButton* buildCaptureButton();
 
       private:
         QTableView* m_table{};
         QComboBox*  m_level_selector{};
+        QComboBox*  m_category_selector{};
+        QLineEdit*  m_search{};
+
+        opcua_qt::Logger* m_logger;
+        LogFilterModel*   m_filter_model{};
     };
 
     inline constexpr PanelMetadata metadata{
@@ -0,0 +1,123 @@
+#include "MonitoringParametersDialog.hpp"
+
+#include "../../../opcua_qt/abstraction/DeadbandType.hpp"
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
+#include "../../../qt_version_check.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QString>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtTypeTraits>
+#else
+#include <QtGlobal>
+#endif
+
+using magnesia::opcua_qt::abstraction::DeadbandType;
+using magnesia::opcua_qt::abstraction::MonitoringParameters;
+
+namespace {
+    // one hour, slower signals are better read on demand
+    constexpr double c_max_sampling_interval_ms = 3'600'000;
+    constexpr int    c_max_queue_size           = 100'000;
+    // a percent deadband is relative to the EURange of the variable
+    constexpr double c_max_deadband_percent     = 100;
+    constexpr int    c_decimals                 = 3;
+} // namespace
+
+namespace magnesia::activities::dataviewer::panels {
+    MonitoringParametersDialog::MonitoringParametersDialog(const MonitoringParameters& parameters, ApplyFunction apply,
+                                                           QWidget* parent)
+        : QDialog(parent), m_apply(std::move(apply)), m_sampling_interval(new QDoubleSpinBox),
+          m_queue_size(new QSpinBox), m_discard_oldest(new QCheckBox{"Discard oldest value when the queue is full"}),
+          m_deadband_type(new QComboBox), m_deadband_value(new QDoubleSpinBox), m_revised(new QLabel) {
+        setWindowTitle("Monitoring Parameters");
+
+        // 0 lets the server sample as fast as it can
+        m_sampling_interval->setRange(0, c_max_sampling_interval_ms);
+        m_sampling_interval->setDecimals(1);
+        m_sampling_interval->setSuffix(" ms");
+        m_sampling_interval->setSpecialValueText("Fastest");
+        m_queue_size->setRange(0, c_max_queue_size);
+
+        m_deadband_type->addItem("None", qToUnderlying(DeadbandType::NONE));
+        m_deadband_type->addItem("Absolute", qToUnderlying(DeadbandType::ABSOLUTE));
+        m_deadband_type->addItem("Percent of range", qToUnderlying(DeadbandType::PERCENT));
+        m_deadband_value->setRange(0, std::numeric_limits<double>::max());
+        m_deadband_value->setDecimals(c_decimals);
+        connect(m_deadband_type, &QComboBox::currentIndexChanged, m_deadband_value, [this] {
+            const auto type = static_cast<DeadbandType>(m_deadband_type->currentData().toUInt());
+            m_deadband_value->setEnabled(type != DeadbandType::NONE);
+            // clamps the value when switching to percent
+            m_deadband_value->setMaximum(type == DeadbandType::PERCENT ? c_max_deadband_percent
+                                                                       : std::numeric_limits<double>::max());
+            m_deadband_value->setSuffix(type == DeadbandType::PERCENT ? " %" : "");
+        });
+
+        auto* form = new QFormLayout;
+        form->addRow("Sampling interval:", m_sampling_interval);
+        form->addRow("Queue size:", m_queue_size);
+        form->addRow(m_discard_oldest);
+        form->addRow("Deadband:", m_deadband_type);
+        form->addRow("Deadband value:", m_deadband_value);
+        form->addRow("Revised by server:", m_revised);
+
+        auto* buttons = new QDialogButtonBox{QDialogButtonBox::Apply | QDialogButtonBox::Close};
+        connect(buttons->button(QDialogButtonBox::Apply), &QPushButton::clicked, this,
+                &MonitoringParametersDialog::onApply);
+        connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+        auto* layout = new QVBoxLayout;
+        layout->addLayout(form);
+        layout->addWidget(buttons);
+        setLayout(layout);
+
+        showParameters(parameters);
+    }
+
+    void MonitoringParametersDialog::onApply() {
+        const auto revised = m_apply(getRequestedParameters());
+        if (!revised.has_value()) {
+            m_revised->setText("Rejected by the server, see the log");
+            return;
+        }
+        showParameters(*revised);
+    }
+
+    void MonitoringParametersDialog::showParameters(const MonitoringParameters& parameters) {
+        m_sampling_interval->setValue(parameters.getSamplingInterval());
+        m_queue_size->setValue(static_cast<int>(parameters.getQueueSize()));
+        m_discard_oldest->setChecked(parameters.getDiscardOldest());
+        m_deadband_type->setCurrentIndex(m_deadband_type->findData(qToUnderlying(parameters.getDeadbandType())));
+        m_deadband_value->setValue(parameters.getDeadbandValue());
+        m_deadband_value->setEnabled(parameters.getDeadbandType() != DeadbandType::NONE);
+
+        m_revised->setText(QString{"sampling every %1 ms, queue size %2"}
+                               .arg(parameters.getSamplingInterval())
+                               .arg(parameters.getQueueSize()));
+    }
+
+    MonitoringParameters MonitoringParametersDialog::getRequestedParameters() const {
+        MonitoringParameters parameters;
+        parameters.setSamplingInterval(m_sampling_interval->value());
+        parameters.setQueueSize(static_cast<std::uint32_t>(m_queue_size->value()));
+        parameters.setDiscardOldest(m_discard_oldest->isChecked());
+        parameters.setDeadband(static_cast<DeadbandType>(m_deadband_type->currentData().toUInt()),
+                               m_deadband_value->value());
+        return parameters;
+    }
+} // namespace magnesia::activities::dataviewer::panels
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
+
+#include <functional>
+#include <optional>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QWidget>
+#include <qtmetamacros.h>
+
+namespace magnesia::activities::dataviewer::panels {
+    /**
+     * @class MonitoringParametersDialog
+     * @brief Dialog to change the sampling interval, queue size, discard policy and deadband of a monitored item.
+     *
+     * The values revised by the server are shown after applying.
+     */
+    class MonitoringParametersDialog : public QDialog {
+        Q_OBJECT
+
+      public:
+        /**
+         * @brief Function requesting new parameters from the server.
+         *
+         * Returns the parameters revised by the server or nullopt if the server rejected them.
+         */
+        using ApplyFunction = std::function<std::optional<opcua_qt::abstraction::MonitoringParameters>(
+            const opcua_qt::abstraction::MonitoringParameters&)>;
+
+        /**
+         * @param parameters the current parameters of the item, as revised by the server
+         * @param apply called with the requested parameters when the user applies them
+         * @param parent parent of the dialog
+         */
+        MonitoringParametersDialog(const opcua_qt::abstraction::MonitoringParameters& parameters, ApplyFunction apply,
+                                   QWidget* parent = nullptr);
+
+      private slots:
+        void onApply();
+
+      private:
+        void showParameters(const opcua_qt::abstraction::MonitoringParameters& parameters);
+        [[nodiscard]] opcua_qt::abstraction::MonitoringParameters getRequestedParameters() const;
+
+      private:
+        ApplyFunction   m_apply;
+        QDoubleSpinBox* m_sampling_interval;
+        QSpinBox*       m_queue_size;
+        QCheckBox*      m_discard_oldest;
+        QComboBox*      m_deadband_type;
+        QDoubleSpinBox* m_deadband_value;
+        QLabel*         m_revised;
+    };
+} // namespace magnesia::activities::dataviewer::panels
@@ -1,29 +1,35 @@
 #include "NodeViewModel.hpp"
 
+#include "../../../Application.hpp"
 #include "../../../opcua_qt/Connection.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
+#include "../../../opcua_qt/SubscriptionManager.hpp"
 #include "../../../opcua_qt/abstraction/AttributeId.hpp"
 #include "../../../opcua_qt/abstraction/LocalizedText.hpp"
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
 #include "../../../opcua_qt/abstraction/NodeClass.hpp"
 #include "../../../opcua_qt/abstraction/NodeId.hpp"
-#include "../../../opcua_qt/abstraction/Subscription.hpp"
 #include "../../../opcua_qt/abstraction/node/Node.hpp"
 #include "../../../qt_version_check.hpp"
 #include "../DataViewer.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
-#include <iterator>
+#include <optional>
 #include <span>
 #include <stack>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <QAbstractTableModel>
 #include <QModelIndex>
 #include <QObject>
 #include <QString>
+#include <QTimer>
 #include <QVariant>
 #include <Qt>
-#include <QtAlgorithms>
 #include <qtmetamacros.h>
 
 #ifdef MAGNESIA_HAS_QT_6_5
@@ -32,15 +38,30 @@
 #include <QtGlobal>
 #endif
 
+namespace {
+    constexpr std::chrono::milliseconds c_publishing_interval{500};
+} // namespace
+
 namespace magnesia::activities::dataviewer::panels::node_view_panel {
     using opcua_qt::Connection;
+    using opcua_qt::MonitoredItemSet;
+    using opcua_qt::SubscriptionManager;
     using opcua_qt::abstraction::AttributeId;
+    using opcua_qt::abstraction::MonitoringParameters;
     using opcua_qt::abstraction::Node;
     using opcua_qt::abstraction::NodeClass;
-    using opcua_qt::abstraction::Subscription;
 
     NodeViewModel::NodeViewModel(DataViewer* data_viewer, QObject* parent)
-        : QAbstractTableModel(parent), m_data_viewer(data_viewer) {}
+        : QAbstractTableModel(parent), m_data_viewer(data_viewer), m_refresh_timer(new QTimer(this)) {
+        const auto refresh_rate = Application::instance().getSettingsManager().getIntSetting(
+            {.name = "ui_max_refresh_rate", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(refresh_rate);
+
+        m_refresh_timer->setSingleShot(true);
+        m_refresh_timer->setInterval(std::chrono::milliseconds{std::chrono::seconds{1}} / refresh_rate.value());
+        connect(m_refresh_timer, &QTimer::timeout, this, &NodeViewModel::flushChangedRows);
+    }
 
     int NodeViewModel::rowCount(const QModelIndex& /*parent*/) const {
         return static_cast<int>(m_nodes.size());
@@ -61,6 +82,11 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
             case NodeIdColumn:
                 return node->getNodeId().toString();
             case DisplayNameColumn:
+                if (!node->isCached(AttributeId::DISPLAY_NAME)) {
+                    // The row is updated once the display name arrived, see subscribeNodes.
+                    node->loadAttributesAsync();
+                    return {};
+                }
                 if (const auto* display_name = node->getDisplayName(); display_name != nullptr) {
                     return display_name->getText();
                 }
@@ -70,6 +96,10 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
                 break;
         }
 
+        if (!node->isCached(AttributeId::VALUE)) {
+            node->loadAttributesAsync();
+            return {};
+        }
         const auto* data_value = node->getDataValue();
         if (data_value == nullptr) {
             return {};
@@ -126,21 +156,42 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
         if (node != nullptr) {
             auto leaf_nodes = findLeafNodes(node);
             subscribeNodes(leaf_nodes, connection);
-            // cppcheck-suppress danglingLifetime
-            m_nodes.insert(m_nodes.end(), leaf_nodes.begin(), leaf_nodes.end());
+            for (auto* leaf_node : leaf_nodes) {
+                m_rows.emplace(leaf_node, static_cast<int>(m_nodes.size()));
+                m_nodes.push_back(leaf_node);
+            }
         }
+        // the reset redraws every row
+        m_changed_rows.reset();
 
         endResetModel();
     }
 
     bool NodeViewModel::removeRows(int row, int count, const QModelIndex& parent) {
+        // pending changes refer to the current row numbers
+        flushChangedRows();
         beginRemoveRows(parent, row, row + count - 1);
 
-        auto nodes_first = m_nodes.begin() + row;
-        auto nodes_last  = nodes_first + count;
-        qDeleteAll(nodes_first, nodes_last);
+        auto                     nodes_first = m_nodes.begin() + row;
+        auto                     nodes_last  = nodes_first + count;
+        const std::vector<Node*> removed_nodes(nodes_first, nodes_last);
+        // The nodes are owned by their connection and may be shown elsewhere, so they are not deleted.
         m_nodes.erase(nodes_first, nodes_last);
-        m_subscriptions.erase(m_subscriptions.begin() + row, m_subscriptions.begin() + row + count);
+        m_rows.clear();
+        for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+            m_rows.emplace(m_nodes[i], static_cast<int>(i));
+        }
+
+        std::vector<Node*> hidden_nodes;
+        for (auto* node : removed_nodes) {
+            if (!m_rows.contains(node)) {
+                disconnect(node, &Node::attributesLoaded, this, nullptr);
+                hidden_nodes.push_back(node);
+            }
+        }
+        if (m_monitored_items != nullptr) {
+            m_monitored_items->unmonitor(hidden_nodes);
+        }
 
         endRemoveRows();
 
@@ -152,13 +203,18 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
             return {};
         }
 
-        std::vector<Node*> leaf_nodes;
-        std::stack<Node*>  stack;
+        std::vector<Node*>        leaf_nodes;
+        std::stack<Node*>         stack;
+        std::unordered_set<Node*> visited;
         stack.push(node);
 
         while (!stack.empty()) {
             auto* current = stack.top();
             stack.pop();
+            // Nodes are shared between all their parents, visit each one only once. This also ends cycles.
+            if (!visited.insert(current).second) {
+                continue;
+            }
             const auto* children = current->getChildren();
             if (children == nullptr) {
                 continue;
@@ -178,29 +234,56 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
     }
 
     void NodeViewModel::subscribeNodes(std::span<Node*> nodes, Connection* connection) {
-        const std::vector attribute_ids{
-            AttributeId::DISPLAY_NAME,
-            AttributeId::VALUE,
-        };
+        if (m_monitored_items == nullptr) {
+            m_monitored_items =
+                new MonitoredItemSet(connection->getSubscriptionManager(), c_publishing_interval, this);
+            connect(m_monitored_items, &MonitoredItemSet::valueChanged, this,
+                    [this](Node* subscribed_node) { markNodeChanged(subscribed_node); });
+            m_monitored_items->setPaused(m_paused);
+        }
 
+        // all items are created in a few batched requests
+        std::unordered_set<Node*>                            added_nodes;
+        std::vector<SubscriptionManager::MonitoredAttribute> attributes;
+        attributes.reserve(nodes.size() * 2);
         for (auto* node : nodes) {
-            auto* subscription = connection->createSubscription(node, attribute_ids);
-            if (subscription == nullptr) {
-                return;
+            if (m_rows.contains(node) || !added_nodes.insert(node).second) {
+                continue;
+            }
+            attributes.emplace_back(node, AttributeId::DISPLAY_NAME);
+            attributes.emplace_back(node, AttributeId::VALUE);
+            connect(node, &Node::attributesLoaded, this, [this, node] { markNodeChanged(node); });
+        }
+        m_monitored_items->monitor(attributes);
+    }
+
+    void NodeViewModel::markNodeChanged(Node* node) {
+        auto [first, last] = m_rows.equal_range(node);
+        for (auto iter = first; iter != last; ++iter) {
+            const int row = iter->second;
+            if (m_changed_rows.has_value()) {
+                m_changed_rows->first  = std::min(m_changed_rows->first, row);
+                m_changed_rows->second = std::max(m_changed_rows->second, row);
+            } else {
+                m_changed_rows.emplace(row, row);
             }
-            connect(subscription, &Subscription::valueChanged, this, [this](Node* subscribed_node) {
-                auto node_it = std::ranges::find(m_nodes, subscribed_node);
-                Q_ASSERT(node_it != m_nodes.cend());
-                auto row = static_cast<int>(std::distance(m_nodes.begin(), node_it));
+        }
 
-                auto left_index  = createIndex(row, 0);
-                auto right_index = createIndex(row, COLUMN_COUNT - 1); // -1 because both indices are inclusive
-                Q_EMIT dataChanged(left_index, right_index, {Qt::DisplayRole});
-            });
-            subscription->setPublishingMode(true);
+        if (m_changed_rows.has_value() && !m_refresh_timer->isActive()) {
+            m_refresh_timer->start();
+        }
+    }
 
-            m_subscriptions.push_back(subscription);
+    void NodeViewModel::flushChangedRows() {
+        if (!m_changed_rows.has_value()) {
+            return;
         }
+        const auto [first_row, last_row] = *m_changed_rows;
+        m_changed_rows.reset();
+
+        auto left_index  = createIndex(first_row, 0);
+        auto right_index = createIndex(last_row, COLUMN_COUNT - 1); // -1 because both indices are inclusive
+        Q_EMIT dataChanged(left_index, right_index, {Qt::DisplayRole});
     }
 
     opcua_qt::abstraction::Node* NodeViewModel::getNode(QModelIndex index) const {
@@ -211,4 +294,26 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
         return m_nodes[static_cast<std::size_t>(index.row())];
     }
 
+    void NodeViewModel::setPaused(bool paused) {
+        m_paused = paused;
+        if (m_monitored_items != nullptr) {
+            m_monitored_items->setPaused(paused);
+        }
+    }
+
+    std::optional<MonitoringParameters> NodeViewModel::getMonitoringParameters(Node* node) const {
+        if (m_monitored_items == nullptr) {
+            return std::nullopt;
+        }
+        return m_monitored_items->getParameters(node, AttributeId::VALUE);
+    }
+
+    std::optional<MonitoringParameters> NodeViewModel::setMonitoringParameters(Node*                       node,
+                                                                               const MonitoringParameters& parameters) {
+        if (m_monitored_items == nullptr || !m_monitored_items->setParameters(node, AttributeId::VALUE, parameters)) {
+            return std::nullopt;
+        }
+        return getMonitoringParameters(node);
+    }
+
 } // namespace magnesia::activities::dataviewer::panels::node_view_panel
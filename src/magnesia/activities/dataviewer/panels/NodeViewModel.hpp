@@ -1,16 +1,21 @@
 #pragma once
 
 #include "../../../opcua_qt/Connection.hpp"
-#include "../../../opcua_qt/abstraction/Subscription.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
 #include "../../../opcua_qt/abstraction/node/Node.hpp"
 #include "../dataviewer_fwd.hpp"
 
+#include <optional>
 #include <span>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <QAbstractTableModel>
 #include <QModelIndex>
 #include <QObject>
+#include <QTimer>
 #include <QVariant>
 #include <Qt>
 #include <qtmetamacros.h>
@@ -52,14 +57,58 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
          */
         [[nodiscard]] opcua_qt::abstraction::Node* getNode(QModelIndex index) const;
 
+        /**
+         * Pauses or resumes value updates, e.g. while the view is hidden. The latest values are reported right after
+         * resuming.
+         *
+         * @param paused Whether to pause updates.
+         */
+        void setPaused(bool paused);
+
+        /**
+         * Retrieves the monitoring parameters of a node's value, as revised by the server.
+         *
+         * @param node Node inside the view.
+         */
+        [[nodiscard]] std::optional<opcua_qt::abstraction::MonitoringParameters>
+        getMonitoringParameters(opcua_qt::abstraction::Node* node) const;
+
+        /**
+         * Changes the monitoring parameters of a node's value.
+         *
+         * @param node Node inside the view.
+         * @param parameters Requested monitoring parameters.
+         * @return The parameters revised by the server or nullopt if they were rejected.
+         */
+        std::optional<opcua_qt::abstraction::MonitoringParameters>
+        setMonitoringParameters(opcua_qt::abstraction::Node*                       node,
+                                const opcua_qt::abstraction::MonitoringParameters& parameters);
+
       private:
         static std::vector<opcua_qt::abstraction::Node*> findLeafNodes(opcua_qt::abstraction::Node* node);
         void subscribeNodes(std::span<opcua_qt::abstraction::Node*> nodes, opcua_qt::Connection* connection);
+        /**
+         * Marks the rows of a node as changed. Changes are coalesced into a single dataChanged per refresh.
+         */
+        void markNodeChanged(opcua_qt::abstraction::Node* node);
+        /**
+         * Emits dataChanged for all rows changed since the last refresh.
+         */
+        void flushChangedRows();
 
       private:
-        DataViewer*                                       m_data_viewer;
-        std::vector<opcua_qt::abstraction::Node*>         m_nodes;
-        std::vector<opcua_qt::abstraction::Subscription*> m_subscriptions;
+        DataViewer*                                                m_data_viewer;
+        std::vector<opcua_qt::abstraction::Node*>                  m_nodes;
+        // maps every node to its rows
+        std::unordered_multimap<opcua_qt::abstraction::Node*, int> m_rows;
+        // created with the first node, every node is monitored once no matter how many rows show it
+        opcua_qt::MonitoredItemSet*                                m_monitored_items{nullptr};
+        bool                                                       m_paused{false};
+
+        // limits dataChanged to the configured refresh rate
+        QTimer*                            m_refresh_timer;
+        // first and last row changed since the last refresh
+        std::optional<std::pair<int, int>> m_changed_rows;
 
       private:
         enum {
@@ -1,16 +1,19 @@
 #include "NodeViewPanel.hpp"
 
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
 #include "../../../opcua_qt/abstraction/NodeId.hpp"
 #include "../DataViewer.hpp"
 #include "../Panel.hpp"
 #include "../dataviewer_fwd.hpp"
 #include "../panels.hpp"
 #include "../panels/NodeViewModel.hpp"
+#include "MonitoringParametersDialog.hpp"
 
 #include <algorithm>
 #include <optional>
 
 #include <QAbstractItemView>
+#include <QDialog>
 #include <QFrame>
 #include <QHeaderView>
 #include <QItemSelectionModel>
@@ -23,6 +26,8 @@
 #include <qtmetamacros.h>
 
 namespace magnesia::activities::dataviewer::panels::node_view_panel {
+    using opcua_qt::abstraction::MonitoringParameters;
+
     NodeViewPanel::NodeViewPanel(DataViewer* dataviewer, QWidget* parent)
         : Panel(dataviewer, PanelType::nodeview, node_view_panel::metadata, parent),
           m_model(new NodeViewModel(dataviewer, this)), m_table_view(new QTableView) {
@@ -56,6 +61,36 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
             m_model->removeRows(start, count);
         });
         remove->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+
+        m_table_view->addAction("Plot selected", this, [this] {
+            for (const auto& row : m_table_view->selectionModel()->selectedRows()) {
+                if (const auto* node = m_model->getNode(row); node != nullptr) {
+                    Q_EMIT nodeSelected(node->getNodeId(), PanelType::trendplot);
+                }
+            }
+        });
+
+        m_table_view->addAction("Monitoring parameters...", this, [this] {
+            auto* node = m_model->getNode(m_table_view->currentIndex());
+            if (node == nullptr) {
+                return;
+            }
+            auto parameters = m_model->getMonitoringParameters(node);
+            if (!parameters.has_value()) {
+                return;
+            }
+
+            auto* dialog = new MonitoringParametersDialog(
+                *parameters,
+                [this, node](const MonitoringParameters& requested) {
+                    return m_model->setMonitoringParameters(node, requested);
+                },
+                this);
+            dialog->setAttribute(Qt::WA_DeleteOnClose);
+            // rows and their nodes may be removed while the dialog is open
+            connect(m_model, &NodeViewModel::rowsRemoved, dialog, &QDialog::close);
+            dialog->open();
+        });
     }
 
     void NodeViewPanel::onCurrentNodeChanged(const QModelIndex& current) {
@@ -67,6 +102,10 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
         Q_EMIT nodeSelected(node->getNodeId(), PanelType::attributeview | PanelType::referenceview);
     }
 
+    void NodeViewPanel::onVisibilityChanged(bool visible) {
+        m_model->setPaused(!visible);
+    }
+
     void NodeViewPanel::selectNode(const opcua_qt::abstraction::NodeId& node_id) {
         auto* connection = getDataViewer()->getConnection();
 
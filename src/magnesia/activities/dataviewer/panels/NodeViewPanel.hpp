@@ -26,6 +26,9 @@ namespace magnesia::activities::dataviewer::panels::node_view_panel {
          */
         explicit NodeViewPanel(DataViewer* dataviewer, QWidget* parent = nullptr);
 
+      protected:
+        void onVisibilityChanged(bool visible) override;
+
       private slots:
         void selectNode(const opcua_qt::abstraction::NodeId& node) override;
         void onCurrentNodeChanged(const QModelIndex& current);
@@ -1,11 +1,15 @@
 #include "TreeViewModel.hpp"
 
+#include "../../../opcua_qt/abstraction/AttributeId.hpp"
 #include "../../../opcua_qt/abstraction/node/Node.hpp"
 
-#include <algorithm>
 #include <cstddef>
-#include <iterator>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <QAbstractItemModel>
 #include <QModelIndex>
@@ -14,27 +18,35 @@
 #include <QVariant>
 #include <Qt>
 
+namespace {
+    // Number of children requested per browse. Small enough for the first rows to show up quickly.
+    constexpr std::uint32_t c_browse_page_size = 1000;
+} // namespace
+
 namespace magnesia::activities::dataviewer::panels::treeview_panel {
+    using opcua_qt::abstraction::AttributeId;
     using opcua_qt::abstraction::Node;
 
     TreeViewModel::TreeViewModel(QObject* parent) : QAbstractItemModel(parent) {}
 
     QModelIndex TreeViewModel::index(int row, int column, const QModelIndex& parent) const {
-        if (m_root_node == nullptr || !checkIndex(parent)) {
+        if (m_root_item == nullptr || !checkIndex(parent)) {
             return {};
         }
 
-        auto* parent_node = getNode(parent);
-        Node* node        = nullptr;
+        auto*     parent_item = getItem(parent);
+        TreeItem* item        = nullptr;
 
         // Start tree with root node
-        if (parent_node == nullptr) {
-            node = m_root_node;
-        } else if (const auto* children = parent_node->getChildren(); children != nullptr) {
-            node = (*children)[static_cast<std::size_t>(row)];
+        if (parent_item == nullptr) {
+            item = m_root_item.get();
+        } else {
+            if (static_cast<std::size_t>(row) < parent_item->children.size()) {
+                item = parent_item->children[static_cast<std::size_t>(row)].get();
+            }
         }
 
-        return node != nullptr ? createIndex(row, column, node) : QModelIndex();
+        return item != nullptr ? createIndex(row, column, item) : QModelIndex();
     }
 
     QModelIndex TreeViewModel::parent(const QModelIndex& index) const {
@@ -42,21 +54,8 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
             return {};
         }
 
-        auto* node = getNode(index);
-
         // Root does not have a parent
-        if (node == m_root_node) {
-            return {};
-        }
-
-        auto* parent_node = node->getParent();
-        if (parent_node == m_root_node) {
-            // Root always has index 0
-            return createIndex(0, 0, parent_node);
-        }
-
-        const int row = getChildIndexOf(parent_node->getParent(), parent_node);
-        return createIndex(row, 0, parent_node);
+        return indexOf(getItem(index)->parent);
     }
 
     int TreeViewModel::rowCount(const QModelIndex& parent) const {
@@ -64,15 +63,12 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
             return 0;
         }
 
-        auto* node = getNode(parent);
-        if (node == nullptr) {
-            return 1;
-        }
-        const auto* children = node->getChildren();
-        if (children == nullptr) {
-            return 0;
+        auto* item = getItem(parent);
+        if (item == nullptr) {
+            return m_root_item != nullptr ? 1 : 0;
         }
-        return static_cast<int>(children->size());
+        // children are added by fetchMore
+        return static_cast<int>(item->children.size());
     }
 
     int TreeViewModel::columnCount(const QModelIndex& /*parent*/) const {
@@ -84,7 +80,13 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
             return {};
         }
 
-        if (const auto* display_name = getNode(index)->getDisplayName(); display_name != nullptr) {
+        auto* node = getNode(index);
+        if (!node->isCached(AttributeId::DISPLAY_NAME)) {
+            // The row is updated once the display name arrived, see watchNode.
+            node->loadAttributesAsync();
+            return {};
+        }
+        if (const auto* display_name = node->getDisplayName(); display_name != nullptr) {
             return display_name->getText();
         }
         return {};
@@ -100,20 +102,64 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
     }
 
     bool TreeViewModel::canFetchMore(const QModelIndex& parent) const {
-        const auto* node = getNode(parent);
-        if (node == nullptr) {
-            return true;
+        const auto* item = getItem(parent);
+        return item != nullptr && !item->fetch->complete;
+    }
+
+    void TreeViewModel::fetchMore(const QModelIndex& parent) {
+        auto* item = getItem(parent);
+        if (item == nullptr || item->fetch->requested || item->fetch->complete) {
+            return;
+        }
+        item->fetch->requested = true;
+
+        // The fetch is owned by the item, which is owned by this model. If it expired, the item was collapsed or
+        // removed.
+        auto on_page = [this, item, node = item->node,
+                        fetch = std::weak_ptr{item->fetch}](std::optional<Node::ChildrenPage> page) {
+            if (fetch.expired()) {
+                if (page.has_value()) {
+                    node->releaseChildrenBrowse(page->continuation_point);
+                }
+                return;
+            }
+            onChildrenPage(item, std::move(page));
+        };
+        item->node->browseChildrenAsync(item->fetch->continuation_point, c_browse_page_size, std::move(on_page));
+    }
+
+    void TreeViewModel::cancelFetch(const QModelIndex& parent) {
+        auto* item = getItem(parent);
+        if (item == nullptr || item->fetch->complete) {
+            return;
+        }
+        // a requested page brings a new continuation point, which is released when it arrives
+        if (!item->fetch->requested) {
+            item->node->releaseChildrenBrowse(item->fetch->continuation_point);
+        }
+        item->fetch = std::make_shared<ChildrenFetch>();
+
+        if (!item->children.empty()) {
+            beginRemoveRows(parent, 0, static_cast<int>(item->children.size()) - 1);
+            releaseChildren(item);
+            endRemoveRows();
         }
-        return !node->childrenCountCached().has_value();
     }
 
     bool TreeViewModel::hasChildren(const QModelIndex& parent) const {
-        const auto* node = getNode(parent);
-        if (node == nullptr) {
+        const auto* item = getItem(parent);
+        if (item == nullptr) {
             return true;
         }
 
-        auto children_count = node->childrenCountCached();
+        if (!item->children.empty()) {
+            return true;
+        }
+        if (item->fetch->complete) {
+            return false;
+        }
+
+        auto children_count = item->node->childrenCountCached();
         if (!children_count.has_value()) {
             // we don't yet know if the node has children
             // return true to enable finding out later
@@ -124,20 +170,107 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
 
     void TreeViewModel::setRootNode(Node* root) {
         beginResetModel();
-        m_root_node = root;
+        for (auto* node : m_watched_nodes) {
+            disconnect(node, nullptr, this, nullptr);
+        }
+        m_watched_nodes.clear();
+        m_items.clear();
+        m_root_item.reset();
+        if (root != nullptr) {
+            m_root_item = createItem(root, nullptr, 0);
+            watchNode(root);
+        }
         endResetModel();
     }
 
     Node* TreeViewModel::getNode(const QModelIndex& index) {
-        return static_cast<Node*>(index.internalPointer());
+        const auto* item = getItem(index);
+        return item != nullptr ? item->node : nullptr;
+    }
+
+    TreeViewModel::TreeItem* TreeViewModel::getItem(const QModelIndex& index) {
+        return static_cast<TreeItem*>(index.internalPointer());
     }
 
-    int TreeViewModel::getChildIndexOf(Node* parent, Node* child) {
-        if (const auto* children = parent->getChildren(); children != nullptr) {
-            auto iter = std::ranges::find(*children, child);
-            return iter != children->end() ? static_cast<int>(std::distance(children->begin(), iter)) : -1;
+    QModelIndex TreeViewModel::indexOf(TreeItem* item) const {
+        if (item == nullptr) {
+            return {};
         }
-        return -1;
+        return createIndex(item->row, 0, item);
+    }
+
+    std::unique_ptr<TreeViewModel::TreeItem> TreeViewModel::createItem(Node* node, TreeItem* parent, int row) {
+        auto item = std::make_unique<TreeItem>(TreeItem{.node = node, .parent = parent, .row = row});
+        m_items.emplace(node, item.get());
+        return item;
+    }
+
+    void TreeViewModel::releaseChildren(TreeItem* item) {
+        for (auto& child : item->children) {
+            releaseChildren(child.get());
+            auto [first, last] = m_items.equal_range(child->node);
+            for (auto iter = first; iter != last; ++iter) {
+                if (iter->second == child.get()) {
+                    m_items.erase(iter);
+                    break;
+                }
+            }
+        }
+        item->children.clear();
+    }
+
+    std::vector<TreeViewModel::TreeItem*> TreeViewModel::itemsOf(Node* node) const {
+        auto [first, last] = m_items.equal_range(node);
+        std::vector<TreeItem*> items;
+        for (auto iter = first; iter != last; ++iter) {
+            items.push_back(iter->second);
+        }
+        return items;
+    }
+
+    void TreeViewModel::onChildrenPage(TreeItem* item, std::optional<Node::ChildrenPage> page) {
+        auto& fetch     = *item->fetch;
+        fetch.requested = false;
+        if (!page.has_value()) {
+            fetch.continuation_point = {};
+            fetch.complete           = true;
+            return;
+        }
+        fetch.continuation_point = page->continuation_point;
+        fetch.complete           = page->continuation_point.empty();
+
+        if (!page->children.empty()) {
+            const auto row = static_cast<int>(item->children.size());
+            beginInsertRows(indexOf(item), row, row + static_cast<int>(page->children.size()) - 1);
+            for (auto* child : page->children) {
+                item->children.push_back(createItem(child, item, static_cast<int>(item->children.size())));
+            }
+            endInsertRows();
+        }
+
+        // Browsing already provides the display names, only watch the children that need to load it.
+        for (auto* child : page->children) {
+            if (!child->isCached(AttributeId::DISPLAY_NAME)) {
+                watchNode(child);
+            }
+        }
+
+        // stream the remaining pages until the row is collapsed
+        fetchMore(indexOf(item));
+    }
+
+    void TreeViewModel::watchNode(Node* node) {
+        if (!m_watched_nodes.insert(node).second) {
+            return;
+        }
+
+        connect(node, &Node::attributesLoaded, this, [this, node] {
+            for (auto* item : itemsOf(node)) {
+                const auto index = indexOf(item);
+                Q_EMIT dataChanged(index, index, {Qt::DisplayRole});
+            }
+        });
+        connect(node, &QObject::destroyed, this, [this, node] { m_watched_nodes.erase(node); });
     }
 
 } // namespace magnesia::activities::dataviewer::panels::treeview_panel
@@ -2,6 +2,14 @@
 
 #include "../../../opcua_qt/abstraction/node/Node.hpp"
 
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <open62541pp/types/Builtin.h>
+
 #include <QAbstractItemModel>
 #include <QModelIndex>
 #include <QObject>
@@ -31,8 +39,16 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
         [[nodiscard]] QVariant    headerData(int section, Qt::Orientation orientation,
                                              int role = Qt::DisplayRole) const override;
         [[nodiscard]] bool        canFetchMore(const QModelIndex& parent) const override;
+        void                      fetchMore(const QModelIndex& parent) override;
         [[nodiscard]] bool        hasChildren(const QModelIndex& parent) const override;
 
+        /**
+         * Stops fetching the children of a row, e.g. because it was collapsed. The children fetched so far are
+         * removed, unless all children have been fetched already. Other rows showing the same node aren't affected.
+         * @param parent Index of the row.
+         */
+        void cancelFetch(const QModelIndex& parent);
+
         /**
          * Retrieves the node in the treeview.
          * @param index Index inside the view.
@@ -47,10 +63,42 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
         void setRootNode(opcua_qt::abstraction::Node* root);
 
       private:
-        [[nodiscard]] static int getChildIndexOf(opcua_qt::abstraction::Node* parent,
-                                                 opcua_qt::abstraction::Node* child);
+        /**
+         * Progress of browsing the children of a row page by page.
+         */
+        struct ChildrenFetch {
+            opcua::ByteString continuation_point;
+            bool              requested{false};
+            bool              complete{false};
+        };
+
+        /**
+         * A row of the tree. Nodes can have several parents, so the same node can be shown in several rows. Every row
+         * fetches its children on its own, so collapsing one row doesn't affect the others.
+         */
+        struct TreeItem {
+            opcua_qt::abstraction::Node* node;
+            TreeItem*                    parent;
+            int                          row;
+            // the children fetched so far
+            std::vector<std::unique_ptr<TreeItem>> children;
+            // Shared with the pending browse request, which drops its page once the fetch was replaced.
+            std::shared_ptr<ChildrenFetch> fetch{std::make_shared<ChildrenFetch>()};
+        };
+
+        [[nodiscard]] static TreeItem* getItem(const QModelIndex& index);
+        [[nodiscard]] QModelIndex      indexOf(TreeItem* item) const;
+        std::unique_ptr<TreeItem>      createItem(opcua_qt::abstraction::Node* node, TreeItem* parent, int row);
+        void                           releaseChildren(TreeItem* item);
+        [[nodiscard]] std::vector<TreeItem*> itemsOf(opcua_qt::abstraction::Node* node) const;
+        void onChildrenPage(TreeItem* item, std::optional<opcua_qt::abstraction::Node::ChildrenPage> page);
+        void watchNode(opcua_qt::abstraction::Node* node);
 
       private:
-        opcua_qt::abstraction::Node* m_root_node{nullptr};
+        std::unique_ptr<TreeItem> m_root_item;
+        // all items, to find the rows of a node
+        std::unordered_multimap<opcua_qt::abstraction::Node*, TreeItem*> m_items;
+        // nodes whose signals are connected to this model
+        std::unordered_set<opcua_qt::abstraction::Node*> m_watched_nodes;
     };
 } // namespace magnesia::activities::dataviewer::panels::treeview_panel
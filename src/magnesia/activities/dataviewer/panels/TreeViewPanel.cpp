@@ -46,6 +46,8 @@ namespace magnesia::activities::dataviewer::panels::treeview_panel {
 
         connect(m_tree_view, &QTreeView::doubleClicked, this,
                 [this](QModelIndex index) { indexSelected(index, PanelType::nodeview); });
+
+        connect(m_tree_view, &QTreeView::collapsed, m_model, &TreeViewModel::cancelFetch);
     }
 
     void TreeViewPanel::indexSelected(QModelIndex index, panels::PanelTypes recipients) {
@@ -0,0 +1,251 @@
+#include "TrendPlotPanel.hpp"
+
+#include "../../../Application.hpp"
+#include "../../../opcua_qt/Connection.hpp"
+#include "../../../opcua_qt/HistoryRead.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
+#include "../../../opcua_qt/SubscriptionManager.hpp"
+#include "../../../opcua_qt/TimeSeries.hpp"
+#include "../../../opcua_qt/abstraction/AttributeId.hpp"
+#include "../../../opcua_qt/abstraction/MonitoringParameters.hpp"
+#include "../../../opcua_qt/abstraction/NodeClass.hpp"
+#include "../../../opcua_qt/abstraction/NodeId.hpp"
+#include "../../../opcua_qt/abstraction/node/Node.hpp"
+#include "../../../qt_version_check.hpp"
+#include "../DataViewer.hpp"
+#include "../Panel.hpp"
+#include "../panels.hpp"
+#include "TrendPlotWidget.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QPointer>
+#include <QPushButton>
+#include <QString>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QVariant>
+#include <QWidget>
+#include <Qt>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    constexpr std::chrono::milliseconds c_publishing_interval{100};
+    constexpr double                    c_sampling_interval_ms = 100;
+
+    constexpr std::array c_spans{
+        std::pair{std::chrono::seconds{10}, "10 s"},
+        std::pair{std::chrono::seconds{60}, "1 min"},
+        std::pair{std::chrono::seconds{600}, "10 min"},
+        std::pair{std::chrono::seconds{3600}, "1 h"},
+    };
+    constexpr int c_default_span_index = 1;
+
+    // values per HistoryRead page, bounds the memory of a page in flight
+    constexpr std::uint32_t c_history_page_size = 10000;
+} // namespace
+
+namespace magnesia::activities::dataviewer::panels::trend_plot_panel {
+    using opcua_qt::HistoryRead;
+    using opcua_qt::MonitoredItemSet;
+    using opcua_qt::SubscriptionManager;
+    using opcua_qt::TimeSeries;
+    using opcua_qt::abstraction::AttributeId;
+    using opcua_qt::abstraction::MonitoringParameters;
+    using opcua_qt::abstraction::Node;
+    using opcua_qt::abstraction::NodeClass;
+    using opcua_qt::abstraction::NodeId;
+
+    TrendPlotPanel::TrendPlotPanel(DataViewer* dataviewer, QWidget* parent)
+        : Panel(dataviewer, PanelType::trendplot, trend_plot_panel::metadata, parent),
+          m_plot(new TrendPlotWidget(&dataviewer->getConnection()->getSubscriptionManager()->getTimeSeriesStore())),
+          m_span_selector(new QComboBox), m_live_button(new QPushButton("Live")), m_frame_timer(new QTimer(this)),
+          m_monitored_items(new MonitoredItemSet(dataviewer->getConnection()->getSubscriptionManager(),
+                                                 c_publishing_interval, this)) {
+        const auto refresh_rate = Application::instance().getSettingsManager().getIntSetting(
+            {.name = "ui_max_refresh_rate", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(refresh_rate);
+        m_frame_timer->setInterval(std::chrono::milliseconds{std::chrono::seconds{1}} / refresh_rate.value());
+        connect(m_frame_timer, &QTimer::timeout, m_plot, [this] {
+            if (m_plot->isLive()) {
+                m_plot->update();
+            }
+        });
+
+        for (const auto& [span, name] : c_spans) {
+            m_span_selector->addItem(name, QVariant::fromValue(static_cast<qint64>(span.count())));
+        }
+        connect(m_span_selector, &QComboBox::currentIndexChanged, m_plot, [this](int index) {
+            m_plot->setSpan(std::chrono::seconds{m_span_selector->itemData(index).toLongLong()});
+        });
+        m_span_selector->setCurrentIndex(c_default_span_index);
+
+        // a replay shows values as old as its position
+        m_plot->setClock([manager = dataviewer->getConnection()->getSubscriptionManager()] {
+            return manager->getCurrentTime();
+        });
+
+        m_live_button->setCheckable(true);
+        m_live_button->setChecked(true);
+        connect(m_live_button, &QPushButton::toggled, m_plot, &TrendPlotWidget::setLive);
+
+        auto* history_button = new QPushButton("History");
+        history_button->setToolTip("Load the server's history of the visible interval");
+        connect(history_button, &QPushButton::clicked, this, &TrendPlotPanel::loadHistory);
+
+        auto* clear_button = new QPushButton("Clear");
+        connect(clear_button, &QPushButton::clicked, this, &TrendPlotPanel::clearTraces);
+
+        auto* tool_layout = new QHBoxLayout;
+        tool_layout->addWidget(m_span_selector);
+        tool_layout->addWidget(m_live_button);
+        tool_layout->addWidget(history_button);
+        tool_layout->addWidget(clear_button);
+        tool_layout->addStretch();
+
+        auto* layout = new QVBoxLayout;
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addLayout(tool_layout);
+        layout->addWidget(m_plot, 1);
+        setLayout(layout);
+
+        m_frame_timer->start();
+    }
+
+    void TrendPlotPanel::selectNode(const NodeId& node_id) {
+        addTrace(node_id);
+    }
+
+    void TrendPlotPanel::addTrace(const NodeId& node_id) {
+        getDataViewer()->getConnection()->getNodeAsync(node_id, [panel = QPointer{this}](Node* node) {
+            if (!panel.isNull() && node != nullptr) {
+                panel->addNodeTrace(node);
+            }
+        });
+    }
+
+    void TrendPlotPanel::addNodeTrace(Node* node) {
+        // cached by getNodeAsync, doesn't read anything
+        if (node->getNodeClass() != NodeClass::VARIABLE) {
+            return;
+        }
+
+        const auto  node_id      = node->getNodeId();
+        const auto* display_name = node->isCached(AttributeId::DISPLAY_NAME) ? node->getDisplayName() : nullptr;
+        if (!m_plot->addTrace(node_id, display_name != nullptr ? display_name->getText() : node_id.toString())) {
+            return;
+        }
+        if (display_name == nullptr) {
+            connect(node, &Node::attributesLoaded, m_plot, [plot = m_plot, node] {
+                if (const auto* name = node->getDisplayName(); name != nullptr) {
+                    plot->setTraceName(node->getNodeId(), name->getText());
+                }
+            });
+            node->loadAttributesAsync();
+        }
+
+        MonitoringParameters parameters;
+        parameters.setSamplingInterval(c_sampling_interval_ms);
+        const std::array attributes{SubscriptionManager::MonitoredAttribute{node, AttributeId::VALUE}};
+        m_monitored_items->monitor(attributes, parameters);
+    }
+
+    void TrendPlotPanel::clearTraces() {
+        cancelHistory();
+        m_plot->clearTraces();
+        // the recorded values stay in the store
+        delete m_monitored_items;
+        m_monitored_items = new MonitoredItemSet(getDataViewer()->getConnection()->getSubscriptionManager(),
+                                                 c_publishing_interval, this);
+    }
+
+    void TrendPlotPanel::loadHistory() {
+        cancelHistory();
+        m_plot->clearHistory();
+
+        const auto end   = m_plot->getEnd();
+        const auto start = end - m_plot->getSpan();
+        for (const auto& node_id : m_plot->getTraces()) {
+            // created when the trace was added
+            auto* node = getDataViewer()->getConnection()->findNode(node_id);
+            if (node == nullptr) {
+                continue;
+            }
+            // Pages are drawn as they arrive, without waiting for the whole interval.
+            auto* read = node->readHistoryRaw(start, end, c_history_page_size, this);
+            connect(read, &HistoryRead::samplesReceived, m_plot,
+                    [plot = m_plot, node_id](const std::vector<TimeSeries::Sample>& samples) {
+                        plot->appendHistory(node_id, samples);
+                    });
+            m_history_reads.push_back(read);
+        }
+    }
+
+    void TrendPlotPanel::cancelHistory() {
+        for (auto* read : m_history_reads) {
+            delete read;
+        }
+        m_history_reads.clear();
+    }
+
+    void TrendPlotPanel::onVisibilityChanged(bool visible) {
+        // Values keep being recorded while hidden, only drawing stops.
+        if (visible) {
+            m_frame_timer->start();
+            m_plot->update();
+        } else {
+            m_frame_timer->stop();
+        }
+    }
+
+    QJsonObject TrendPlotPanel::saveState() const {
+        QJsonArray traces;
+        for (const auto& node_id : m_plot->getTraces()) {
+            traces.append(node_id.toString());
+        }
+        const auto span = std::chrono::duration_cast<std::chrono::seconds>(m_plot->getSpan());
+
+        return {
+            {"traces", traces                           },
+            {"span",   static_cast<qint64>(span.count())},
+            {"live",   m_plot->isLive()                 },
+        };
+    }
+
+    bool TrendPlotPanel::restoreState(const QJsonObject& state) {
+        const auto traces = state["traces"];
+        const auto span   = state["span"];
+        const auto live   = state["live"];
+        if (!traces.isArray() || !span.isDouble() || !live.isBool()) {
+            return false;
+        }
+
+        const auto span_index = m_span_selector->findData(QVariant::fromValue(span.toInteger()));
+        if (span_index >= 0) {
+            m_span_selector->setCurrentIndex(span_index);
+        }
+        m_live_button->setChecked(live.toBool());
+
+        for (const auto& trace : traces.toArray()) {
+            if (auto node_id = NodeId::fromString(trace.toString()); node_id.has_value()) {
+                addTrace(*node_id);
+            }
+        }
+        return true;
+    }
+} // namespace magnesia::activities::dataviewer::panels::trend_plot_panel
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../../../opcua_qt/HistoryRead.hpp"
+#include "../../../opcua_qt/MonitoredItemSet.hpp"
+#include "../../../opcua_qt/abstraction/NodeId.hpp"
+#include "../../../opcua_qt/abstraction/node/Node.hpp"
+#include "../Panel.hpp"
+#include "../PanelMetadata.hpp"
+#include "../dataviewer_fwd.hpp"
+#include "TrendPlotWidget.hpp"
+
+#include <vector>
+
+#include <QComboBox>
+#include <QJsonObject>
+#include <QPushButton>
+#include <QTimer>
+#include <QWidget>
+#include <qtmetamacros.h>
+
+namespace magnesia::activities::dataviewer::panels::trend_plot_panel {
+    /**
+     * @class TrendPlotPanel
+     * @brief Panel plotting the values of variables over time.
+     *
+     * Variables are added by selecting them in another panel, e.g. with "Plot selected" in the NodeView. Values are
+     * recorded by the connection's TimeSeriesStore, so the plot also shows values received before the variable was
+     * added. Older values can be loaded from the server's history.
+     */
+    class TrendPlotPanel : public Panel {
+        Q_OBJECT
+
+      public:
+        /**
+         * @param dataviewer Dataviewer in which the panel is embedded.
+         * @param parent Parent of the panel.
+         */
+        explicit TrendPlotPanel(DataViewer* dataviewer, QWidget* parent = nullptr);
+
+        [[nodiscard]] QJsonObject saveState() const override;
+        [[nodiscard]] bool        restoreState(const QJsonObject& state) override;
+
+      protected:
+        void onVisibilityChanged(bool visible) override;
+
+      private slots:
+        void selectNode(const opcua_qt::abstraction::NodeId& node_id) override;
+        void clearTraces();
+        void loadHistory();
+
+      private:
+        // gets the node without blocking, see addNodeTrace
+        void addTrace(const opcua_qt::abstraction::NodeId& node_id);
+        void addNodeTrace(opcua_qt::abstraction::Node* node);
+        void cancelHistory();
+
+      private:
+        TrendPlotWidget*            m_plot;
+        QComboBox*                  m_span_selector;
+        QPushButton*                m_live_button;
+        // redraws the plot while it follows the current time
+        QTimer*                     m_frame_timer;
+        opcua_qt::MonitoredItemSet* m_monitored_items;
+        // one per trace, kept until the next load so the reads are cancelled
+        std::vector<opcua_qt::HistoryRead*> m_history_reads;
+    };
+
+    inline constexpr PanelMetadata metadata{
+        .id     = u"trendplot",
+        .name   = u"TrendPlot",
+        .create = create_helper<TrendPlotPanel>,
+    };
+} // namespace magnesia::activities::dataviewer::panels::trend_plot_panel
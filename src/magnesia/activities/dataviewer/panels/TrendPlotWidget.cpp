@@ -0,0 +1,260 @@
+#include "TrendPlotWidget.hpp"
+
+#include "../../../opcua_qt/TimeSeries.hpp"
+#include "../../../opcua_qt/TimeSeriesStore.hpp"
+#include "../../../opcua_qt/abstraction/NodeId.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <QColor>
+#include <QDateTime>
+#include <QPainter>
+#include <QPalette>
+#include <QPen>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QString>
+#include <QWidget>
+#include <Qt>
+#include <QtEvents>
+
+namespace {
+    constexpr int    c_margin_left   = 80;
+    constexpr int    c_margin_right  = 8;
+    constexpr int    c_margin_top    = 8;
+    constexpr int    c_margin_bottom = 24;
+    constexpr int    c_grid_lines    = 4;
+    constexpr int    c_label_padding = 4;
+    constexpr int    c_label_digits  = 6;
+    // golden angle, consecutive traces get clearly different colors
+    constexpr int    c_hue_step      = 137;
+    constexpr int    c_saturation    = 200;
+    constexpr int    c_value         = 220;
+    constexpr double c_range_padding = 0.05;
+    constexpr int    c_history_alpha = 128;
+
+    constexpr std::chrono::minutes c_default_span{1};
+} // namespace
+
+namespace magnesia::activities::dataviewer::panels::trend_plot_panel {
+    using opcua_qt::TimeSeries;
+    using opcua_qt::abstraction::NodeId;
+
+    TrendPlotWidget::TrendPlotWidget(const opcua_qt::TimeSeriesStore* store, QWidget* parent)
+        : QWidget(parent), m_store(store), m_span(c_default_span) {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+        setMinimumSize(c_margin_left + c_margin_right + 1, c_margin_top + c_margin_bottom + 1);
+    }
+
+    bool TrendPlotWidget::addTrace(const NodeId& node_id, const QString& name) {
+        if (std::ranges::find(m_traces, node_id, &Trace::node_id) != m_traces.end()) {
+            return false;
+        }
+
+        const auto hue = static_cast<int>(m_traces.size()) * c_hue_step % 360;
+        m_traces.push_back({.node_id = node_id, .name = name, .color = QColor::fromHsv(hue, c_saturation, c_value)});
+        update();
+        return true;
+    }
+
+    void TrendPlotWidget::setTraceName(const NodeId& node_id, const QString& name) {
+        const auto trace = std::ranges::find(m_traces, node_id, &Trace::node_id);
+        if (trace != m_traces.end()) {
+            trace->name = name;
+            update();
+        }
+    }
+
+    void TrendPlotWidget::clearTraces() {
+        m_traces.clear();
+        update();
+    }
+
+    void TrendPlotWidget::appendHistory(const NodeId& node_id, std::span<const TimeSeries::Sample> samples) {
+        const auto trace = std::ranges::find(m_traces, node_id, &Trace::node_id);
+        if (trace == m_traces.end()) {
+            return;
+        }
+        if (trace->history == nullptr) {
+            trace->history = std::make_unique<TimeSeries>(m_store->getCapacity());
+        }
+        for (const auto& sample : samples) {
+            trace->history->append(sample.time, sample.value);
+        }
+        update();
+    }
+
+    void TrendPlotWidget::clearHistory() {
+        for (auto& trace : m_traces) {
+            trace.history.reset();
+        }
+        update();
+    }
+
+    std::vector<NodeId> TrendPlotWidget::getTraces() const {
+        std::vector<NodeId> node_ids;
+        node_ids.reserve(m_traces.size());
+        for (const auto& trace : m_traces) {
+            node_ids.push_back(trace.node_id);
+        }
+        return node_ids;
+    }
+
+    void TrendPlotWidget::setSpan(TimeSeries::Duration span) {
+        m_span = std::max(span, TimeSeries::Duration{1});
+        update();
+    }
+
+    TimeSeries::Duration TrendPlotWidget::getSpan() const noexcept {
+        return m_span;
+    }
+
+    void TrendPlotWidget::setLive(bool live) {
+        if (!live && m_live) {
+            m_end = getEnd();
+        }
+        m_live = live;
+        update();
+    }
+
+    bool TrendPlotWidget::isLive() const noexcept {
+        return m_live;
+    }
+
+    void TrendPlotWidget::setClock(std::function<TimeSeries::TimePoint()> clock) {
+        m_clock = std::move(clock);
+        update();
+    }
+
+    TimeSeries::TimePoint TrendPlotWidget::getEnd() const {
+        if (!m_live) {
+            return m_end;
+        }
+        if (m_clock) {
+            return m_clock();
+        }
+        return std::chrono::time_point_cast<TimeSeries::Duration>(std::chrono::system_clock::now());
+    }
+
+    void TrendPlotWidget::paintEvent(QPaintEvent* /*event*/) {
+        QPainter painter{this};
+        painter.fillRect(rect(), palette().base());
+
+        const QRectF plot{rect().adjusted(c_margin_left, c_margin_top, -c_margin_right, -c_margin_bottom)};
+        const auto   columns = static_cast<std::size_t>(plot.width());
+        if (columns == 0 || plot.height() < 1) {
+            return;
+        }
+
+        const auto to   = getEnd();
+        const auto from = to - m_span;
+
+        // decimate everything first, the value axis covers all traces
+        std::vector<std::vector<TimeSeries::Bucket>> decimated;
+        std::vector<std::vector<TimeSeries::Bucket>> decimated_history;
+        decimated.reserve(m_traces.size());
+        decimated_history.reserve(m_traces.size());
+        double     min_value{std::numeric_limits<double>::infinity()};
+        double     max_value{-std::numeric_limits<double>::infinity()};
+        const auto decimate = [&](const TimeSeries* series, std::vector<TimeSeries::Bucket>& buckets) {
+            if (series != nullptr) {
+                buckets = series->decimate(from, to, columns);
+            }
+            for (const auto& bucket : buckets) {
+                min_value = std::min(min_value, bucket.min);
+                max_value = std::max(max_value, bucket.max);
+            }
+        };
+        for (const auto& trace : m_traces) {
+            decimate(m_store->find(trace.node_id), decimated.emplace_back());
+            decimate(trace.history.get(), decimated_history.emplace_back());
+        }
+        if (min_value > max_value) {
+            min_value = 0;
+            max_value = 1;
+        } else if (min_value == max_value) {
+            min_value -= 1;
+            max_value += 1;
+        } else {
+            const auto padding = (max_value - min_value) * c_range_padding;
+            min_value -= padding;
+            max_value += padding;
+        }
+
+        const auto to_x = [&](TimeSeries::TimePoint time) {
+            return plot.left()
+                   + static_cast<double>((time - from).count()) / static_cast<double>(m_span.count()) * plot.width();
+        };
+        const auto to_y = [&](double value) {
+            return plot.bottom() - (value - min_value) / (max_value - min_value) * plot.height();
+        };
+
+        // grid and axis labels
+        const auto text_color  = palette().color(QPalette::Text);
+        const auto font_height = static_cast<double>(painter.fontMetrics().height());
+        painter.setPen(QPen{palette().color(QPalette::Mid), 0, Qt::DotLine});
+        for (int i = 0; i <= c_grid_lines; ++i) {
+            const auto value = min_value + (max_value - min_value) * i / c_grid_lines;
+            const auto y     = to_y(value);
+            painter.drawLine(QPointF{plot.left(), y}, QPointF{plot.right(), y});
+            painter.save();
+            painter.setPen(text_color);
+            painter.drawText(QRectF{0, y - font_height / 2, c_margin_left - c_label_padding, font_height},
+                             Qt::AlignRight | Qt::AlignVCenter, QString::number(value, 'g', c_label_digits));
+            painter.restore();
+        }
+        painter.setPen(text_color);
+        painter.drawRect(plot);
+        const auto to_label = [](TimeSeries::TimePoint time) {
+            const auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
+            return QDateTime::fromMSecsSinceEpoch(msecs.count()).toString("hh:mm:ss");
+        };
+        const QRectF time_labels{plot.left(), plot.bottom() + c_label_padding, plot.width(), font_height};
+        painter.drawText(time_labels, Qt::AlignLeft | Qt::AlignTop, to_label(from));
+        painter.drawText(time_labels, Qt::AlignHCenter | Qt::AlignTop, to_label(from + m_span / 2));
+        painter.drawText(time_labels, Qt::AlignRight | Qt::AlignTop, to_label(to));
+
+        // traces, every bucket adds its minimum and maximum so the polyline covers the full range of each pixel
+        painter.setClipRect(plot);
+        painter.setRenderHint(QPainter::Antialiasing, false);
+        QPolygonF  points;
+        const auto draw_buckets = [&](const std::vector<TimeSeries::Bucket>& buckets, const QColor& color) {
+            points.clear();
+            points.reserve(static_cast<qsizetype>(buckets.size() * 2));
+            for (const auto& bucket : buckets) {
+                const auto x = to_x(bucket.start + (bucket.end - bucket.start) / 2);
+                points.append(QPointF{x, to_y(bucket.min)});
+                if (bucket.max != bucket.min) {
+                    points.append(QPointF{x, to_y(bucket.max)});
+                }
+            }
+            painter.setPen(QPen{color, 0});
+            painter.drawPolyline(points);
+        };
+        for (std::size_t i = 0; i < m_traces.size(); ++i) {
+            auto history_color = m_traces[i].color;
+            history_color.setAlpha(c_history_alpha);
+            draw_buckets(decimated_history[i], history_color);
+            draw_buckets(decimated[i], m_traces[i].color);
+        }
+
+        // legend
+        painter.setClipping(false);
+        auto legend_y = plot.top() + c_label_padding;
+        for (const auto& trace : m_traces) {
+            painter.setPen(trace.color);
+            painter.drawText(QRectF{plot.left() + c_label_padding, legend_y, plot.width(), font_height},
+                             Qt::AlignLeft | Qt::AlignTop, trace.name);
+            legend_y += font_height;
+        }
+    }
+} // namespace magnesia::activities::dataviewer::panels::trend_plot_panel
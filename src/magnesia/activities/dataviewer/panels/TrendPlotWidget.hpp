@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../../../opcua_qt/TimeSeries.hpp"
+#include "../../../opcua_qt/TimeSeriesStore.hpp"
+#include "../../../opcua_qt/abstraction/NodeId.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <QColor>
+#include <QString>
+#include <QWidget>
+#include <QtEvents>
+#include <qtmetamacros.h>
+
+namespace magnesia::activities::dataviewer::panels::trend_plot_panel {
+    /**
+     * @class TrendPlotWidget
+     * @brief Draws the recorded values of nodes over time.
+     *
+     * Each trace is decimated to one min/max bucket per horizontal pixel before drawing, so the cost of a repaint
+     * depends on the width of the widget and the number of traces, not on the number of samples.
+     */
+    class TrendPlotWidget : public QWidget {
+        Q_OBJECT
+
+      public:
+        /**
+         * @param store Store the values are taken from. Must outlive the widget.
+         * @param parent Parent of the widget.
+         */
+        explicit TrendPlotWidget(const opcua_qt::TimeSeriesStore* store, QWidget* parent = nullptr);
+
+        /**
+         * Adds a trace for a node. Nothing is drawn for it until its first numeric value has been recorded.
+         *
+         * @param node_id Node whose values are drawn.
+         * @param name Name shown in the legend.
+         * @return false if the node already has a trace.
+         */
+        bool addTrace(const opcua_qt::abstraction::NodeId& node_id, const QString& name);
+
+        /**
+         * Changes the name of a trace shown in the legend.
+         */
+        void setTraceName(const opcua_qt::abstraction::NodeId& node_id, const QString& name);
+
+        /**
+         * Removes all traces.
+         */
+        void clearTraces();
+
+        /**
+         * Adds values read from the history of a node to its trace. They are drawn beneath the recorded values and kept
+         * in a series of the store's capacity. Samples older than the newest history sample of the trace are dropped.
+         *
+         * @param node_id Node the values belong to. Nothing happens if the node has no trace.
+         * @param samples Values in chronological order.
+         */
+        void appendHistory(const opcua_qt::abstraction::NodeId& node_id,
+                           std::span<const opcua_qt::TimeSeries::Sample> samples);
+
+        /**
+         * Removes the history values of all traces.
+         */
+        void clearHistory();
+
+        /**
+         * Gets the nodes of all traces, in the order they were added.
+         */
+        [[nodiscard]] std::vector<opcua_qt::abstraction::NodeId> getTraces() const;
+
+        /**
+         * Sets the length of the visible time interval.
+         */
+        void setSpan(opcua_qt::TimeSeries::Duration span);
+
+        /**
+         * Gets the length of the visible time interval.
+         */
+        [[nodiscard]] opcua_qt::TimeSeries::Duration getSpan() const noexcept;
+
+        /**
+         * Follows the current time or freezes the visible time interval at its current end.
+         */
+        void setLive(bool live);
+
+        /**
+         * Checks if the plot follows the current time.
+         */
+        [[nodiscard]] bool isLive() const noexcept;
+
+        /**
+         * Sets the clock the end of the visible time interval follows while live.
+         *
+         * @param clock Returns the current time, e.g. the position of a replay. The system clock if empty.
+         */
+        void setClock(std::function<opcua_qt::TimeSeries::TimePoint()> clock);
+
+        /**
+         * Gets the end of the visible time interval.
+         */
+        [[nodiscard]] opcua_qt::TimeSeries::TimePoint getEnd() const;
+
+      protected:
+        void paintEvent(QPaintEvent* event) override;
+
+      private:
+        struct Trace {
+            opcua_qt::abstraction::NodeId node_id;
+            QString                       name;
+            QColor                        color;
+            // created on the first history value
+            std::unique_ptr<opcua_qt::TimeSeries> history;
+        };
+
+      private:
+        const opcua_qt::TimeSeriesStore* m_store;
+        std::vector<Trace>               m_traces;
+        opcua_qt::TimeSeries::Duration   m_span;
+        // end of the visible interval while not live
+        opcua_qt::TimeSeries::TimePoint  m_end{};
+        bool                             m_live{true};
+
+        // the system clock if empty
+        std::function<opcua_qt::TimeSeries::TimePoint()> m_clock;
+    };
+} // namespace magnesia::activities::dataviewer::panels::trend_plot_panel
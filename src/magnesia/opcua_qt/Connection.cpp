@@ -4,12 +4,24 @@
 #include "../qt_version_check.hpp"
 #include "ApplicationCertificate.hpp"
 #include "Logger.hpp"
+#include "NetworkThread.hpp"
+#include "SubscriptionManager.hpp"
 #include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
 #include "abstraction/Endpoint.hpp"
+#include "abstraction/NodeClass.hpp"
 #include "abstraction/NodeId.hpp"
 #include "abstraction/Subscription.hpp"
 #include "abstraction/node/Node.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -17,19 +29,26 @@
 #include <utility>
 #include <vector>
 
+#include <open62541/client.h>
+#include <open62541/nodeids.h>
 #include <open62541/types.h>
 #include <open62541pp/AccessControl.h>
 #include <open62541pp/Client.h>
 #include <open62541pp/Common.h>
 #include <open62541pp/ErrorHandling.h>
+#include <open62541pp/Logger.h>
 #include <open62541pp/types/Builtin.h>
+#include <open62541pp/types/DataValue.h>
 
 #include <QLoggingCategory>
+#include <QMetaObject>
 #include <QObject>
 #include <QSslCertificate>
-#include <QThreadPool>
+#include <QString>
+#include <QThread>
 #include <QTimer>
 #include <QUrl>
+#include <Qt>
 #include <qtmetamacros.h>
 
 #ifdef MAGNESIA_HAS_QT_6_5
@@ -41,6 +60,102 @@
 
 namespace {
     Q_LOGGING_CATEGORY(lc_opcua_connection, "magnesia.opcua.connection")
+
+    // roughly one frame, notifications posted in the meantime are run at once
+    constexpr std::chrono::milliseconds c_notification_interval{16};
+    // notifications run per frame at most, the rest waits for the next frame so the event loop keeps running
+    constexpr std::size_t               c_max_notifications_per_frame = 1024;
+
+    struct AsyncRequest {
+        magnesia::opcua_qt::Connection* connection;
+        const UA_DataType*              response_type;
+        std::function<void(void*)>      on_response;
+    };
+
+    std::shared_ptr<void> new_response(const UA_DataType* type, UA_StatusCode service_result) {
+        std::shared_ptr<void> response{UA_new(type), [type](void* ptr) { UA_delete(ptr, type); }};
+        // every response starts with its header
+        static_cast<UA_ResponseHeader*>(response.get())->serviceResult = service_result;
+        return response;
+    }
+
+    void post_response(std::shared_ptr<AsyncRequest> request, std::shared_ptr<void> response) {
+        auto* connection = request->connection;
+        connection->postNotification([request = std::move(request), response = std::move(response)] {
+            std::invoke(request->on_response, response.get());
+        });
+    }
+
+    // Called by the network thread with a response that is freed once this returns.
+    void on_async_response(UA_Client* /*client*/, void* userdata, UA_UInt32 /*request_id*/, void* response) {
+        std::shared_ptr<AsyncRequest> request{static_cast<AsyncRequest*>(userdata)};
+
+        auto response_copy = new_response(request->response_type, UA_STATUSCODE_GOOD);
+        if (response == nullptr) {
+            response_copy = new_response(request->response_type, UA_STATUSCODE_BADUNEXPECTEDERROR);
+        } else if (UA_copy(response, response_copy.get(), request->response_type) != UA_STATUSCODE_GOOD) {
+            response_copy = new_response(request->response_type, UA_STATUSCODE_BADOUTOFMEMORY);
+        }
+        post_response(std::move(request), std::move(response_copy));
+    }
+
+    opcua::BrowseResult to_browse_result(UA_StatusCode service_result, std::size_t results_size,
+                                         const UA_BrowseResult* results) {
+        if (service_result == UA_STATUSCODE_GOOD && results_size != 1) {
+            service_result = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (service_result != UA_STATUSCODE_GOOD) {
+            opcua::BrowseResult failed;
+            failed.handle()->statusCode = service_result;
+            return failed;
+        }
+        return opcua::BrowseResult{results[0]};
+    }
+
+    using AttributeToRead =
+        std::pair<magnesia::opcua_qt::abstraction::NodeId, magnesia::opcua_qt::abstraction::AttributeId>;
+
+    // Shallow copies, the node ids are owned by the caller.
+    std::vector<UA_ReadValueId> to_read_value_ids(std::span<const AttributeToRead> attributes) {
+        std::vector<UA_ReadValueId> nodes_to_read(attributes.size());
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            UA_ReadValueId_init(&nodes_to_read[i]);
+            nodes_to_read[i].nodeId      = *attributes[i].first.handle().handle();
+            nodes_to_read[i].attributeId = static_cast<UA_UInt32>(attributes[i].second);
+        }
+        return nodes_to_read;
+    }
+
+    // Shallow, the returned request references nodes_to_read.
+    UA_ReadRequest to_read_request(std::vector<UA_ReadValueId>& nodes_to_read) {
+        UA_ReadRequest request;
+        UA_ReadRequest_init(&request);
+        request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+        request.nodesToRead        = nodes_to_read.data();
+        request.nodesToReadSize    = nodes_to_read.size();
+        return request;
+    }
+
+    // Appends one DataValue per requested attribute. A failed service call fails every attribute of the request.
+    void append_read_results(const UA_ReadResponse& response, std::size_t requested,
+                             std::vector<magnesia::opcua_qt::abstraction::DataValue>& results) {
+        auto status = response.responseHeader.serviceResult;
+        if (status == UA_STATUSCODE_GOOD && response.resultsSize != requested) {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_connection)
+                << "Failed to read" << requested << "attributes:" << UA_StatusCode_name(status);
+            opcua::DataValue failed;
+            failed.handle()->hasStatus = true;
+            failed.handle()->status    = status;
+            results.insert(results.end(), requested, magnesia::opcua_qt::abstraction::DataValue{failed});
+            return;
+        }
+        for (std::size_t i = 0; i < response.resultsSize; ++i) {
+            results.emplace_back(opcua::DataValue{response.results[i]});
+        }
+    }
 } // namespace
 
 namespace magnesia::opcua_qt {
@@ -75,51 +190,89 @@ namespace magnesia::opcua_qt {
                            std::span<const QSslCertificate>             trust_list,
                            std::span<const QSslCertificate> revocation_list, Logger* logger, QObject* parent)
         : QObject(parent), m_client(constructClient(certificate, trust_list, revocation_list)),
-          m_server_endpoint(std::move(endpoint)), m_login(login) {
+          m_server_endpoint(std::move(endpoint)), m_login(login), m_logger(logger),
+          m_notification_timer(new QTimer(this)) {
         Q_ASSERT(logger != nullptr);
+        const auto retry_delay = Application::instance().getSettingsManager().getIntSetting(
+            {.name = "opcua_attribute_retry_delay", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(retry_delay);
+        m_attribute_retry_delay = std::chrono::seconds{retry_delay.value()};
+        m_subscription_manager  = new SubscriptionManager(this);
+
+        m_notification_timer->setSingleShot(true);
+        m_notification_timer->setInterval(c_notification_interval);
+        connect(m_notification_timer, &QTimer::timeout, this, &Connection::processNotifications);
+
+        // The client logs from whichever thread is using it, the Logger queues the entries for its own thread.
         m_client.setLogger(logger->getOPCUALogger());
     }
 
     Connection::~Connection() {
         close();
+        // the manager uses the client, which is destroyed before the children
+        delete m_subscription_manager;
     }
 
     void Connection::connectAndRun() {
-        if (m_client.isConnected()) {
-            return;
-        }
+        try {
+            const auto lock = lockClient();
+            // the network thread of a cancelled attempt might still be running
+            if (m_connecting || m_network_thread != nullptr || m_client.isConnected()) {
+                return;
+            }
 
-        Q_ASSERT(!m_client.isRunning());
+            Q_ASSERT(!m_client.isRunning());
 
-        try {
             m_client.setSecurityMode(static_cast<opcua::MessageSecurityMode>(m_server_endpoint.getSecurityMode()));
             if (m_login.has_value()) {
-                m_client.connect(m_server_endpoint.getEndpointUrl().toString().toStdString(), m_login.value());
-            } else {
-                m_client.connect(m_server_endpoint.getEndpointUrl().toString().toStdString());
+                opcua::throwIfBad(UA_ClientConfig_setAuthenticationUsername(
+                    UA_Client_getConfig(m_client.handle()), m_login->username.c_str(), m_login->password.c_str()));
             }
+            // Only starts the handshake, the network thread drives it to completion.
+            const auto url = m_server_endpoint.getEndpointUrl().toString().toStdString();
+            opcua::throwIfBad(UA_Client_connectAsync(m_client.handle(), url.c_str()));
+
+            m_connect_stage.reset();
+            m_connecting = true;
         } catch (const opcua::BadStatus& status) {
             qCWarning(lc_opcua_connection) << "Failed to connect to server:" << status.what();
+            Q_EMIT connectFailed(status.what());
             return;
         }
 
-        const auto interval = Application::instance().getSettingsManager().getIntSetting(
-            {.name = "opcua_poll_intervall", .domain = "general"});
-        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
-        Q_ASSERT(interval);
+        startNetworkThread();
+    }
 
-        m_timer.setInterval(static_cast<int>(interval.value()));
-        connect(&m_timer, &QTimer::timeout, this, [this] { m_client.runIterate(0); });
-        m_timer.start();
+    void Connection::cancelConnect() {
+        if (!m_connecting.exchange(false)) {
+            return;
+        }
+        // drops stage notifications of the aborted attempt that are still queued
+        ++m_connect_attempt;
+        if (m_network_thread == nullptr) {
+            close();
+            return;
+        }
+        // Joining the network thread here would block the caller until its current iteration is done.
+        connect(m_network_thread, &QThread::finished, this, [this] { close(); });
+        m_network_thread->quit();
+    }
 
-        Q_EMIT connected();
+    bool Connection::isConnecting() const noexcept {
+        return m_connecting;
     }
 
     QUrl Connection::getEndpointUrl() const noexcept {
         return m_server_endpoint.getEndpointUrl();
     }
 
+    Logger* Connection::getLogger() const noexcept {
+        return m_logger;
+    }
+
     std::optional<abstraction::Node*> Connection::getRootNode() {
+        const auto lock = lockClient();
         if (m_root_node == nullptr) {
             try {
                 m_root_node = abstraction::Node::fromOPCUANode(m_client.getRootNode(), this);
@@ -132,22 +285,76 @@ namespace magnesia::opcua_qt {
     }
 
     std::optional<abstraction::Node*> Connection::getNode(const abstraction::NodeId& node_id) {
-        if (auto node = m_nodes.find(node_id); node != m_nodes.end()) {
-            return node->second;
+        if (auto* node = findNode(node_id); node != nullptr) {
+            return node;
         }
+
+        const auto lock = lockClient();
         try {
-            return m_nodes[node_id] = abstraction::Node::fromOPCUANode(m_client.getNode(node_id.handle()), this);
+            // registers the node in the identity map
+            if (auto* node = abstraction::Node::fromOPCUANode(m_client.getNode(node_id.handle()), this);
+                node != nullptr) {
+                return node;
+            }
+            return std::nullopt;
         } catch (const opcua::BadStatus& status) {
             qCWarning(lc_opcua_connection) << "Failed to get node:" << status.what();
             return std::nullopt;
         }
     }
 
+    void Connection::getNodeAsync(const abstraction::NodeId&               node_id,
+                                  std::function<void(abstraction::Node*)> on_result) {
+        if (auto* node = findNode(node_id); node != nullptr) {
+            postNotification([node, on_result = std::move(on_result)] { on_result(node); });
+            return;
+        }
+
+        const std::pair<abstraction::NodeId, abstraction::AttributeId> node_class{node_id,
+                                                                                 abstraction::AttributeId::NODE_CLASS};
+        readAttributesAsync(std::span{&node_class, 1}, [this, node_id, on_result = std::move(on_result)](
+                                                           const std::vector<abstraction::DataValue>& values) {
+            const auto& value = values.front();
+            if (value.getStatusCode().handle().isBad()) {
+                qCWarning(lc_opcua_connection) << "Failed to get node:" << value.getStatusCode().toString();
+                on_result(nullptr);
+                return;
+            }
+            abstraction::Node* node{};
+            try {
+                if (const auto node_class = value.getValue().getScalar<abstraction::NodeClass>();
+                    node_class.has_value()) {
+                    const auto lock = lockClient();
+                    // registers the node in the identity map, unless it was created in the meantime
+                    node = abstraction::Node::fromNodeClass(m_client.getNode(node_id.handle()), *node_class, this);
+                }
+            } catch (const opcua::BadVariantAccess& error) {
+                qCWarning(lc_opcua_connection) << "Failed to get node:" << error.what();
+            }
+            on_result(node);
+        });
+    }
+
+    std::chrono::seconds Connection::getAttributeRetryDelay() const noexcept {
+        return m_attribute_retry_delay;
+    }
+
+    abstraction::Node* Connection::findNode(const abstraction::NodeId& node_id) const {
+        const auto node = m_nodes.find(node_id);
+        return node != m_nodes.end() ? node->second : nullptr;
+    }
+
+    void Connection::addNode(abstraction::Node* node) {
+        [[maybe_unused]] const bool inserted = m_nodes.emplace(node->getNodeId(), node).second;
+        Q_ASSERT(inserted && "Node created twice");
+    }
+
     abstraction::Subscription* Connection::createSubscription(abstraction::Node*                        node,
                                                               std::span<const abstraction::AttributeId> attribute_ids) {
+        const auto                 lock = lockClient();
         abstraction::Subscription* subscription{};
         try {
-            subscription = new abstraction::Subscription(m_client.createSubscription());
+            subscription = new abstraction::Subscription(m_client.createSubscription(), this);
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -167,10 +374,346 @@ namespace magnesia::opcua_qt {
         return subscription;
     }
 
+    SubscriptionManager* Connection::getSubscriptionManager() const noexcept {
+        return m_subscription_manager;
+    }
+
+    void Connection::readAttributesAsync(
+        std::span<const std::pair<abstraction::NodeId, abstraction::AttributeId>> attributes,
+        std::function<void(std::vector<abstraction::DataValue>)>                  on_result) {
+        std::optional<std::size_t> max_nodes;
+        {
+            const auto lock = lockClient();
+            max_nodes       = m_max_nodes_per_read;
+        }
+        if (!max_nodes.has_value()) {
+            // Learn the operation limit first, reading it synchronously would block the caller.
+            const std::pair<abstraction::NodeId, abstraction::AttributeId> limit{
+                abstraction::NodeId{
+                    opcua::NodeId{0, UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD}},
+                abstraction::AttributeId::VALUE,
+            };
+            sendReadRequest(std::span{&limit, 1},
+                            [this, attributes = std::vector(attributes.begin(), attributes.end()),
+                             on_result = std::move(on_result)](std::vector<abstraction::DataValue> values) mutable {
+                                setMaxNodesPerRead(values.front());
+                                readAttributesAsync(attributes, std::move(on_result));
+                            });
+            return;
+        }
+
+        if (attributes.empty()) {
+            postNotification([on_result = std::move(on_result)] { on_result({}); });
+            return;
+        }
+
+        const auto batch_size  = *max_nodes == 0 ? attributes.size() : *max_nodes;
+        const auto batch_count = (attributes.size() + batch_size - 1) / batch_size;
+
+        // Every batch is answered separately, the results are put back together in request order.
+        struct PendingRead {
+            std::vector<std::vector<abstraction::DataValue>>         batch_results;
+            std::size_t                                              remaining;
+            std::function<void(std::vector<abstraction::DataValue>)> on_result;
+        };
+        auto pending = std::make_shared<PendingRead>(PendingRead{
+            .batch_results = std::vector<std::vector<abstraction::DataValue>>(batch_count),
+            .remaining     = batch_count,
+            .on_result     = std::move(on_result),
+        });
+
+        for (std::size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+            const auto offset = batch_index * batch_size;
+            const auto batch  = attributes.subspan(offset, std::min(batch_size, attributes.size() - offset));
+            sendReadRequest(batch, [pending, batch_index](std::vector<abstraction::DataValue> values) {
+                pending->batch_results[batch_index] = std::move(values);
+                if (--pending->remaining != 0) {
+                    return;
+                }
+
+                std::vector<abstraction::DataValue> results;
+                for (auto& batch_results : pending->batch_results) {
+                    std::ranges::move(batch_results, std::back_inserter(results));
+                }
+                std::invoke(pending->on_result, std::move(results));
+            });
+        }
+    }
+
+    void Connection::browseAsync(const opcua::BrowseDescription& description, std::uint32_t max_references,
+                                 std::function<void(opcua::BrowseResult)> on_result) {
+        UA_BrowseRequest request;
+        UA_BrowseRequest_init(&request);
+        request.requestedMaxReferencesPerNode = max_references;
+        // shallow, the description is owned by the caller
+        request.nodesToBrowse     = const_cast<UA_BrowseDescription*>(description.handle());
+        request.nodesToBrowseSize = 1;
+
+        sendAsyncRequest(&request, UA_TYPES[UA_TYPES_BROWSEREQUEST], UA_TYPES[UA_TYPES_BROWSERESPONSE],
+                         [on_result = std::move(on_result)](void* response) {
+                             const auto* browse_response = static_cast<UA_BrowseResponse*>(response);
+                             on_result(to_browse_result(browse_response->responseHeader.serviceResult,
+                                                        browse_response->resultsSize, browse_response->results));
+                         });
+    }
+
+    void Connection::browseNextAsync(const opcua::ByteString& continuation_point, bool release,
+                                     std::function<void(opcua::BrowseResult)> on_result) {
+        UA_BrowseNextRequest request;
+        UA_BrowseNextRequest_init(&request);
+        request.releaseContinuationPoints = release;
+        // shallow, the continuation point is owned by the caller
+        request.continuationPoints     = const_cast<UA_ByteString*>(continuation_point.handle());
+        request.continuationPointsSize = 1;
+
+        sendAsyncRequest(&request, UA_TYPES[UA_TYPES_BROWSENEXTREQUEST], UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE],
+                         [on_result = std::move(on_result)](void* response) {
+                             const auto* browse_response = static_cast<UA_BrowseNextResponse*>(response);
+                             on_result(to_browse_result(browse_response->responseHeader.serviceResult,
+                                                        browse_response->resultsSize, browse_response->results));
+                         });
+    }
+
+    void Connection::historyReadAsync(const UA_ExtensionObject& details, const abstraction::NodeId& node_id,
+                                      const opcua::ByteString& continuation_point, bool release,
+                                      std::function<void(const UA_HistoryReadResult&)> on_result) {
+        // shallow, everything is owned by the caller
+        UA_HistoryReadValueId node_to_read;
+        UA_HistoryReadValueId_init(&node_to_read);
+        node_to_read.nodeId            = *node_id.handle().handle();
+        node_to_read.continuationPoint = *continuation_point.handle();
+
+        UA_HistoryReadRequest request;
+        UA_HistoryReadRequest_init(&request);
+        request.historyReadDetails        = details;
+        request.timestampsToReturn        = UA_TIMESTAMPSTORETURN_BOTH;
+        request.releaseContinuationPoints = release;
+        request.nodesToRead               = &node_to_read;
+        request.nodesToReadSize           = 1;
+
+        sendAsyncRequest(&request, UA_TYPES[UA_TYPES_HISTORYREADREQUEST], UA_TYPES[UA_TYPES_HISTORYREADRESPONSE],
+                         [on_result = std::move(on_result)](void* response) {
+                             const auto* history_response = static_cast<UA_HistoryReadResponse*>(response);
+                             UA_HistoryReadResult result;
+                             UA_HistoryReadResult_init(&result);
+                             result.statusCode = history_response->responseHeader.serviceResult;
+                             if (result.statusCode == UA_STATUSCODE_GOOD && history_response->resultsSize != 1) {
+                                 result.statusCode = UA_STATUSCODE_BADUNEXPECTEDERROR;
+                             }
+                             // shallow, the response outlives the call
+                             on_result(result.statusCode == UA_STATUSCODE_GOOD ? history_response->results[0]
+                                                                               : result);
+                         });
+    }
+
+    void Connection::sendReadRequest(
+        std::span<const std::pair<abstraction::NodeId, abstraction::AttributeId>> attributes,
+        std::function<void(std::vector<abstraction::DataValue>)>                  on_result) {
+        auto                 nodes_to_read = to_read_value_ids(attributes);
+        const UA_ReadRequest request       = to_read_request(nodes_to_read);
+
+        sendAsyncRequest(&request, UA_TYPES[UA_TYPES_READREQUEST], UA_TYPES[UA_TYPES_READRESPONSE],
+                         [requested = attributes.size(), on_result = std::move(on_result)](void* response) {
+                             std::vector<abstraction::DataValue> results;
+                             results.reserve(requested);
+                             append_read_results(*static_cast<UA_ReadResponse*>(response), requested, results);
+                             on_result(std::move(results));
+                         });
+    }
+
+    void Connection::sendAsyncRequest(const void* request, const UA_DataType& request_type,
+                                      const UA_DataType& response_type, std::function<void(void*)> on_response) {
+        auto* context = new AsyncRequest{this, &response_type, std::move(on_response)};
+
+        const auto lock = lockClient();
+        // The request is encoded right away. If sending succeeded, the callback is called exactly once, also when the
+        // client disconnects before the response arrived.
+        const auto status = __UA_Client_AsyncService(m_client.handle(), request, &request_type, on_async_response,
+                                                     &response_type, context, nullptr);
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_connection) << "Failed to send request:" << UA_StatusCode_name(status);
+            post_response(std::shared_ptr<AsyncRequest>{context}, new_response(&response_type, status));
+        }
+    }
+
+    std::size_t Connection::getMaxMonitoredItemsPerCall() {
+        return readOperationLimit(m_max_monitored_items_per_call,
+                                  UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXMONITOREDITEMSPERCALL,
+                                  "MaxMonitoredItemsPerCall");
+    }
+
+    std::size_t Connection::readOperationLimit(std::optional<std::size_t>& limit, std::uint32_t node_id,
+                                               const char* name) {
+        const auto lock = lockClient();
+        if (!limit.has_value()) {
+            try {
+                limit = m_client.getNode({0, node_id}).readValueScalar<std::uint32_t>();
+            } catch (const opcua::BadStatus& status) {
+                // the operation limits are optional
+                qCDebug(lc_opcua_connection) << "Failed to read" << name << "operation limit:" << status.what();
+                limit = 0;
+            }
+        }
+        return *limit;
+    }
+
+    void Connection::setMaxNodesPerRead(const abstraction::DataValue& value) {
+        const auto lock = lockClient();
+        if (m_max_nodes_per_read.has_value()) {
+            return;
+        }
+
+        // the operation limits are optional
+        m_max_nodes_per_read = 0;
+        if (value.getStatusCode().handle().isBad()) {
+            qCDebug(lc_opcua_connection) << "Failed to read MaxNodesPerRead:" << value.getStatusCode().toString();
+            return;
+        }
+        try {
+            m_max_nodes_per_read = value.getValue().getScalar<std::uint32_t>().value_or(0);
+        } catch (const opcua::BadVariantAccess& error) {
+            qCDebug(lc_opcua_connection) << "Failed to read MaxNodesPerRead:" << error.what();
+        }
+    }
+
     void Connection::close() {
-        m_timer.stop();
-        m_client.stop();
-        m_client.disconnect();
+        stopNetworkThread();
+
+        {
+            const auto lock = lockClient();
+            m_client.stop();
+            m_client.disconnect();
+            m_max_nodes_per_read.reset();
+            m_max_monitored_items_per_call.reset();
+        }
+        m_connecting = false;
         Q_EMIT disconnected();
     }
+
+    UA_Client* Connection::getClientHandle() noexcept {
+        return m_client.handle();
+    }
+
+    std::unique_lock<std::recursive_mutex> Connection::lockClient() {
+        ++m_client_waiters;
+        std::unique_lock lock{m_client_mutex};
+        if (--m_client_waiters == 0) {
+            m_client_waiters.notify_all();
+        }
+        return lock;
+    }
+
+    void Connection::postNotification(std::function<void()> notification) {
+        m_notifications.push(std::move(notification));
+        // Coalesce wake-ups: only the first notification after a drain schedules a new one.
+        if (!m_notifications_scheduled.exchange(true, std::memory_order_acq_rel)) {
+            QMetaObject::invokeMethod(this, &Connection::scheduleNotifications, Qt::QueuedConnection);
+        }
+    }
+
+    void Connection::scheduleNotifications() {
+        if (!m_notification_timer->isActive()) {
+            m_notification_timer->start();
+        }
+    }
+
+    void Connection::updateConnectStage() {
+        if (!m_connecting) {
+            return;
+        }
+
+        UA_SecureChannelState channel_state{};
+        UA_SessionState       session_state{};
+        UA_StatusCode         connect_status{};
+        UA_Client_getState(m_client.handle(), &channel_state, &session_state, &connect_status);
+
+        const auto attempt = m_connect_attempt.load();
+        if (connect_status != UA_STATUSCODE_GOOD) {
+            m_connecting = false;
+            postNotification([this, attempt, reason = QString{UA_StatusCode_name(connect_status)}] {
+                if (attempt != m_connect_attempt) {
+                    return;
+                }
+                qCWarning(lc_opcua_connection) << "Failed to connect to server:" << reason;
+                close();
+                Q_EMIT connectFailed(reason);
+            });
+            return;
+        }
+
+        std::optional<ConnectStage> stage;
+        if (session_state == UA_SESSIONSTATE_ACTIVATED) {
+            stage = ConnectStage::ACTIVATED;
+        } else if (session_state == UA_SESSIONSTATE_CREATED || session_state == UA_SESSIONSTATE_ACTIVATE_REQUESTED) {
+            stage = ConnectStage::SESSION;
+        } else if (channel_state == UA_SECURECHANNELSTATE_OPEN) {
+            stage = ConnectStage::SECURE_CHANNEL;
+        } else if (channel_state >= UA_SECURECHANNELSTATE_HEL_SENT && channel_state != UA_SECURECHANNELSTATE_CLOSING) {
+            // the HEL message is only sent once the TCP connection is established
+            stage = ConnectStage::TCP;
+        }
+        if (!stage.has_value() || stage <= m_connect_stage) {
+            return;
+        }
+
+        // A single iteration can complete several stages, report every one of them.
+        const int first = m_connect_stage.has_value() ? qToUnderlying(*m_connect_stage) + 1 : 0;
+        for (int reached = first; reached <= qToUnderlying(*stage); ++reached) {
+            postNotification([this, attempt, reached = static_cast<ConnectStage>(reached)] {
+                if (attempt == m_connect_attempt) {
+                    Q_EMIT connectStageReached(reached);
+                }
+            });
+        }
+        m_connect_stage = stage;
+
+        if (stage == ConnectStage::ACTIVATED) {
+            m_connecting = false;
+            postNotification([this, attempt] {
+                if (attempt == m_connect_attempt) {
+                    Q_EMIT connected();
+                }
+            });
+        }
+    }
+
+    void Connection::startNetworkThread() {
+        const auto interval = Application::instance().getSettingsManager().getIntSetting(
+            {.name = "opcua_poll_intervall", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(interval);
+
+        Q_ASSERT(m_network_thread == nullptr);
+        m_network_thread =
+            new NetworkThread(m_client, m_client_mutex, m_client_waiters, std::chrono::milliseconds{interval.value()},
+                              [this] {
+                                  updateConnectStage();
+                                  m_subscription_manager->flushDataChanges();
+                              },
+                              this);
+        m_network_thread->start();
+    }
+
+    void Connection::stopNetworkThread() {
+        // the destructor stops the thread
+        delete m_network_thread;
+        m_network_thread = nullptr;
+    }
+
+    void Connection::processNotifications() {
+        // Pairs with the exchange in postNotification. Producers that still saw the flag set didn't schedule a drain,
+        // their pushes happen before this exchange and are seen below. Later ones schedule the next frame.
+        m_notifications_scheduled.exchange(false, std::memory_order_acq_rel);
+        for (std::size_t count = 0; count < c_max_notifications_per_frame; ++count) {
+            auto notification = m_notifications.tryPop();
+            if (!notification.has_value()) {
+                return;
+            }
+            std::invoke(*notification);
+        }
+        // a sustained stream is spread over several frames
+        if (!m_notifications.empty()) {
+            scheduleNotifications();
+        }
+    }
 } // namespace magnesia::opcua_qt
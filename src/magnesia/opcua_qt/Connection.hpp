@@ -2,22 +2,39 @@
 
 #include "ApplicationCertificate.hpp"
 #include "Logger.hpp"
+#include "MpscQueue.hpp"
+#include "NetworkThread.hpp"
+#include "SubscriptionManager.hpp"
 #include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
 #include "abstraction/Endpoint.hpp"
 #include "abstraction/NodeId.hpp"
 #include "abstraction/Subscription.hpp"
 #include "abstraction/node/Node.hpp"
 #include "qt_version_check.hpp"
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <optional>
 #include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <open62541/client.h>
+#include <open62541/types.h>
 #include <open62541pp/AccessControl.h>
 #include <open62541pp/Client.h>
+#include <open62541pp/types/Builtin.h>
+#include <open62541pp/types/Composed.h>
 
 #include <QObject>
 #include <QSslCertificate>
+#include <QString>
 #include <QTimer>
 #include <QUrl>
 #include <qtmetamacros.h>
@@ -38,6 +55,21 @@ namespace magnesia::opcua_qt {
         Q_DISABLE_COPY_MOVE(Connection)
 
       public:
+        /**
+         * @brief Stages of establishing a connection, in the order they are reached.
+         */
+        enum class ConnectStage : std::uint8_t {
+            /// The TCP connection to the server is established.
+            TCP,
+            /// The secure channel is opened.
+            SECURE_CHANNEL,
+            /// The session is created.
+            SESSION,
+            /// The session is activated, the connection can be used.
+            ACTIVATED,
+        };
+        Q_ENUM(ConnectStage)
+
         ~Connection() override;
         /**
          * @brief Constructor for a Connection.
@@ -48,7 +80,7 @@ namespace magnesia::opcua_qt {
          * @param certificate the optional certificate
          * @param trust_list list of trusted certificates
          * @param revocation_list Certificate revocation lists (CRL)
-         * @param logger the logger to use
+         * @param logger the logger to use, must outlive the connection
          * @param parent the QObject parent for this connection (should be the connection manager)
          *
          * trust_list and revocation_list have no effect if there is no client certificate.
@@ -58,18 +90,37 @@ namespace magnesia::opcua_qt {
                    std::span<const QSslCertificate> trust_list, std::span<const QSslCertificate> revocation_list,
                    Logger* logger, QObject* parent = nullptr);
         /**
-         * @brief Connects the underlying OPC UA client and poll for subscription updates asynchronously. The signal
-         * connected gets emitted when the connection has been established.
+         * @brief Starts connecting the underlying OPC UA client and the network thread driving it. Returns immediately,
+         * the handshake is done by the network thread.
          *
-         * Don't do anything when the connection has already been established
+         * The signal connectStageReached gets emitted for every stage of the handshake, followed by connected once the
+         * connection has been established. connectFailed is emitted instead if the handshake fails.
+         *
+         * Don't do anything when the connection has already been established or is being established.
          */
         void connectAndRun();
+        /**
+         * @brief Aborts a connection attempt started by connectAndRun.
+         *
+         * Don't do anything when no connection attempt is in progress. Neither connected nor connectFailed gets emitted
+         * for the aborted attempt. The network thread is only asked to stop, the connection is closed once it finished
+         * and disconnected gets emitted then.
+         */
+        void cancelConnect();
+        /**
+         * @brief Checks if a connection attempt is in progress.
+         */
+        [[nodiscard]] bool isConnecting() const noexcept;
         /**
          * @brief gets the endpoint url with which the connection is connected
          *
          * @return a the endpoint's url
          */
         [[nodiscard]] QUrl getEndpointUrl() const noexcept;
+        /**
+         * @brief Gets the logger the client of the connection logs to
+         */
+        [[nodiscard]] Logger* getLogger() const noexcept;
         /**
          * @brief Returns the Root Node from the server
          *
@@ -84,6 +135,35 @@ namespace magnesia::opcua_qt {
          * @return Returns a Node Wrapper or nullopt if an error occurs
          */
         [[nodiscard]] std::optional<abstraction::Node*> getNode(const abstraction::NodeId& node_id);
+        /**
+         * @brief Gets a Node from a NodeId without blocking. Returns immediately.
+         *
+         * Unknown nodes are created once their node class has been read, the node class of the Node is cached.
+         *
+         * @param node_id NodeId that points to a Node
+         * @param on_result called on the thread this Connection lives in with the Node or nullptr if an error occurs
+         */
+        void getNodeAsync(const abstraction::NodeId& node_id, std::function<void(abstraction::Node*)> on_result);
+        /**
+         * @brief Gets the Node with the given NodeId if it has been created already. Doesn't access the server.
+         *
+         * Every server node has at most one Node object per connection. Must only be used on the thread this
+         * Connection lives in.
+         *
+         * @param node_id NodeId that points to a Node
+         *
+         * @return the Node or nullptr if there is none yet
+         */
+        [[nodiscard]] abstraction::Node* findNode(const abstraction::NodeId& node_id) const;
+        /**
+         * @brief Registers a newly created Node, so findNode returns it from now on.
+         *
+         * Called by the Node factory methods, which look up existing nodes with findNode first. Must only be used on
+         * the thread this Connection lives in.
+         *
+         * @param node the new node, owned by this connection
+         */
+        void addNode(abstraction::Node* node);
         /**
          * @brief Creates a Subscription Object
          *
@@ -95,21 +175,160 @@ namespace magnesia::opcua_qt {
         [[nodiscard]] abstraction::Subscription*
         createSubscription(abstraction::Node* node, std::span<const abstraction::AttributeId> attribute_ids);
         /**
-         * @brief Stops polling for updates and disconnects the client
+         * @brief Gets the manager packing all monitored items of this connection into shared subscriptions.
+         */
+        [[nodiscard]] SubscriptionManager* getSubscriptionManager() const noexcept;
+        /**
+         * @brief Reads attributes of nodes without blocking. Returns immediately.
+         *
+         * The reads are split into as few requests as the server's MaxNodesPerRead operation limit allows.
+         *
+         * @param attributes the nodes and attributes to read
+         * @param on_result called on the thread this Connection lives in with one DataValue per requested attribute,
+         *                  in the same order. Failed reads have a bad status code.
+         */
+        void readAttributesAsync(std::span<const std::pair<abstraction::NodeId, abstraction::AttributeId>> attributes,
+                                 std::function<void(std::vector<abstraction::DataValue>)>                  on_result);
+        /**
+         * @brief Browses the references of a node without blocking. Returns immediately.
+         *
+         * @param description what to browse
+         * @param max_references maximum number of references in the result, 0 for no limit. If there are more, the
+         *                       result contains a continuation point for browseNextAsync.
+         * @param on_result called with the result on the thread this Connection lives in
+         */
+        void browseAsync(const opcua::BrowseDescription& description, std::uint32_t max_references,
+                         std::function<void(opcua::BrowseResult)> on_result);
+        /**
+         * @brief Continues a browse started with browseAsync without blocking. Returns immediately.
+         *
+         * @param continuation_point the continuation point of the previous result
+         * @param release release the continuation point instead of browsing further
+         * @param on_result called with the result on the thread this Connection lives in
+         */
+        void browseNextAsync(const opcua::ByteString& continuation_point, bool release,
+                             std::function<void(opcua::BrowseResult)> on_result);
+        /**
+         * @brief Reads a page of the history of a node without blocking. Returns immediately.
+         *
+         * @param details the ReadRawModifiedDetails or ReadProcessedDetails of the read
+         * @param node_id the node to read the history of
+         * @param continuation_point the continuation point of the previous page, empty for the first page
+         * @param release release the continuation point instead of reading further
+         * @param on_result called with the result on the thread this Connection lives in. The result is freed after
+         *                  the call, so a page of values never has to be copied.
+         *
+         * @see HistoryRead
+         */
+        void historyReadAsync(const UA_ExtensionObject& details, const abstraction::NodeId& node_id,
+                              const opcua::ByteString& continuation_point, bool release,
+                              std::function<void(const UA_HistoryReadResult&)> on_result);
+        /**
+         * @brief Stops the network thread and disconnects the client
          */
         void close();
+        /**
+         * @brief Gets how long an attribute that failed to be read with a transient error isn't read again.
+         *
+         * @see abstraction::Node::getAttributeFailure
+         */
+        [[nodiscard]] std::chrono::seconds getAttributeRetryDelay() const noexcept;
+        /**
+         * @brief Locks the underlying client for exclusive use by the calling thread.
+         *
+         * The client is driven by a network thread. Every access to the client or to anything referencing it (nodes,
+         * subscriptions, monitored items) has to hold this lock. The lock is recursive. Callers waiting for the lock
+         * take precedence over the next iteration of the network thread.
+         *
+         * @return the held lock
+         */
+        [[nodiscard]] std::unique_lock<std::recursive_mutex> lockClient();
+        /**
+         * @brief Gets the underlying client for services not wrapped by this class. The client needs to be locked
+         * while using it.
+         *
+         * @see lockClient
+         */
+        [[nodiscard]] UA_Client* getClientHandle() noexcept;
+        /**
+         * @brief Returns the maximum number of monitored items per CreateMonitoredItems or DeleteMonitoredItems
+         * request supported by the server, 0 if unlimited.
+         */
+        [[nodiscard]] std::size_t getMaxMonitoredItemsPerCall();
+        /**
+         * @brief Queues a function to be run on the thread this Connection lives in.
+         *
+         * Safe to call from any thread, never blocks. Used to hand notifications and results from the network thread
+         * to the Qt models. The queued functions are run in order, at most once per frame and a bounded number per
+         * frame, so a sustained stream of notifications doesn't block the event loop.
+         *
+         * @param notification the function to run
+         */
+        void postNotification(std::function<void()> notification);
 
       signals:
+        /**
+         * @brief Gets emitted when a stage of the handshake has been completed
+         *
+         * @param stage the completed stage
+         */
+        void connectStageReached(magnesia::opcua_qt::Connection::ConnectStage stage);
         /**
          * @brief Gets emitted if the connection is connected
          */
         void connected();
+        /**
+         * @brief Gets emitted if a connection attempt failed
+         *
+         * @param reason human readable description of the failure
+         */
+        void connectFailed(const QString& reason);
         /**
          * @brief Gets emitted if the connection is disconnected
          */
         void disconnected();
 
+      private slots:
+        // starts the notification timer, in the Connection's thread
+        void scheduleNotifications();
+        void processNotifications();
+
       private:
+        /**
+         * @brief Reports the progress of a connection attempt. Called by the network thread after every iteration.
+         */
+        void updateConnectStage();
+        void startNetworkThread();
+        void stopNetworkThread();
+        /**
+         * @brief Reads an optional operation limit of the server unless it is already known, 0 if unlimited.
+         *
+         * @param limit the cached limit
+         * @param node_id numeric id of the limit's node in namespace 0
+         * @param name name of the limit, used for logging
+         */
+        std::size_t readOperationLimit(std::optional<std::size_t>& limit, std::uint32_t node_id, const char* name);
+        /**
+         * @brief Stores the MaxNodesPerRead operation limit read by readAttributesAsync, unless it is already known.
+         */
+        void setMaxNodesPerRead(const abstraction::DataValue& value);
+        /**
+         * @brief Sends a single Read request without blocking, regardless of the server's operation limits.
+         */
+        void sendReadRequest(std::span<const std::pair<abstraction::NodeId, abstraction::AttributeId>> attributes,
+                             std::function<void(std::vector<abstraction::DataValue>)>                  on_result);
+        /**
+         * @brief Sends a service request that is answered asynchronously through the network thread.
+         *
+         * @param request the request, of type request_type
+         * @param request_type data type of the request
+         * @param response_type data type of the response
+         * @param on_response called with the response on the thread this Connection lives in. The response is of
+         *                    type response_type and is freed after the call.
+         */
+        void sendAsyncRequest(const void* request, const UA_DataType& request_type, const UA_DataType& response_type,
+                              std::function<void(void*)> on_response);
+
         static opcua::Client constructClient(const std::optional<ApplicationCertificate>& certificate,
                                              std::span<const QSslCertificate>             trust_list,
                                              std::span<const QSslCertificate>             revocation_list);
@@ -118,9 +337,29 @@ namespace magnesia::opcua_qt {
         opcua::Client               m_client;
         opcua_qt::Endpoint          m_server_endpoint;
         std::optional<opcua::Login> m_login;
-        QTimer                      m_timer;
+        Logger*                     m_logger;
+        std::recursive_mutex        m_client_mutex;
+        std::atomic<std::size_t>    m_client_waiters{0};
+        NetworkThread*              m_network_thread{nullptr};
+
+        MpscQueue<std::function<void()>> m_notifications;
+        std::atomic_bool                 m_notifications_scheduled{false};
+        QTimer*                          m_notification_timer;
+
+        std::atomic_bool           m_connecting{false};
+        std::atomic<std::uint64_t> m_connect_attempt{0};
+        // only used by the network thread while connecting
+        std::optional<ConnectStage> m_connect_stage;
+
+        // read from the server on first use
+        std::optional<std::size_t> m_max_nodes_per_read;
+        std::optional<std::size_t> m_max_monitored_items_per_call;
+        std::chrono::seconds       m_attribute_retry_delay{};
+
+        SubscriptionManager* m_subscription_manager{nullptr};
 
-        abstraction::Node*                                m_root_node{};
-        std::map<abstraction::NodeId, abstraction::Node*> m_nodes;
+        abstraction::Node* m_root_node{};
+        // the identity map, every Node of this connection is registered here
+        std::unordered_map<abstraction::NodeId, abstraction::Node*> m_nodes;
     };
 } // namespace magnesia::opcua_qt
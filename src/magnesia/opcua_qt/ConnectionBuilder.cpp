@@ -50,11 +50,6 @@ namespace magnesia::opcua_qt {
         return *this;
     }
 
-    ConnectionBuilder& ConnectionBuilder::logger(Logger* logger) noexcept {
-        m_logger = logger;
-        return *this;
-    }
-
     ConnectionBuilder& ConnectionBuilder::username(const QString& username) noexcept {
         m_username = username;
         return *this;
@@ -85,7 +80,7 @@ namespace magnesia::opcua_qt {
     }
 
     Connection* ConnectionBuilder::build() {
-        if (!m_endpoint.has_value() || m_logger == nullptr) {
+        if (!m_endpoint.has_value()) {
             return nullptr;
         }
 
@@ -128,7 +123,12 @@ namespace magnesia::opcua_qt {
             return nullptr;
         }
 
-        return new Connection(m_endpoint.value(), login, app_cert, trust_list, revoked_list, m_logger);
+        // A failed attempt deletes its connection and logger, a retry must not reuse them.
+        auto* logger     = new Logger;
+        auto* connection = new Connection(m_endpoint.value(), login, app_cert, trust_list, revoked_list, logger);
+        // The client of the connection logs until it is destroyed, after the destructor of the connection ran.
+        logger->setParent(connection);
+        return connection;
     }
 
     opcua::Result<std::vector<Endpoint>> ConnectionBuilder::findEndopintsSynchronously() {
@@ -154,10 +154,6 @@ namespace magnesia::opcua_qt {
         return m_endpoint;
     }
 
-    Logger* ConnectionBuilder::getLogger() const {
-        return m_logger;
-    }
-
     const std::optional<QString>& ConnectionBuilder::getUsername() const {
         return m_username;
     }
@@ -2,7 +2,6 @@
 
 #include "../database_types.hpp"
 #include "Connection.hpp"
-#include "Logger.hpp"
 #include "abstraction/Endpoint.hpp"
 
 #include <mutex>
@@ -48,16 +47,6 @@ namespace magnesia::opcua_qt {
          * @param endpoint an Endpoint to connect to
          */
         ConnectionBuilder& endpoint(const Endpoint& endpoint) noexcept;
-        /**
-         * @brief Sets the logger to use for the connection.
-         *
-         * This function may be called only once.
-         *
-         * This is mandatory for a connection.
-         *
-         * @param logger a Logger method given to the connection
-         */
-        ConnectionBuilder& logger(Logger* logger) noexcept;
         /**
          * @brief Sets the username
          * Only if both a username and a password are provided, login with password and username is done.
@@ -104,14 +93,14 @@ namespace magnesia::opcua_qt {
         ConnectionBuilder& revokedList(const std::vector<StorageId>& revoked_list) noexcept;
 
         /**
-         * @brief creates a connection from this builder by consuming the builder
+         * @brief creates a connection from this builder
          *
-         * The endpoint and logger need to be set.
+         * The endpoint needs to be set.
          *
-         * This function may be called only once.
+         * Every connection gets a new Logger owned by it, see Connection::getLogger. This function may be called again
+         * after a connection attempt failed.
          *
          * @see ConnectionBuilder::endpoint()
-         * @see ConnectionBuilder::logger()
          */
         Connection* build();
         /**
@@ -139,11 +128,6 @@ namespace magnesia::opcua_qt {
          */
         [[nodiscard]] const std::optional<Endpoint>& getEndpoint() const;
 
-        /**
-         * @return Retrieves the logger.
-         */
-        [[nodiscard]] Logger* getLogger() const;
-
         /**
          * @return Retrieves the username if it exists, nullopt if not.
          */
@@ -181,7 +165,6 @@ namespace magnesia::opcua_qt {
       private:
         std::optional<QUrl>      m_url;
         std::optional<Endpoint>  m_endpoint;
-        Logger*                  m_logger{nullptr};
         std::optional<QString>   m_username;
         std::optional<QString>   m_password;
         std::optional<StorageId> m_certificate;
@@ -0,0 +1,186 @@
+#include "HistoryRead.hpp"
+
+#include "Connection.hpp"
+#include "TimeSeries.hpp"
+#include "TimeSeriesStore.hpp"
+#include "abstraction/NodeId.hpp"
+#include "abstraction/StatusCode.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <open62541/types.h>
+#include <open62541/types_generated.h>
+#include <open62541pp/ErrorHandling.h>
+#include <open62541pp/types/Builtin.h>
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QPointer>
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_history_read, "magnesia.opcua.history_read")
+
+    UA_DateTime to_date_time(magnesia::opcua_qt::TimeSeries::TimePoint time) {
+        return time.time_since_epoch().count() * UA_DATETIME_USEC + UA_DATETIME_UNIX_EPOCH;
+    }
+
+    template<typename Details>
+    std::shared_ptr<UA_ExtensionObject> make_details(const Details& details, const UA_DataType& type) {
+        std::shared_ptr<UA_ExtensionObject> extension_object{
+            UA_ExtensionObject_new(), [](UA_ExtensionObject* ptr) { UA_ExtensionObject_delete(ptr); }};
+        // deep copy, the details may point to memory owned by the caller
+        opcua::throwIfBad(UA_ExtensionObject_setValueCopy(extension_object.get(), &details, &type));
+        return extension_object;
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    using abstraction::NodeId;
+    using abstraction::StatusCode;
+
+    HistoryRead::HistoryRead(Connection* connection, NodeId node_id, std::shared_ptr<UA_ExtensionObject> details,
+                             QObject* parent)
+        : QObject(parent), m_connection(connection), m_node_id(std::move(node_id)), m_details(std::move(details)) {}
+
+    HistoryRead* HistoryRead::readRaw(Connection* connection, const NodeId& node_id, TimeSeries::TimePoint start,
+                                      TimeSeries::TimePoint end, std::uint32_t values_per_page, QObject* parent) {
+        UA_ReadRawModifiedDetails details;
+        UA_ReadRawModifiedDetails_init(&details);
+        details.isReadModified   = false;
+        details.startTime        = to_date_time(start);
+        details.endTime          = to_date_time(end);
+        details.numValuesPerNode = values_per_page;
+        details.returnBounds     = false;
+
+        auto* read = new HistoryRead(connection, node_id,
+                                     make_details(details, UA_TYPES[UA_TYPES_READRAWMODIFIEDDETAILS]), parent);
+        read->requestPage();
+        return read;
+    }
+
+    HistoryRead* HistoryRead::readProcessed(Connection* connection, const NodeId& node_id,
+                                            TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                            TimeSeries::Duration processing_interval, const NodeId& aggregate_type,
+                                            QObject* parent) {
+        UA_ReadProcessedDetails details;
+        UA_ReadProcessedDetails_init(&details);
+        details.startTime          = to_date_time(start);
+        details.endTime            = to_date_time(end);
+        details.processingInterval = std::chrono::duration<double, std::milli>{processing_interval}.count();
+        // shallow, make_details copies
+        details.aggregateType     = const_cast<UA_NodeId*>(aggregate_type.handle().handle());
+        details.aggregateTypeSize = 1;
+        details.aggregateConfiguration.useServerCapabilitiesDefaults = true;
+
+        auto* read = new HistoryRead(connection, node_id,
+                                     make_details(details, UA_TYPES[UA_TYPES_READPROCESSEDDETAILS]), parent);
+        read->requestPage();
+        return read;
+    }
+
+    HistoryRead::~HistoryRead() {
+        cancel();
+    }
+
+    const NodeId& HistoryRead::getNodeId() const noexcept {
+        return m_node_id;
+    }
+
+    void HistoryRead::cancel() {
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        // A page in flight releases its own continuation point once it arrives. A closed connection released them all.
+        if (!m_requested && !m_continuation_point.empty() && !m_connection.isNull()) {
+            // continuation points are a limited resource on the server
+            m_connection->historyReadAsync(*m_details, m_node_id, m_continuation_point, true,
+                                           [](const UA_HistoryReadResult&) {});
+        }
+        m_continuation_point = {};
+    }
+
+    bool HistoryRead::isFinished() const noexcept {
+        return m_finished;
+    }
+
+    std::size_t HistoryRead::getSampleCount() const noexcept {
+        return m_sample_count;
+    }
+
+    std::size_t HistoryRead::getSkippedCount() const noexcept {
+        return m_skipped_count;
+    }
+
+    void HistoryRead::requestPage() {
+        m_requested = true;
+        m_connection->historyReadAsync(
+            *m_details, m_node_id, m_continuation_point, false,
+            [read = QPointer{this}, connection = m_connection, node_id = m_node_id,
+             details = m_details](const UA_HistoryReadResult& result) {
+                if (!read.isNull() && !read->m_finished) {
+                    read->onPage(result);
+                    return;
+                }
+                // cancelled while the page was requested
+                if (result.continuationPoint.length != 0 && !connection.isNull()) {
+                    connection->historyReadAsync(*details, node_id, opcua::ByteString{result.continuationPoint}, true,
+                                                 [](const UA_HistoryReadResult&) {});
+                }
+            });
+    }
+
+    void HistoryRead::onPage(const UA_HistoryReadResult& result) {
+        m_requested = false;
+        if (UA_StatusCode_isBad(result.statusCode)) {
+            qCWarning(lc_opcua_history_read) << "Failed to read history:" << UA_StatusCode_name(result.statusCode);
+            m_continuation_point = {};
+            finish(result.statusCode);
+            return;
+        }
+
+        // Request the next page right away, the server prepares it while this one is handed out.
+        m_continuation_point = opcua::ByteString{result.continuationPoint};
+        if (!m_continuation_point.empty()) {
+            requestPage();
+        }
+
+        const auto& data = result.historyData;
+        if (data.encoding >= UA_EXTENSIONOBJECT_DECODED
+            && data.content.decoded.type == &UA_TYPES[UA_TYPES_HISTORYDATA]) {
+            const auto* history_data = static_cast<const UA_HistoryData*>(data.content.decoded.data);
+            m_page.clear();
+            m_page.reserve(history_data->dataValuesSize);
+            for (std::size_t i = 0; i < history_data->dataValuesSize; ++i) {
+                if (const auto sample = TimeSeriesStore::toSample(history_data->dataValues[i]); sample.has_value()) {
+                    m_page.push_back(*sample);
+                } else {
+                    ++m_skipped_count;
+                }
+            }
+            m_sample_count += m_page.size();
+            if (!m_page.empty()) {
+                const QPointer self{this};
+                Q_EMIT samplesReceived(m_page);
+                // the receiver may have deleted the read
+                if (self.isNull()) {
+                    return;
+                }
+            }
+        }
+
+        // the receiver may have cancelled the read
+        if (!m_finished && m_continuation_point.empty()) {
+            finish(result.statusCode);
+        }
+    }
+
+    void HistoryRead::finish(UA_StatusCode status) {
+        m_finished = true;
+        Q_EMIT finished(StatusCode{opcua::StatusCode{status}});
+    }
+} // namespace magnesia::opcua_qt
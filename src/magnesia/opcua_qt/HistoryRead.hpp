@@ -0,0 +1,141 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+#include "Connection.hpp"
+#include "TimeSeries.hpp"
+#include "abstraction/NodeId.hpp"
+#include "abstraction/StatusCode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <open62541/types.h>
+#include <open62541/types_generated.h>
+#include <open62541pp/types/Builtin.h>
+
+#include <QObject>
+#include <QPointer>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class HistoryRead
+     * @brief Reads the history of a node page by page in the background.
+     *
+     * The read follows the continuation points of the server. The next page is requested as soon as a page arrived,
+     * so at most two pages are held at a time. The numeric values of every page are handed out with samplesReceived
+     * before the page is freed, nothing is accumulated. Values that aren't good numeric scalars are skipped.
+     *
+     * Must only be used on the thread the connection lives in. Deleting the read cancels it.
+     *
+     * See https://reference.opcfoundation.org/Core/Part11/v105/docs/6.5
+     */
+    class HistoryRead : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(HistoryRead)
+
+      public:
+        /**
+         * @brief Starts reading the raw values of a node.
+         *
+         * @param connection the connection of the node
+         * @param node_id the node to read the history of
+         * @param start start of the interval. The values are returned in reverse order if start is after end.
+         * @param end end of the interval
+         * @param values_per_page maximum number of values per page, 0 to let the server decide
+         * @param parent the QObject parent
+         */
+        static HistoryRead* readRaw(Connection* connection, const abstraction::NodeId& node_id,
+                                    TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                    std::uint32_t values_per_page, QObject* parent = nullptr);
+
+        /**
+         * @brief Starts reading aggregates of the values of a node, e.g. one average per minute.
+         *
+         * @param connection the connection of the node
+         * @param node_id the node to read the history of
+         * @param start start of the interval
+         * @param end end of the interval
+         * @param processing_interval length of the interval each aggregate covers
+         * @param aggregate_type the aggregate function, e.g. UA_NS0ID_AGGREGATEFUNCTION_AVERAGE
+         * @param parent the QObject parent
+         */
+        static HistoryRead* readProcessed(Connection* connection, const abstraction::NodeId& node_id,
+                                          TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                          TimeSeries::Duration processing_interval,
+                                          const abstraction::NodeId& aggregate_type, QObject* parent = nullptr);
+
+        ~HistoryRead() override;
+
+        /**
+         * @brief Gets the node whose history is read.
+         */
+        [[nodiscard]] const abstraction::NodeId& getNodeId() const noexcept;
+
+        /**
+         * @brief Stops reading and releases the continuation point on the server. finished isn't emitted.
+         *
+         * Does nothing if the read has already finished.
+         */
+        void cancel();
+
+        /**
+         * @brief Checks if the read finished or was cancelled.
+         */
+        [[nodiscard]] bool isFinished() const noexcept;
+
+        /**
+         * @brief Gets the number of samples received so far.
+         */
+        [[nodiscard]] std::size_t getSampleCount() const noexcept;
+
+        /**
+         * @brief Gets the number of values skipped so far because they weren't good numeric scalars.
+         */
+        [[nodiscard]] std::size_t getSkippedCount() const noexcept;
+
+      signals:
+        /**
+         * Emitted for every page that contained numeric values.
+         *
+         * @param samples the samples of the page, in the order returned by the server. Only valid during the call.
+         */
+        void samplesReceived(const std::vector<magnesia::opcua_qt::TimeSeries::Sample>& samples);
+
+        /**
+         * Emitted after the last page arrived or when the read failed.
+         *
+         * @param status the status of the read
+         */
+        void finished(const magnesia::opcua_qt::abstraction::StatusCode& status);
+
+      private:
+        HistoryRead(Connection* connection, abstraction::NodeId node_id, std::shared_ptr<UA_ExtensionObject> details,
+                    QObject* parent);
+
+        void requestPage();
+        void onPage(const UA_HistoryReadResult& result);
+        void finish(UA_StatusCode status);
+
+      private:
+        QPointer<Connection> m_connection;
+        abstraction::NodeId  m_node_id;
+        // shared with requests in flight, which release their continuation point if the read is gone
+        std::shared_ptr<UA_ExtensionObject> m_details;
+        opcua::ByteString                   m_continuation_point;
+        // reused for every page
+        std::vector<TimeSeries::Sample> m_page;
+        std::size_t                     m_sample_count{0};
+        std::size_t                     m_skipped_count{0};
+        bool                            m_requested{false};
+        bool                            m_finished{false};
+    };
+} // namespace magnesia::opcua_qt
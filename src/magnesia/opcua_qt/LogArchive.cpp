@@ -0,0 +1,70 @@
+#include "LogArchive.hpp"
+
+#include "../qt_version_check.hpp"
+#include "LogEntry.hpp"
+#include "LogSegment.hpp"
+#include "LogWriter.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <QDir>
+#include <QLoggingCategory>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_log_archive, "magnesia.opcua.log_archive")
+} // namespace
+
+namespace magnesia::opcua_qt {
+    LogArchive::LogArchive(QDir directory, std::vector<std::unique_ptr<LogSegment>> segments)
+        : m_directory(std::move(directory)), m_segments(std::move(segments)) {
+        std::uint64_t end{0};
+        for (const auto& segment : m_segments) {
+            end += segment->size();
+            m_segment_ends.push_back(end);
+        }
+    }
+
+    std::unique_ptr<LogArchive> LogArchive::open(const QDir& directory) {
+        std::vector<std::unique_ptr<LogSegment>> segments;
+        // the numbered names sort in logging order
+        for (const auto& name : directory.entryList({LogWriter::segmentNameFilter()}, QDir::Files, QDir::Name)) {
+            if (auto segment = LogSegment::open(directory.absoluteFilePath(name)); segment != nullptr) {
+                segments.push_back(std::move(segment));
+            }
+        }
+        if (segments.empty()) {
+            qCWarning(lc_opcua_log_archive) << "No log in" << directory.absolutePath();
+            return nullptr;
+        }
+        return std::unique_ptr<LogArchive>{new LogArchive{directory, std::move(segments)}};
+    }
+
+    std::uint64_t LogArchive::size() const noexcept {
+        return m_segment_ends.back();
+    }
+
+    std::optional<LogEntry> LogArchive::at(std::uint64_t number) const {
+        Q_ASSERT(number < size());
+        const auto end     = std::ranges::upper_bound(m_segment_ends, number);
+        const auto segment = static_cast<std::size_t>(std::distance(m_segment_ends.begin(), end));
+        const auto first   = segment == 0 ? std::uint64_t{0} : m_segment_ends[segment - 1];
+        return m_segments[segment]->at(static_cast<std::size_t>(number - first));
+    }
+
+    const QDir& LogArchive::getDirectory() const noexcept {
+        return m_directory;
+    }
+} // namespace magnesia::opcua_qt
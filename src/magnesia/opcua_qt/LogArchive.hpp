@@ -0,0 +1,61 @@
+#pragma once
+
+#include "LogEntry.hpp"
+#include "LogSegment.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QDir>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class LogArchive
+     * @brief Reads a log persisted by LogWriter.
+     *
+     * All segments are memory-mapped, entries are only decoded when they are read. The entries are numbered across
+     * the segments in logging order. The archive shows the segments as they were when it was opened, entries written
+     * afterwards aren't included.
+     */
+    class LogArchive {
+      public:
+        /**
+         * @brief Opens a persisted log.
+         *
+         * @param directory directory of the log
+         *
+         * @return the archive or nullptr if the directory contains no readable segment
+         */
+        [[nodiscard]] static std::unique_ptr<LogArchive> open(const QDir& directory);
+
+        /**
+         * @brief Gets the number of entries in all segments.
+         */
+        [[nodiscard]] std::uint64_t size() const noexcept;
+
+        /**
+         * @brief Reads an entry.
+         *
+         * @param number number of the entry, below size
+         *
+         * @return the entry or nullopt if its segment is corrupt
+         */
+        [[nodiscard]] std::optional<LogEntry> at(std::uint64_t number) const;
+
+        /**
+         * @brief Gets the directory of the log.
+         */
+        [[nodiscard]] const QDir& getDirectory() const noexcept;
+
+      private:
+        LogArchive(QDir directory, std::vector<std::unique_ptr<LogSegment>> segments);
+
+      private:
+        QDir                                     m_directory;
+        std::vector<std::unique_ptr<LogSegment>> m_segments;
+        // number of the first entry after each segment
+        std::vector<std::uint64_t>               m_segment_ends;
+    };
+} // namespace magnesia::opcua_qt
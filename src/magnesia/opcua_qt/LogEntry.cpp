@@ -1,9 +1,13 @@
 #include "LogEntry.hpp"
 
+#include "../qt_version_check.hpp"
 #include "abstraction/LogCategory.hpp"
 #include "abstraction/LogLevel.hpp"
 
-#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <string_view>
 #include <utility>
 
@@ -11,13 +15,24 @@
 
 #include <QString>
 
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtTypes>
+#else
+#include <QtGlobal>
+#endif
+
 namespace magnesia::opcua_qt {
     LogEntry::LogEntry(LogLevel level, LogCategory category, QString message)
         : m_message(std::move(message)), m_level(level), m_category(category) {}
 
     LogEntry::LogEntry(opcua::LogLevel level, opcua::LogCategory category, const std::string_view& message)
-        : m_message(QString::fromStdString(std::string(message))), m_level(static_cast<LogLevel>(level)),
-          m_category(static_cast<LogCategory>(category)) {}
+        : m_message(QString::fromUtf8(message.data(), static_cast<qsizetype>(message.size()))),
+          m_level(static_cast<LogLevel>(level)), m_category(static_cast<LogCategory>(category)) {}
+
+    LogEntry::LogEntry(LogLevel level, LogCategory category, QString message, TimePoint time, TimePoint last_time,
+                       std::uint64_t repeat_count)
+        : m_message(std::move(message)), m_level(level), m_category(category), m_time(time), m_last_time(last_time),
+          m_repeat_count(std::max<std::uint64_t>(repeat_count, 1)) {}
 
     LogLevel LogEntry::getLevel() const noexcept {
         return m_level;
@@ -30,4 +45,48 @@ namespace magnesia::opcua_qt {
     const QString& LogEntry::getMessage() const noexcept {
         return m_message;
     }
+
+    LogEntry::TimePoint LogEntry::getTime() const noexcept {
+        return m_time;
+    }
+
+    LogEntry::TimePoint LogEntry::getLastTime() const noexcept {
+        return m_last_time;
+    }
+
+    std::uint64_t LogEntry::getRepeatCount() const noexcept {
+        return m_repeat_count;
+    }
+
+    const std::deque<LogEntry::TimePoint>& LogEntry::getRepeatTimes() const noexcept {
+        static const std::deque<TimePoint> no_repeats;
+        if (m_repeat_times == nullptr) {
+            return no_repeats;
+        }
+        return *m_repeat_times;
+    }
+
+    bool LogEntry::isRepeatOf(const LogEntry& other) const noexcept {
+        return m_level == other.m_level && m_category == other.m_category && m_message == other.m_message;
+    }
+
+    void LogEntry::addRepeat(const LogEntry& repeat) {
+        if (m_repeat_times == nullptr) {
+            m_repeat_times = std::make_shared<std::deque<TimePoint>>();
+        } else if (m_repeat_times.use_count() > 1) {
+            // copy on write, the times are only ever changed in the thread that owns the original
+            m_repeat_times = std::make_shared<std::deque<TimePoint>>(*m_repeat_times);
+        }
+
+        m_repeat_times->push_back(repeat.m_time);
+        if (m_repeat_times->size() > c_max_repeat_times) {
+            m_repeat_times->pop_front();
+        }
+        countRepeat(repeat);
+    }
+
+    void LogEntry::countRepeat(const LogEntry& repeat) noexcept {
+        ++m_repeat_count;
+        m_last_time = repeat.m_time;
+    }
 } // namespace magnesia::opcua_qt
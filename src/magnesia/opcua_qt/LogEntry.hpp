@@ -3,6 +3,10 @@
 #include "abstraction/LogCategory.hpp"
 #include "abstraction/LogLevel.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <string_view>
 
 #include <open62541pp/Logger.h>
@@ -14,9 +18,16 @@ namespace magnesia::opcua_qt {
      * @class LogEntry
      * @brief Entry for the logging system
      *
+     * Consecutive entries with the same level, category and message are collapsed into one entry counting the repeats.
      */
     class LogEntry {
       public:
+        using Clock     = std::chrono::system_clock;
+        using TimePoint = Clock::time_point;
+
+        /// Number of repeat times kept, older ones are only counted.
+        static constexpr std::size_t c_max_repeat_times = 1000;
+
         /**
          * @brief Creates a LogEntry
          *
@@ -33,6 +44,18 @@ namespace magnesia::opcua_qt {
          * @param message a QString
          */
         LogEntry(opcua::LogLevel level, opcua::LogCategory category, const std::string_view& message);
+        /**
+         * @brief Restores a LogEntry read from disk. The times of the single repeats aren't known.
+         *
+         * @param level a LogLevel
+         * @param category a LogCategory
+         * @param message a QString
+         * @param time the time the entry was created
+         * @param last_time the time of the last repeat
+         * @param repeat_count how often the entry was logged, at least 1
+         */
+        LogEntry(LogLevel level, LogCategory category, QString message, TimePoint time, TimePoint last_time,
+                 std::uint64_t repeat_count);
         /**
          * @brief Returns the log level
          *
@@ -51,10 +74,51 @@ namespace magnesia::opcua_qt {
          * @return a QString
          */
         [[nodiscard]] const QString& getMessage() const noexcept;
+        /**
+         * @brief Returns the time the entry was created
+         */
+        [[nodiscard]] TimePoint getTime() const noexcept;
+        /**
+         * @brief Returns the time of the last repeat or the creation time if there was none
+         */
+        [[nodiscard]] TimePoint getLastTime() const noexcept;
+        /**
+         * @brief Returns how often the entry was logged, including the first time
+         */
+        [[nodiscard]] std::uint64_t getRepeatCount() const noexcept;
+        /**
+         * @brief Returns the times of the latest repeats, at most c_max_repeat_times, oldest first. Empty for restored
+         * entries.
+         */
+        [[nodiscard]] const std::deque<TimePoint>& getRepeatTimes() const noexcept;
+        /**
+         * @brief Checks if another entry has the same level, category and message
+         *
+         * @param other the other entry
+         */
+        [[nodiscard]] bool isRepeatOf(const LogEntry& other) const noexcept;
+        /**
+         * @brief Counts a repeat of this entry
+         *
+         * @param repeat the repeating entry, it should be a repeat of this one
+         */
+        void addRepeat(const LogEntry& repeat);
+        /**
+         * @brief Counts a repeat of this entry like addRepeat, but doesn't keep its time in getRepeatTimes
+         *
+         * @param repeat the repeating entry, it should be a repeat of this one
+         */
+        void countRepeat(const LogEntry& repeat) noexcept;
 
       private:
-        QString     m_message;
-        LogLevel    m_level;
-        LogCategory m_category;
+        QString       m_message;
+        LogLevel      m_level;
+        LogCategory   m_category;
+        TimePoint     m_time{Clock::now()};
+        TimePoint     m_last_time{m_time};
+        std::uint64_t m_repeat_count{1};
+        // Only allocated once the entry repeats. Shared between copies until it changes, copies can be read
+        // elsewhere while the original is still repeated.
+        std::shared_ptr<std::deque<TimePoint>> m_repeat_times;
     };
 } // namespace magnesia::opcua_qt
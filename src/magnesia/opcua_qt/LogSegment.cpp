@@ -0,0 +1,201 @@
+#include "LogSegment.hpp"
+
+#include "../qt_version_check.hpp"
+#include "LogEntry.hpp"
+#include "SegmentFile.hpp"
+#include "abstraction/LogCategory.hpp"
+#include "abstraction/LogLevel.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QLoggingCategory>
+#include <QString>
+#include <QtEndian>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#include <QtTypes>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_log_segment, "magnesia.opcua.log_segment")
+
+    using magnesia::opcua_qt::LogCategory;
+    using magnesia::opcua_qt::LogEntry;
+    using magnesia::opcua_qt::LogLevel;
+    using magnesia::opcua_qt::SegmentFile;
+
+    constexpr SegmentFile::Magic c_index_magic{'M', 'G', 'N', 'L', 'I', 'X', '0', '1'};
+
+    // the only kind of record
+    constexpr std::uint8_t  c_entry_kind        = 0;
+    // time (8), last time (8), repeat count (8), level (1), category (1), reserved (2)
+    constexpr std::uint64_t c_entry_header_size = 28;
+    // records per block of the index
+    constexpr std::uint64_t c_block_records     = 256;
+
+    std::int64_t to_nanoseconds(LogEntry::TimePoint time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    LogEntry::TimePoint from_nanoseconds(std::int64_t nanoseconds) {
+        return LogEntry::TimePoint{
+            std::chrono::duration_cast<LogEntry::Clock::duration>(std::chrono::nanoseconds{nanoseconds})};
+    }
+
+    // Validates the record at offset. Returns nullopt if it is incomplete, corrupt or not an entry.
+    std::optional<SegmentFile::Record> parse_record(const SegmentFile& file, std::uint64_t end, std::uint64_t offset) {
+        auto record = file.parseRecord(offset, end);
+        if (!record.has_value() || record->kind != c_entry_kind || record->size < c_entry_header_size) {
+            return std::nullopt;
+        }
+        const auto level    = record->payload[24];
+        const auto category = record->payload[25];
+        if (level > static_cast<uchar>(LogLevel::FATAL) || category > static_cast<uchar>(LogCategory::APPLICATION)) {
+            return std::nullopt;
+        }
+        return record;
+    }
+
+    LogEntry decode_entry(const SegmentFile::Record& record) {
+        const auto* payload = record.payload;
+        return LogEntry{
+            static_cast<LogLevel>(payload[24]),
+            static_cast<LogCategory>(payload[25]),
+            QString::fromUtf8(reinterpret_cast<const char*>(payload + c_entry_header_size),
+                              static_cast<qsizetype>(record.size - c_entry_header_size)),
+            from_nanoseconds(qFromLittleEndian<std::int64_t>(payload)),
+            from_nanoseconds(qFromLittleEndian<std::int64_t>(payload + 8)),
+            qFromLittleEndian<std::uint64_t>(payload + 16),
+        };
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    LogSegment::LogSegment(std::unique_ptr<SegmentFile> file) : m_file(std::move(file)) {}
+
+    std::unique_ptr<LogSegment> LogSegment::open(const QString& path) {
+        auto file = SegmentFile::open(path, c_magic);
+        if (file == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<LogSegment> segment{new LogSegment{std::move(file)}};
+        if (!segment->loadIndex()) {
+            segment->scan();
+        }
+        return segment;
+    }
+
+    std::size_t LogSegment::size() const noexcept {
+        return m_index.record_count;
+    }
+
+    std::optional<LogEntry> LogSegment::at(std::size_t number) const {
+        Q_ASSERT(number < size());
+        auto offset = m_index.blocks[number / c_block_records];
+        // The records were validated when the index was built, only the sizes are needed to skip them.
+        for (auto skip = number % c_block_records; skip > 0; --skip) {
+            const auto next = m_file->skipRecord(offset, m_index.data_size);
+            if (!next.has_value()) {
+                return std::nullopt;
+            }
+            offset = *next;
+        }
+        const auto record = parse_record(*m_file, m_index.data_size, offset);
+        if (!record.has_value()) {
+            qCWarning(lc_opcua_log_segment) << "Corrupt record in" << m_file->getPath() << "at" << offset;
+            return std::nullopt;
+        }
+        return decode_entry(*record);
+    }
+
+    void LogSegment::appendRecord(QByteArray& buffer, const LogEntry& entry) {
+        auto message = entry.getMessage().toUtf8();
+        // cutting a character in half only garbles the end of an oversized message
+        message.truncate(static_cast<qsizetype>(SegmentFile::c_max_payload_size - c_entry_header_size));
+
+        const auto start = SegmentFile::beginRecord(buffer);
+        SegmentFile::appendLittleEndian(buffer, to_nanoseconds(entry.getTime()));
+        SegmentFile::appendLittleEndian(buffer, to_nanoseconds(entry.getLastTime()));
+        SegmentFile::appendLittleEndian(buffer, entry.getRepeatCount());
+        buffer.append(static_cast<char>(entry.getLevel()));
+        buffer.append(static_cast<char>(entry.getCategory()));
+        buffer.append(2, '\0');
+        buffer.append(message);
+        SegmentFile::endRecord(buffer, start, c_entry_kind);
+    }
+
+    void LogSegment::indexRecord(Index& index, std::uint64_t offset) {
+        if (index.record_count % c_block_records == 0) {
+            index.blocks.push_back(offset);
+        }
+        ++index.record_count;
+    }
+
+    QByteArray LogSegment::encodeIndex(const Index& index) {
+        return SegmentFile::encodeIndex(c_index_magic, [&index](QDataStream& out) {
+            out << static_cast<quint64>(index.data_size) << static_cast<quint64>(index.record_count);
+            out << static_cast<quint32>(index.blocks.size());
+            for (const auto offset : index.blocks) {
+                out << static_cast<quint64>(offset);
+            }
+        });
+    }
+
+    bool LogSegment::loadIndex() {
+        Index      index;
+        const auto read = [this, &index](QDataStream& in) {
+            quint64 data_size{0};
+            quint64 record_count{0};
+            quint32 block_count{0};
+            in >> data_size >> record_count >> block_count;
+            if (in.status() != QDataStream::Ok || data_size > m_file->size()
+                || block_count != (record_count + c_block_records - 1) / c_block_records) {
+                return false;
+            }
+            index.data_size    = data_size;
+            index.record_count = record_count;
+            for (quint32 i = 0; i < block_count && in.status() == QDataStream::Ok; ++i) {
+                quint64 offset{0};
+                in >> offset;
+                if (offset >= data_size) {
+                    return false;
+                }
+                index.blocks.push_back(offset);
+            }
+            return true;
+        };
+        if (!m_file->readIndex(c_index_magic, read)) {
+            return false;
+        }
+
+        m_index = std::move(index);
+        return true;
+    }
+
+    void LogSegment::scan() {
+        Index index;
+        auto  offset = SegmentFile::firstRecordOffset();
+        while (const auto record = parse_record(*m_file, m_file->size(), offset)) {
+            indexRecord(index, offset);
+            offset = record->next;
+        }
+        index.data_size = offset;
+
+        if (offset < m_file->size()) {
+            qCInfo(lc_opcua_log_segment) << "Ignoring" << m_file->size() - offset
+                                         << "bytes after the last complete record of" << m_file->getPath();
+        }
+        m_index = std::move(index);
+    }
+} // namespace magnesia::opcua_qt
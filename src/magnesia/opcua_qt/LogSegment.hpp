@@ -0,0 +1,107 @@
+#pragma once
+
+#include "LogEntry.hpp"
+#include "SegmentFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class LogSegment
+     * @brief A read-only, memory-mapped segment of a persisted log.
+     *
+     * A segment is a SegmentFile with one record per log entry, so a segment cut short by a crash is read up to its
+     * last complete record. The payload holds the first and last time, the repeat count, level, category and the
+     * UTF-8 encoded message of the entry.
+     *
+     * The index of a segment is written to a file next to it once the segment is complete. It holds the offset of
+     * every block of records, so any entry can be read after skipping at most a block's worth of record headers.
+     * Segments without an index, e.g. the one still being written or after a crash, are scanned once when opened.
+     *
+     * @see LogWriter
+     * @see LogArchive
+     */
+    class LogSegment {
+      public:
+        /// Magic number every segment starts with.
+        static constexpr SegmentFile::Magic c_magic{'M', 'G', 'N', 'L', 'O', 'G', '0', '1'};
+
+        /**
+         * @brief The index of a segment, built by the writer while appending and by open for segments without index.
+         */
+        struct Index {
+            /// Size of the segment data covered by the index.
+            std::uint64_t              data_size{0};
+            std::uint64_t              record_count{0};
+            /// Offsets of the first record of every block.
+            std::vector<std::uint64_t> blocks;
+        };
+
+        /**
+         * @brief Opens a segment and maps it into memory.
+         *
+         * @param path path of the segment
+         *
+         * @return the segment or nullptr if it can't be opened or isn't a segment
+         */
+        [[nodiscard]] static std::unique_ptr<LogSegment> open(const QString& path);
+
+        /**
+         * @brief Gets the number of entries.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Reads an entry. Only the record headers of the entry's block before it are touched.
+         *
+         * @param number number of the entry in the segment, below size
+         *
+         * @return the entry or nullopt if the segment was corrupted since it was indexed
+         */
+        [[nodiscard]] std::optional<LogEntry> at(std::size_t number) const;
+
+        /**
+         * @brief Appends the record of an entry.
+         */
+        static void appendRecord(QByteArray& buffer, const LogEntry& entry);
+
+        /**
+         * @brief Adds a record to an index. Records have to be added in the order they were appended.
+         *
+         * @param index the index to add the record to
+         * @param offset offset of the record
+         */
+        static void indexRecord(Index& index, std::uint64_t offset);
+
+        /**
+         * @brief Serializes an index for the index file.
+         */
+        [[nodiscard]] static QByteArray encodeIndex(const Index& index);
+
+      private:
+        explicit LogSegment(std::unique_ptr<SegmentFile> file);
+
+        /**
+         * @brief Loads the index file of the segment.
+         *
+         * @return false if there is no complete index file for this segment
+         */
+        bool loadIndex();
+
+        /**
+         * @brief Builds the index by reading all records, up to the first incomplete or corrupt one.
+         */
+        void scan();
+
+      private:
+        std::unique_ptr<SegmentFile> m_file;
+        Index                        m_index;
+    };
+} // namespace magnesia::opcua_qt
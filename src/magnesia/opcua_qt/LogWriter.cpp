@@ -0,0 +1,205 @@
+#include "LogWriter.hpp"
+
+#include "LogEntry.hpp"
+#include "LogSegment.hpp"
+#include "SegmentFile.hpp"
+#include "SegmentWriter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QLoggingCategory>
+#include <QString>
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_log_writer, "magnesia.opcua.log_writer")
+
+    constexpr auto c_segment_suffix = ".mgnlog";
+    constexpr auto c_lock_name      = "writer.lock";
+
+    std::unique_ptr<QLockFile> make_lock(const QDir& directory) {
+        auto lock = std::make_unique<QLockFile>(directory.absoluteFilePath(c_lock_name));
+        // held for the lifetime of a writer, only stale once its process is gone
+        lock->setStaleLockTime(0);
+        return lock;
+    }
+
+    // Checks if another writer is writing to a log. The lock of a writer that crashed is removed.
+    bool is_written(const QDir& log) {
+        if (!log.exists(c_lock_name)) {
+            return false;
+        }
+        const auto lock = make_lock(log);
+        if (lock->tryLock(0)) {
+            lock->unlock();
+            return false;
+        }
+        return lock->error() == QLockFile::LockFailedError;
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    LogWriter::LogWriter(std::unique_ptr<QLockFile> lock, std::unique_ptr<SegmentWriter> segments,
+                         std::uint64_t max_total_size, std::optional<QDir> history)
+        : m_lock(std::move(lock)), m_segments(std::move(segments)), m_max_total_size(max_total_size),
+          m_history(std::move(history)) {}
+
+    std::unique_ptr<LogWriter> LogWriter::open(const QDir& directory, std::size_t max_segment_size,
+                                               std::uint64_t max_total_size, const std::optional<QDir>& history) {
+        if (!directory.mkpath(".")) {
+            qCWarning(lc_opcua_log_writer) << "Can't create log directory" << directory.absolutePath();
+            return nullptr;
+        }
+        auto lock = make_lock(directory);
+        if (!lock->tryLock(0)) {
+            qCWarning(lc_opcua_log_writer) << "Log directory" << directory.absolutePath()
+                                           << "is written by another writer";
+            return nullptr;
+        }
+        auto segments = SegmentWriter::open(directory, c_segment_suffix, LogSegment::c_magic, max_segment_size);
+        if (segments == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<LogWriter> writer{new LogWriter{std::move(lock), std::move(segments), max_total_size,
+                                                        history}};
+        writer->scanFinishedSegments();
+        writer->removeOldSegments();
+        return writer;
+    }
+
+    LogWriter::~LogWriter() {
+        flushPending();
+        finishSegment();
+    }
+
+    void LogWriter::append(const LogEntry& entry) {
+        if (!m_segments->isOpen()) {
+            return;
+        }
+        if (m_pending.has_value()) {
+            if (entry.isRepeatOf(*m_pending)) {
+                // the times of the single repeats aren't written
+                m_pending->countRepeat(entry);
+                return;
+            }
+            encodePending();
+        }
+        m_pending = entry;
+    }
+
+    bool LogWriter::flush() {
+        if (!m_segments->write()) {
+            return false;
+        }
+        m_index.data_size = m_segments->getSegmentSize();
+
+        if (m_segments->isFull()) {
+            finishSegment();
+            if (!startSegment()) {
+                return false;
+            }
+            scanFinishedSegments();
+            removeOldSegments();
+        }
+        return true;
+    }
+
+    bool LogWriter::flushPending() {
+        encodePending();
+        return flush();
+    }
+
+    bool LogWriter::hasPending() const noexcept {
+        return m_pending.has_value();
+    }
+
+    const QDir& LogWriter::getDirectory() const noexcept {
+        return m_segments->getDirectory();
+    }
+
+    QString LogWriter::segmentName(std::uint32_t number) {
+        return SegmentWriter::segmentName(c_segment_suffix, number);
+    }
+
+    QString LogWriter::segmentNameFilter() {
+        return SegmentWriter::segmentNameFilter(c_segment_suffix);
+    }
+
+    void LogWriter::encodePending() {
+        if (m_pending.has_value() && m_segments->isOpen()) {
+            const auto offset = m_segments->getOffset();
+            LogSegment::appendRecord(m_segments->getBuffer(), *m_pending);
+            LogSegment::indexRecord(m_index, offset);
+        }
+        m_pending.reset();
+    }
+
+    void LogWriter::scanFinishedSegments() {
+        m_finished_segments.clear();
+        m_finished_size = 0;
+        if (m_history.has_value()) {
+            // the older logs are deleted first
+            for (const auto& name : m_history->entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+                const QDir log{m_history->absoluteFilePath(name)};
+                if (log == getDirectory() || is_written(log)) {
+                    continue;
+                }
+                addFinishedSegments(log);
+                // only removed if empty, a log without segments has no use anymore
+                m_history->rmdir(name);
+            }
+        }
+        addFinishedSegments(getDirectory());
+    }
+
+    void LogWriter::addFinishedSegments(const QDir& directory) {
+        const auto current = m_segments->getSegmentPath();
+        for (const auto& name : directory.entryList({segmentNameFilter()}, QDir::Files, QDir::Name)) {
+            const auto path = directory.absoluteFilePath(name);
+            if (path == current) {
+                continue;
+            }
+            const auto size = static_cast<std::uint64_t>(QFileInfo{path}.size());
+            m_finished_segments.push_back({.path = path, .size = size});
+            m_finished_size += size;
+        }
+    }
+
+    bool LogWriter::startSegment() {
+        if (!m_segments->startSegment()) {
+            return false;
+        }
+        m_index = {};
+        return true;
+    }
+
+    void LogWriter::finishSegment() {
+        m_segments->finishSegment(LogSegment::encodeIndex(m_index));
+    }
+
+    void LogWriter::removeOldSegments() {
+        while (!m_finished_segments.empty() && m_finished_size + m_segments->getSegmentSize() > m_max_total_size) {
+            const auto& segment = m_finished_segments.front();
+            // Readers keep their mapping of a removed segment on most systems. Elsewhere the segment is left behind and
+            // removed once the directory is opened again.
+            if (!QFile::remove(segment.path)) {
+                qCWarning(lc_opcua_log_writer) << "Failed to remove old segment" << segment.path;
+            }
+            QFile::remove(SegmentFile::indexPath(segment.path));
+            // only succeeds once the last segment of an older log is gone
+            if (const auto log = QFileInfo{segment.path}.absoluteDir(); log != getDirectory()) {
+                log.rmdir(log.absolutePath());
+            }
+            m_finished_size -= segment.size;
+            m_finished_segments.pop_front();
+        }
+    }
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "LogEntry.hpp"
+#include "LogSegment.hpp"
+#include "SegmentWriter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include <QDir>
+#include <QLockFile>
+#include <QString>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class LogWriter
+     * @brief Appends log entries to size-rotated segments in a directory.
+     *
+     * Records are collected in memory and written with flush. A new segment is started once the current one reached
+     * its maximum size. The oldest segments of the directory are deleted once all segments together exceed the
+     * maximum total size, so the log covers as much time as fits into that size. Optionally, the older logs in the
+     * other directories of a history directory count towards the total size as well and are deleted first. They are
+     * scanned again whenever a new segment is started, since other writers add and delete segments in the meantime.
+     *
+     * The writer holds a lock file in its directory, so other writers leave the log alone while it is written.
+     *
+     * Consecutive repeats are collapsed like in the Logger, but only their number and last time are kept. The last
+     * appended entry is held back since it might still be repeated, it is written by flushPending or once a different
+     * entry is appended.
+     *
+     * @see LogSegment
+     * @see LogArchive
+     * @see SegmentWriter
+     */
+    class LogWriter {
+      public:
+        /**
+         * @brief Opens a log directory for writing.
+         *
+         * @param directory the directory, created if it doesn't exist. Existing segments are kept and count towards
+         *                  the total size, new ones are numbered after them.
+         * @param max_segment_size size in bytes after which a new segment is started
+         * @param max_total_size size in bytes of all segments after which the oldest ones are deleted
+         * @param history directory containing the directory and the older logs, one per directory. The logs sort
+         *                oldest first by their directory names. Their segments are deleted before the own ones and
+         *                their directories once they are empty. Logs another writer is still writing to are skipped.
+         *
+         * @return the writer or nullptr if the directory or first segment can't be created or another writer is
+         *         writing to the directory
+         */
+        [[nodiscard]] static std::unique_ptr<LogWriter> open(const QDir& directory, std::size_t max_segment_size,
+                                                             std::uint64_t max_total_size,
+                                                             const std::optional<QDir>& history = std::nullopt);
+
+        ~LogWriter();
+
+        /**
+         * @brief Appends an entry as it was logged, before it was collapsed with its repeats.
+         *
+         * @param entry the entry
+         */
+        void append(const LogEntry& entry);
+
+        /**
+         * @brief Writes the appended records to disk, except for the held back entry. Starts a new segment if the
+         * current one is full.
+         *
+         * @return false if writing failed. The writer shouldn't be used anymore then.
+         */
+        bool flush();
+
+        /**
+         * @brief Writes the held back entry as well. Later repeats of it start a new record.
+         *
+         * @return false if writing failed
+         */
+        bool flushPending();
+
+        /**
+         * @brief Checks if an entry is held back.
+         */
+        [[nodiscard]] bool hasPending() const noexcept;
+
+        /**
+         * @brief Gets the directory of the log.
+         */
+        [[nodiscard]] const QDir& getDirectory() const noexcept;
+
+        /**
+         * @brief Gets the name of a segment file.
+         *
+         * @param number number of the segment, segments are read in the order of their numbers
+         */
+        [[nodiscard]] static QString segmentName(std::uint32_t number);
+
+        /**
+         * @brief Gets the name filter matching all segment files of a log.
+         */
+        [[nodiscard]] static QString segmentNameFilter();
+
+      private:
+        LogWriter(std::unique_ptr<QLockFile> lock, std::unique_ptr<SegmentWriter> segments,
+                  std::uint64_t max_total_size, std::optional<QDir> history);
+
+        // moves the held back entry into the buffer
+        void encodePending();
+        // collects the finished segments of the older logs and the own directory
+        void scanFinishedSegments();
+        // adds the segments of a directory to the finished ones
+        void addFinishedSegments(const QDir& directory);
+        bool startSegment();
+        void finishSegment();
+        // deletes the oldest finished segments while the total size is exceeded, and the emptied older logs
+        void removeOldSegments();
+
+        struct FinishedSegment {
+            QString       path;
+            std::uint64_t size;
+        };
+
+      private:
+        // held while the directory is written
+        std::unique_ptr<QLockFile>     m_lock;
+        std::unique_ptr<SegmentWriter> m_segments;
+        std::uint64_t                  m_max_total_size;
+        std::optional<QDir>            m_history;
+        std::optional<LogEntry>        m_pending;
+        LogSegment::Index              m_index;
+
+        // oldest first
+        std::deque<FinishedSegment> m_finished_segments;
+        std::uint64_t               m_finished_size{0};
+    };
+} // namespace magnesia::opcua_qt
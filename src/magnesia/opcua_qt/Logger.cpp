@@ -1,27 +1,477 @@
 #include "Logger.hpp"
 
+#include "../Application.hpp"
+#include "../qt_version_check.hpp"
 #include "LogEntry.hpp"
+#include "LogWriter.hpp"
+#include "abstraction/LogCategory.hpp"
+#include "abstraction/LogLevel.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include <open62541pp/Logger.h>
 
+#include <QChar>
+#include <QDateTime>
+#include <QDir>
+#include <QLoggingCategory>
+#include <QMetaObject>
 #include <QObject>
+#include <QString>
+#include <QTimer>
+#include <Qt>
 #include <qtmetamacros.h>
 
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_logger, "magnesia.opcua.logger")
+
+    constexpr auto c_history_dir = "logs";
+
+    // roughly one frame, entries logged in the meantime are added at once
+    constexpr std::chrono::milliseconds c_flush_interval{16};
+    // interval in which suppressed entries are summarized
+    constexpr std::chrono::seconds      c_summary_interval{1};
+    // time an entry held back by the writer waits for repeats before it is written anyway
+    constexpr std::chrono::seconds      c_persist_delay{1};
+    // upper bound of the segment size, smaller persisted logs use at least four segments
+    constexpr std::uint64_t             c_max_segment_size = 16UL * 1024UL * 1024UL;
+
+    constexpr std::array c_levels{
+        magnesia::opcua_qt::LogLevel::TRACE,
+        magnesia::opcua_qt::LogLevel::DEBUG,
+        magnesia::opcua_qt::LogLevel::INFO,
+        magnesia::opcua_qt::LogLevel::WARNING,
+        magnesia::opcua_qt::LogLevel::ERROR,
+        magnesia::opcua_qt::LogLevel::FATAL,
+    };
+
+    std::size_t log_capacity() {
+        const auto capacity = magnesia::Application::instance().getSettingsManager().getIntSetting(
+            {.name = "log_capacity", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(capacity);
+        return static_cast<std::size_t>(capacity.value());
+    }
+
+    std::uint32_t log_rate_limit() {
+        const auto rate_limit = magnesia::Application::instance().getSettingsManager().getIntSetting(
+            {.name = "log_rate_limit", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(rate_limit);
+        return static_cast<std::uint32_t>(rate_limit.value());
+    }
+
+    magnesia::opcua_qt::LogLevel log_min_level() {
+        const auto min_level = magnesia::Application::instance().getSettingsManager().getEnumSetting(
+            {.name = "log_min_level", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(min_level);
+        for (auto level : c_levels) {
+            if (magnesia::opcua_qt::log_level_to_string(level) == min_level.value()) {
+                return level;
+            }
+        }
+        return magnesia::opcua_qt::LogLevel::TRACE;
+    }
+
+    bool log_persist() {
+        const auto persist = magnesia::Application::instance().getSettingsManager().getBoolSetting(
+            {.name = "log_persist", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(persist);
+        return persist.value();
+    }
+
+    std::uint64_t log_persist_size() {
+        const auto size = magnesia::Application::instance().getSettingsManager().getIntSetting(
+            {.name = "log_persist_size", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(size);
+        // megabytes
+        return static_cast<std::uint64_t>(size.value()) * 1024 * 1024;
+    }
+
+    std::size_t bytes_used(const magnesia::opcua_qt::LogEntry& entry) {
+        // the entry is in one category index and the level indexes up to its level
+        const auto index_count = static_cast<std::size_t>(entry.getLevel()) + 2;
+        return sizeof(entry) + static_cast<std::size_t>(entry.getMessage().capacity()) * sizeof(QChar)
+             + index_count * sizeof(std::uint64_t)
+             + entry.getRepeatTimes().size() * sizeof(magnesia::opcua_qt::LogEntry::TimePoint);
+    }
+
+    void trim_front(std::deque<std::uint64_t>& indexes, std::uint64_t first_index) {
+        while (!indexes.empty() && indexes.front() < first_index) {
+            indexes.pop_front();
+        }
+    }
+} // namespace
+
 namespace magnesia::opcua_qt {
-    Logger::Logger(QObject* parent) : QObject(parent) {}
+    Logger::Logger(QObject* parent) : Logger(log_capacity(), log_rate_limit(), parent) {
+        for (auto& min_level : m_min_levels) {
+            min_level = log_min_level();
+        }
+    }
+
+    Logger::Logger(std::size_t capacity, std::uint32_t rate_limit, QObject* parent)
+        : QObject(parent), m_rate_limit(rate_limit), m_summary_timer(new QTimer(this)), m_flush_timer(new QTimer(this)),
+          m_persist_timer(new QTimer(this)), m_capacity(std::max<std::size_t>(capacity, 1)) {
+        for (auto& min_level : m_min_levels) {
+            min_level = LogLevel::TRACE;
+        }
+        // the buckets start full
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& limit : m_rate_limits) {
+            limit.tokens      = m_rate_limit;
+            limit.last_refill = now;
+        }
+
+        m_summary_timer->setInterval(c_summary_interval);
+        connect(m_summary_timer, &QTimer::timeout, this, &Logger::summarizeSuppressed);
+
+        m_flush_timer->setSingleShot(true);
+        m_flush_timer->setInterval(c_flush_interval);
+        connect(m_flush_timer, &QTimer::timeout, this, &Logger::flush);
+
+        m_persist_timer->setSingleShot(true);
+        m_persist_timer->setInterval(c_persist_delay);
+        connect(m_persist_timer, &QTimer::timeout, this, &Logger::persistPending);
+    }
+
+    Logger::~Logger() {
+        // entries that haven't been added yet are still persisted
+        if (m_writer != nullptr) {
+            while (auto entry = m_pending.tryPop()) {
+                m_writer->append(*entry);
+            }
+        }
+    }
 
     void Logger::log(LogEntry entry) noexcept {
-        m_log_entries.push_back(std::move(entry));
-        Q_EMIT logEntryAdded(m_log_entries.size() - 1);
+        if (admit(entry.getLevel(), entry.getCategory())) {
+            enqueue(std::move(entry));
+        }
+    }
+
+    bool Logger::admit(LogLevel level, LogCategory category) noexcept {
+        const auto category_index = static_cast<std::size_t>(category);
+        if (level < m_min_levels[category_index].load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (m_rate_limit == 0) {
+            return true;
+        }
+
+        auto& limit = m_rate_limits[category_index];
+        {
+            const std::scoped_lock lock{limit.mutex};
+            const auto             now     = std::chrono::steady_clock::now();
+            const auto             elapsed = std::chrono::duration<double>{now - limit.last_refill};
+            limit.tokens      = std::min<double>(m_rate_limit, limit.tokens + elapsed.count() * m_rate_limit);
+            limit.last_refill = now;
+            if (limit.tokens >= 1) {
+                limit.tokens -= 1;
+                return true;
+            }
+        }
+        // only the first suppressed entry since the last summary needs to wake up the summary timer
+        if (limit.suppressed.fetch_add(1, std::memory_order_relaxed) == 0) {
+            QMetaObject::invokeMethod(this, &Logger::scheduleSummary, Qt::QueuedConnection);
+        }
+        return false;
+    }
+
+    void Logger::enqueue(LogEntry entry) noexcept {
+        // Called from the OPC UA client's logging callback as well, an exception mustn't leave it.
+        try {
+            m_pending.push(std::move(entry));
+        } catch (const std::bad_alloc&) {
+            m_unqueued_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Coalesce wake-ups: only the first entry after a flush schedules a new one.
+        if (!m_flush_scheduled.exchange(true, std::memory_order_acq_rel)) {
+            try {
+                QMetaObject::invokeMethod(this, &Logger::scheduleFlush, Qt::QueuedConnection);
+            } catch (const std::bad_alloc&) {
+                // the entry stays queued and is added with the next scheduled flush
+                m_flush_scheduled.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    void Logger::flush() {
+        // Acquires the entries of producers that saw the flag still set, so the drain below can't miss them.
+        m_flush_scheduled.exchange(false, std::memory_order_acq_rel);
+
+        // Entries that would be dropped by the same flush are never added. During log storms this keeps the batch
+        // below twice the capacity.
+        std::size_t skipped{0};
+        // the newest kept entry, while it is still the last one logged
+        const auto repeated_index = m_size > 0 ? std::optional{m_end_index - 1} : std::nullopt;
+        bool       repeated{false};
+        while (auto entry = m_pending.tryPop()) {
+            // the writer collapses repeats on its own, it needs every entry
+            if (m_writer != nullptr) {
+                m_writer->append(*entry);
+            }
+            // consecutive repeats are collapsed into the first entry
+            if (!m_batch.empty() && entry->isRepeatOf(m_batch.back())) {
+                m_batch.back().addRepeat(*entry);
+                continue;
+            }
+            if (m_batch.empty() && repeated_index.has_value()) {
+                if (auto& newest = m_log_entries[position(*repeated_index)]; entry->isRepeatOf(newest)) {
+                    m_bytes_used -= bytes_used(newest);
+                    newest.addRepeat(*entry);
+                    m_bytes_used += bytes_used(newest);
+                    repeated      = true;
+                    continue;
+                }
+            }
+            if (m_batch.size() == 2 * m_capacity) {
+                m_batch.erase(m_batch.begin(), std::next(m_batch.begin(), static_cast<std::ptrdiff_t>(m_capacity)));
+                skipped += m_capacity;
+            }
+            m_batch.push_back(std::move(*entry));
+        }
+        if (m_batch.size() > m_capacity) {
+            const auto excess = m_batch.size() - m_capacity;
+            m_batch.erase(m_batch.begin(), std::next(m_batch.begin(), static_cast<std::ptrdiff_t>(excess)));
+            skipped += excess;
+        }
+        persist();
+        if (repeated) {
+            Q_EMIT logEntryRepeated(*repeated_index);
+        }
+        if (m_batch.empty()) {
+            return;
+        }
+
+        if (const auto dropped = std::max(m_size + m_batch.size(), m_capacity) - m_capacity; dropped > 0) {
+            Q_EMIT logEntriesAboutToBeDropped(dropped);
+            for (std::size_t i = 0; i < dropped; ++i) {
+                m_bytes_used -= bytes_used(m_log_entries[m_head]);
+                m_head        = (m_head + 1) % m_capacity;
+            }
+            m_size          -= dropped;
+            m_dropped_count += dropped;
+            for (auto& indexes : m_min_level_indexes) {
+                trim_front(indexes, getFirstIndex());
+            }
+            for (auto& indexes : m_category_indexes) {
+                trim_front(indexes, getFirstIndex());
+            }
+            Q_EMIT logEntriesDropped(dropped);
+        }
+        // skipped entries still get their indexes
+        m_end_index     += skipped;
+        m_dropped_count += skipped;
+
+        const auto first_index = m_end_index;
+        const auto count       = m_batch.size();
+        Q_EMIT logEntriesAboutToBeAdded(first_index, count);
+        for (auto& entry : m_batch) {
+            m_bytes_used += bytes_used(entry);
+            for (std::size_t level = 0; level <= static_cast<std::size_t>(entry.getLevel()); ++level) {
+                m_min_level_indexes[level].push_back(m_end_index);
+            }
+            m_category_indexes[static_cast<std::size_t>(entry.getCategory())].push_back(m_end_index);
+            // the buffer only grows until it is full for the first time
+            if (const auto pos = position(m_end_index); pos == m_log_entries.size()) {
+                m_log_entries.push_back(std::move(entry));
+            } else {
+                m_log_entries[pos] = std::move(entry);
+            }
+            ++m_size;
+            ++m_end_index;
+        }
+        m_batch.clear();
+        Q_EMIT logEntriesAdded(first_index, count);
+    }
+
+    bool Logger::startPersisting(const QDir& directory, std::uint64_t max_size, const std::optional<QDir>& history) {
+        stopPersisting();
+        m_writer = LogWriter::open(directory, std::min(c_max_segment_size, max_size / 4), max_size, history);
+        if (m_writer == nullptr) {
+            qCWarning(lc_opcua_logger) << "Not persisting the log to" << directory.absolutePath();
+            return false;
+        }
+        return true;
+    }
+
+    void Logger::startPersistingHistory() {
+        if (!log_persist()) {
+            return;
+        }
+        const auto history = historyDirectory();
+        // the names sort in the order the logs were started
+        const auto name = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz");
+        if (!startPersisting(QDir{history.absoluteFilePath(name)}, log_persist_size(), history)) {
+            return;
+        }
+        // entries still queued follow with the next flush
+        for (std::uint64_t index = getFirstIndex(); index < getEndIndex(); ++index) {
+            m_writer->append(at(index));
+        }
+        persist();
+    }
+
+    void Logger::stopPersisting() {
+        m_persist_timer->stop();
+        // the destructor writes everything
+        m_writer.reset();
+    }
+
+    std::optional<QDir> Logger::getPersistDirectory() const {
+        if (m_writer == nullptr) {
+            return std::nullopt;
+        }
+        return m_writer->getDirectory();
+    }
+
+    QDir Logger::historyDirectory() {
+        return QDir{Application::instance().getDataDir().absoluteFilePath(c_history_dir)};
     }
 
     opcua::Logger Logger::getOPCUALogger() noexcept {
         return [this](opcua::LogLevel log_level, opcua::LogCategory log_category, std::string_view message) {
-            log({log_level, log_category, message});
+            // checked before the message is converted
+            if (!admit(static_cast<LogLevel>(log_level), static_cast<LogCategory>(log_category))) {
+                return;
+            }
+            // the exception would have to pass through the C library
+            try {
+                enqueue({log_level, log_category, message});
+            } catch (const std::bad_alloc&) {
+                m_unqueued_count.fetch_add(1, std::memory_order_relaxed);
+            }
         };
     }
+
+    void Logger::setMinLevel(LogCategory category, LogLevel min_level) noexcept {
+        m_min_levels[static_cast<std::size_t>(category)].store(min_level, std::memory_order_relaxed);
+    }
+
+    LogLevel Logger::getMinLevel(LogCategory category) const noexcept {
+        return m_min_levels[static_cast<std::size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    const LogEntry& Logger::at(std::uint64_t index) const {
+        Q_ASSERT(index >= getFirstIndex() && index < getEndIndex());
+        return m_log_entries[position(index)];
+    }
+
+    std::uint64_t Logger::getFirstIndex() const noexcept {
+        return m_end_index - m_size;
+    }
+
+    std::uint64_t Logger::getEndIndex() const noexcept {
+        return m_end_index;
+    }
+
+    std::size_t Logger::size() const noexcept {
+        return m_size;
+    }
+
+    std::size_t Logger::capacity() const noexcept {
+        return m_capacity;
+    }
+
+    std::uint64_t Logger::getDroppedCount() const noexcept {
+        return m_dropped_count + m_unqueued_count.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t Logger::getSuppressedCount() const noexcept {
+        return m_suppressed_count;
+    }
+
+    std::size_t Logger::getBytesUsed() const noexcept {
+        return m_bytes_used;
+    }
+
+    const std::deque<std::uint64_t>& Logger::getIndexesWithMinLevel(LogLevel min_level) const {
+        return m_min_level_indexes.at(static_cast<std::size_t>(min_level));
+    }
+
+    const std::deque<std::uint64_t>& Logger::getIndexesOfCategory(LogCategory category) const {
+        return m_category_indexes.at(static_cast<std::size_t>(category));
+    }
+
+    std::size_t Logger::position(std::uint64_t index) const noexcept {
+        return (m_head + static_cast<std::size_t>(index - getFirstIndex())) % m_capacity;
+    }
+
+    void Logger::scheduleFlush() {
+        if (!m_flush_timer->isActive()) {
+            m_flush_timer->start();
+        }
+    }
+
+    void Logger::scheduleSummary() {
+        if (!m_summary_timer->isActive()) {
+            m_summary_timer->start();
+        }
+    }
+
+    void Logger::persist() {
+        if (m_writer == nullptr) {
+            return;
+        }
+        if (!m_writer->flush()) {
+            qCWarning(lc_opcua_logger) << "Stopped persisting the log to" << m_writer->getDirectory().absolutePath();
+            stopPersisting();
+            return;
+        }
+        // Repeats of the held back entry arriving in the meantime are still collapsed into it.
+        if (m_writer->hasPending() && !m_persist_timer->isActive()) {
+            m_persist_timer->start();
+        }
+    }
+
+    void Logger::persistPending() {
+        if (m_writer != nullptr && !m_writer->flushPending()) {
+            qCWarning(lc_opcua_logger) << "Stopped persisting the log to" << m_writer->getDirectory().absolutePath();
+            stopPersisting();
+        }
+    }
+
+    void Logger::summarizeSuppressed() {
+        bool suppressed_any = false;
+        for (std::size_t category = 0; category < m_rate_limits.size(); ++category) {
+            const auto suppressed = m_rate_limits[category].suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed == 0) {
+                continue;
+            }
+            suppressed_any      = true;
+            m_suppressed_count += suppressed;
+            // bypasses the rate limit, so the summary is never suppressed itself
+            enqueue({LogLevel::WARNING, static_cast<LogCategory>(category),
+                     QString{"%1 messages suppressed by the rate limit"}.arg(suppressed)});
+        }
+        // keeps summarizing while entries are suppressed
+        if (!suppressed_any) {
+            m_summary_timer->stop();
+        }
+    }
 } // namespace magnesia::opcua_qt
@@ -1,50 +1,316 @@
 #pragma once
 
+#include "../qt_version_check.hpp"
 #include "LogEntry.hpp"
+#include "LogWriter.hpp"
+#include "MpscQueue.hpp"
+#include "abstraction/LogCategory.hpp"
+#include "abstraction/LogLevel.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include <open62541pp/Logger.h>
 
+#include <QDir>
 #include <QObject>
+#include <QTimer>
 #include <qtmetamacros.h>
 
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
 namespace magnesia::opcua_qt {
     /**
      * @class Logger
      * @brief Manages all LogEntrys that have been logged with the log function.
+     *
+     * The entries are kept in a ring buffer of fixed capacity. Once it is full, adding an entry drops the oldest one.
+     *
+     * Every added entry gets an index, counting up from 0 in logging order. Indexes are never reused, so an index
+     * refers to the same entry until that entry is dropped. The kept entries have the indexes from getFirstIndex up to
+     * but excluding getEndIndex.
+     *
+     * Entries can be logged from any thread. They are queued and added in batches by the Logger's thread, at most
+     * once per frame. Everything else must only be used from the Logger's thread, unless noted otherwise.
+     *
+     * Before being queued, entries pass a minimum level per category and a token bucket rate limit per category. Both
+     * are checked before an entry from the OPC UA client is even created. Entries exceeding the rate limit are counted
+     * and summarized by a warning once per second.
+     *
+     * Consecutive entries with the same level, category and message are collapsed into the first one, which counts
+     * the repeats. See LogEntry::addRepeat.
+     *
+     * Optionally, entries are persisted to size-rotated segments on disk as they are added, see LogWriter. Unlike the
+     * kept entries, persisted ones survive the Logger and can be browsed with LogArchive.
      */
     class Logger : public QObject {
         Q_OBJECT
+        Q_DISABLE_COPY_MOVE(Logger)
 
       public:
+        /**
+         * @brief Creates a logger configured by the log settings. See startPersistingHistory for persisting its
+         * entries.
+         *
+         * @param parent the QObject parent
+         */
         explicit Logger(QObject* parent = nullptr);
+
         /**
-         * @brief Creates a log from a LogEntry
+         * @param capacity number of entries kept, at least 1
+         * @param rate_limit entries per second and category that are logged, 0 for no limit. Up to a second worth of
+         *                   entries can be logged at once.
+         * @param parent the QObject parent
+         */
+        Logger(std::size_t capacity, std::uint32_t rate_limit, QObject* parent = nullptr);
+
+        ~Logger() override;
+
+        /**
+         * @brief Creates a log from a LogEntry. Safe to call from any thread.
+         *
+         * The entry is added with the next flush. If it can't be queued for lack of memory, it is counted as dropped.
          *
          * @param entry a LogEntry
          */
         void log(LogEntry entry) noexcept;
 
         /**
-         * Retrieves the OPC UA logger.
+         * @brief Adds all queued entries at once.
+         *
+         * Called automatically shortly after entries have been logged.
+         */
+        void flush();
+
+        /**
+         * Starts persisting all entries added from now on. Stops a previous persistence.
+         *
+         * @param directory the directory to write to, see LogWriter::open
+         * @param max_size size in bytes of the persisted log after which the oldest entries are deleted
+         * @param history directory of older logs counting towards max_size, see LogWriter::open
+         *
+         * @return false if the directory can't be written to
+         */
+        bool startPersisting(const QDir& directory, std::uint64_t max_size,
+                             const std::optional<QDir>& history = std::nullopt);
+
+        /**
+         * Starts persisting to a new directory in historyDirectory if enabled by the log settings. The persisted logs
+         * of all connections together are kept below the configured size, the oldest ones are deleted first.
+         *
+         * Meant to be called once the connection is established, so failed attempts don't leave logs behind. The kept
+         * entries, for example those of the connection attempt, are persisted as well.
+         */
+        void startPersistingHistory();
+
+        /**
+         * Stops persisting entries. Entries added so far are written.
+         */
+        void stopPersisting();
+
+        /**
+         * Gets the directory entries are persisted to.
+         *
+         * @return the directory or nullopt if entries aren't persisted
+         */
+        [[nodiscard]] std::optional<QDir> getPersistDirectory() const;
+
+        /**
+         * Gets the directory containing the persisted logs of all connections, one directory per Logger.
+         */
+        [[nodiscard]] static QDir historyDirectory();
+
+        /**
+         * Retrieves the OPC UA logger. It can be used from any thread.
          */
         opcua::Logger getOPCUALogger() noexcept;
 
         /**
-         * Provides access to all log entries.
+         * Sets the minimum level of entries logged for a category. Safe to call from any thread.
+         *
+         * @param category the category
+         * @param min_level the minimum level, entries below it are discarded
+         */
+        void setMinLevel(LogCategory category, LogLevel min_level) noexcept;
+
+        /**
+         * Gets the minimum level of entries logged for a category. Safe to call from any thread.
          *
-         * @return vector of all log entries
+         * @param category the category
          */
-        [[nodiscard]] const std::vector<LogEntry>& getEntries() const {
-            return m_log_entries;
-        }
+        [[nodiscard]] LogLevel getMinLevel(LogCategory category) const noexcept;
+
+        /**
+         * Gets a kept log entry.
+         *
+         * @param index index of the entry, between getFirstIndex and getEndIndex
+         *
+         * @return the entry. Only valid until the next flush.
+         */
+        [[nodiscard]] const LogEntry& at(std::uint64_t index) const;
+
+        /**
+         * Gets the index of the oldest kept entry.
+         */
+        [[nodiscard]] std::uint64_t getFirstIndex() const noexcept;
+
+        /**
+         * Gets the index the next added entry will get. This is also the number of entries added so far.
+         */
+        [[nodiscard]] std::uint64_t getEndIndex() const noexcept;
+
+        /**
+         * Gets the number of kept entries.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * Gets the maximum number of kept entries.
+         */
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        /**
+         * Gets the number of entries dropped to make room for newer ones or because there was no memory left to queue
+         * them.
+         */
+        [[nodiscard]] std::uint64_t getDroppedCount() const noexcept;
+
+        /**
+         * Gets the number of entries suppressed by the rate limit that have been summarized so far.
+         */
+        [[nodiscard]] std::uint64_t getSuppressedCount() const noexcept;
+
+        /**
+         * Gets the approximate number of bytes used by the kept entries.
+         */
+        [[nodiscard]] std::size_t getBytesUsed() const noexcept;
+
+        /**
+         * Gets the indexes of all kept entries with at least the given level. Kept up to date as entries are added and
+         * dropped.
+         *
+         * @param min_level the minimum level
+         *
+         * @return the ascending indexes
+         */
+        [[nodiscard]] const std::deque<std::uint64_t>& getIndexesWithMinLevel(LogLevel min_level) const;
+
+        /**
+         * Gets the indexes of all kept entries of a category. Kept up to date as entries are added and dropped.
+         *
+         * @param category the category
+         *
+         * @return the ascending indexes
+         */
+        [[nodiscard]] const std::deque<std::uint64_t>& getIndexesOfCategory(LogCategory category) const;
 
       private:
+        // position of an index in m_log_entries
+        [[nodiscard]] std::size_t position(std::uint64_t index) const noexcept;
+
+        // checks the minimum level and rate limit, from any thread
+        [[nodiscard]] bool admit(LogLevel level, LogCategory category) noexcept;
+        // queues an admitted entry, from any thread. Counts it as unqueued if that fails.
+        void enqueue(LogEntry entry) noexcept;
+        // starts the flush timer, in the Logger's thread
+        void scheduleFlush();
+        // starts the summary timer, in the Logger's thread
+        void scheduleSummary();
+        // logs the number of suppressed entries per category
+        void summarizeSuppressed();
+        // writes the entries given to the writer
+        void persist();
+        // writes the entry held back by the writer
+        void persistPending();
+
+        static constexpr std::size_t c_level_count    = static_cast<std::size_t>(LogLevel::FATAL) + 1;
+        static constexpr std::size_t c_category_count = static_cast<std::size_t>(LogCategory::APPLICATION) + 1;
+
+        struct RateLimit {
+            std::mutex                            mutex;
+            double                                tokens{0};
+            std::chrono::steady_clock::time_point last_refill;
+            std::atomic_uint64_t                  suppressed{0};
+        };
+
+      private:
+        std::array<std::atomic<LogLevel>, c_category_count> m_min_levels;
+        std::uint32_t                                       m_rate_limit;
+        std::array<RateLimit, c_category_count>             m_rate_limits;
+        QTimer*                                             m_summary_timer;
+        std::uint64_t                                       m_suppressed_count{0};
+
+        MpscQueue<LogEntry>   m_pending;
+        std::atomic_bool      m_flush_scheduled{false};
+        QTimer*               m_flush_timer;
+        // entries that couldn't be queued for lack of memory
+        std::atomic_uint64_t  m_unqueued_count{0};
+        // reused for every flush
+        std::vector<LogEntry> m_batch;
+
+        // nullptr if entries aren't persisted
+        std::unique_ptr<LogWriter> m_writer;
+        QTimer*                    m_persist_timer;
+
+        // grows up to m_capacity, then is overwritten starting with the oldest entry
         std::vector<LogEntry> m_log_entries;
+        std::size_t           m_capacity;
+        // position of the oldest entry
+        std::size_t           m_head{0};
+        std::size_t           m_size{0};
+        std::uint64_t         m_end_index{0};
+        std::uint64_t         m_dropped_count{0};
+        std::size_t           m_bytes_used{0};
+
+        // an entry is in the indexes of all levels up to and including its own
+        std::array<std::deque<std::uint64_t>, c_level_count>    m_min_level_indexes;
+        std::array<std::deque<std::uint64_t>, c_category_count> m_category_indexes;
 
       signals:
-        void logEntryAdded(std::size_t index);
+        /**
+         * Emitted before queued entries are added.
+         *
+         * @param first_index index the first entry will get
+         * @param count number of entries, the entries get consecutive indexes
+         */
+        void logEntriesAboutToBeAdded(std::uint64_t first_index, std::size_t count);
+        /**
+         * Emitted after queued entries have been added.
+         *
+         * @param first_index index of the first entry
+         * @param count number of entries
+         */
+        void logEntriesAdded(std::uint64_t first_index, std::size_t count);
+        /**
+         * Emitted before the oldest entries are dropped.
+         *
+         * @param count number of entries that will be dropped
+         */
+        void logEntriesAboutToBeDropped(std::size_t count);
+        /**
+         * Emitted after the oldest entries have been dropped.
+         *
+         * @param count number of entries that have been dropped
+         */
+        void logEntriesDropped(std::size_t count);
+        /**
+         * Emitted after the newest kept entry has been repeated. The entry stays at its index, but its repeat count and
+         * last time changed.
+         *
+         * @param index index of the entry
+         */
+        void logEntryRepeated(std::uint64_t index);
     };
 } // namespace magnesia::opcua_qt
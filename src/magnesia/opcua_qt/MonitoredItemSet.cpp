@@ -0,0 +1,121 @@
+#include "MonitoredItemSet.hpp"
+
+#include "SubscriptionManager.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/MonitoringMode.hpp"
+#include "abstraction/MonitoringParameters.hpp"
+#include "abstraction/node/Node.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include <QObject>
+
+namespace magnesia::opcua_qt {
+    using abstraction::AttributeId;
+    using abstraction::MonitoringMode;
+    using abstraction::MonitoringParameters;
+    using abstraction::Node;
+
+    MonitoredItemSet::MonitoredItemSet(SubscriptionManager* manager, std::chrono::milliseconds publishing_interval,
+                                       QObject* parent)
+        : QObject(parent), m_manager(manager), m_publishing_interval(publishing_interval) {}
+
+    MonitoredItemSet::~MonitoredItemSet() {
+        if (m_manager.isNull()) {
+            return;
+        }
+        std::vector<SubscriptionManager::ItemHandle> handles;
+        handles.reserve(m_items.size());
+        for (const auto& item : m_items) {
+            handles.push_back(item.handle);
+        }
+        m_manager->deleteItems(handles);
+    }
+
+    void MonitoredItemSet::monitor(std::span<const SubscriptionManager::MonitoredAttribute> attributes,
+                                   const MonitoringParameters&                              parameters) {
+        if (m_manager.isNull()) {
+            return;
+        }
+
+        const auto mode    = m_paused ? MonitoringMode::SAMPLING : MonitoringMode::REPORTING;
+        const auto handles = m_manager->createItems(this, m_publishing_interval, attributes, parameters, mode);
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            if (handles[i] != 0) {
+                const auto& [node, attribute_id] = attributes[i];
+                m_items.push_back({.node = node, .attribute_id = attribute_id, .handle = handles[i]});
+            }
+        }
+    }
+
+    bool MonitoredItemSet::setParameters(Node* node, AttributeId attribute_id, const MonitoringParameters& parameters) {
+        const auto* item = findItem(node, attribute_id);
+        if (item == nullptr || m_manager.isNull()) {
+            return false;
+        }
+        return m_manager->modifyItems(std::array{item->handle}, parameters);
+    }
+
+    std::optional<MonitoringParameters> MonitoredItemSet::getParameters(Node* node, AttributeId attribute_id) const {
+        const auto* item = findItem(node, attribute_id);
+        if (item == nullptr || m_manager.isNull()) {
+            return std::nullopt;
+        }
+        return m_manager->getItemParameters(item->handle);
+    }
+
+    void MonitoredItemSet::unmonitor(std::span<Node* const> nodes) {
+        const std::unordered_set<Node*>              removed(nodes.begin(), nodes.end());
+        std::vector<SubscriptionManager::ItemHandle> handles;
+        std::erase_if(m_items, [&](const Item& item) {
+            if (!removed.contains(item.node)) {
+                return false;
+            }
+            handles.push_back(item.handle);
+            return true;
+        });
+
+        if (!m_manager.isNull()) {
+            m_manager->deleteItems(handles);
+        }
+    }
+
+    std::size_t MonitoredItemSet::size() const noexcept {
+        return m_items.size();
+    }
+
+    void MonitoredItemSet::setPaused(bool paused) {
+        if (m_paused == paused) {
+            return;
+        }
+        m_paused = paused;
+        if (m_manager.isNull() || m_items.empty()) {
+            return;
+        }
+
+        std::vector<SubscriptionManager::ItemHandle> handles;
+        handles.reserve(m_items.size());
+        for (const auto& item : m_items) {
+            handles.push_back(item.handle);
+        }
+        m_manager->setMonitoringMode(handles, paused ? MonitoringMode::SAMPLING : MonitoringMode::REPORTING);
+    }
+
+    bool MonitoredItemSet::isPaused() const noexcept {
+        return m_paused;
+    }
+
+    const MonitoredItemSet::Item* MonitoredItemSet::findItem(Node* node, AttributeId attribute_id) const {
+        const auto item = std::ranges::find_if(m_items, [&](const Item& candidate) {
+            return candidate.node == node && candidate.attribute_id == attribute_id;
+        });
+        return item != m_items.end() ? &*item : nullptr;
+    }
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+#include "SubscriptionManager.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/MonitoringMode.hpp"
+#include "abstraction/MonitoringParameters.hpp"
+#include "abstraction/node/Node.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <QObject>
+#include <QPointer>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class MonitoredItemSet
+     * @brief The monitored attributes of a single user, e.g. a model.
+     *
+     * The items live in subscriptions shared with every other set of the connection, see SubscriptionManager. Deleting
+     * the set deletes its items.
+     */
+    class MonitoredItemSet : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(MonitoredItemSet)
+
+      public:
+        /**
+         * @param manager the subscription manager of the connection
+         * @param publishing_interval publishing interval of the subscriptions the items are put into
+         * @param parent the QObject parent
+         */
+        MonitoredItemSet(SubscriptionManager* manager, std::chrono::milliseconds publishing_interval,
+                         QObject* parent = nullptr);
+        ~MonitoredItemSet() override;
+
+        /**
+         * @brief Starts monitoring attributes. All items are created with as few requests as possible.
+         *
+         * @param attributes the attributes to monitor
+         * @param parameters the requested monitoring parameters of every item
+         */
+        void monitor(std::span<const SubscriptionManager::MonitoredAttribute> attributes,
+                     const abstraction::MonitoringParameters&                  parameters = {});
+
+        /**
+         * @brief Changes the monitoring parameters of a monitored attribute.
+         *
+         * @param node the node of the attribute
+         * @param attribute_id the attribute
+         * @param parameters the requested monitoring parameters
+         *
+         * @return true if the attribute is monitored and the server accepted the parameters
+         */
+        bool setParameters(abstraction::Node* node, abstraction::AttributeId attribute_id,
+                           const abstraction::MonitoringParameters& parameters);
+
+        /**
+         * @brief Gets the monitoring parameters of a monitored attribute, with the sampling interval and queue size
+         * revised by the server.
+         *
+         * @return the parameters or nullopt if the attribute isn't monitored
+         */
+        [[nodiscard]] std::optional<abstraction::MonitoringParameters>
+        getParameters(abstraction::Node* node, abstraction::AttributeId attribute_id) const;
+
+        /**
+         * @brief Stops monitoring all attributes of the given nodes.
+         *
+         * @param nodes the nodes to stop monitoring
+         */
+        void unmonitor(std::span<abstraction::Node* const> nodes);
+
+        /**
+         * @brief Gets the number of successfully created monitored items.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Pauses or resumes reporting of all items, e.g. while their view is hidden.
+         *
+         * Paused items are put into sampling mode: the server keeps sampling them but doesn't send notifications.
+         * Resuming switches them back to reporting, which makes the server report the latest sampled values right away.
+         * Items monitored while paused are created in sampling mode.
+         *
+         * @param paused whether to pause reporting
+         */
+        void setPaused(bool paused);
+
+        /**
+         * @brief Checks if reporting is paused.
+         */
+        [[nodiscard]] bool isPaused() const noexcept;
+
+      signals:
+        /**
+         * @brief Gets emitted when a monitored attribute changed. The node's cache is already updated and shares the
+         * value.
+         */
+        void valueChanged(abstraction::Node* node, abstraction::AttributeId attribute_id,
+                          std::shared_ptr<const abstraction::DataValue> value);
+
+      private:
+        struct Item {
+            abstraction::Node*              node;
+            abstraction::AttributeId        attribute_id;
+            SubscriptionManager::ItemHandle handle;
+        };
+
+        /**
+         * @brief Finds the item monitoring an attribute.
+         */
+        [[nodiscard]] const Item* findItem(abstraction::Node* node, abstraction::AttributeId attribute_id) const;
+
+      private:
+        QPointer<SubscriptionManager> m_manager;
+        std::chrono::milliseconds     m_publishing_interval;
+        std::vector<Item>             m_items;
+        bool                          m_paused{false};
+    };
+} // namespace magnesia::opcua_qt
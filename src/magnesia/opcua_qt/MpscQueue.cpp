@@ -0,0 +1 @@
+#include "MpscQueue.hpp"
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class MpscQueue
+     * @brief Unbounded lock-free queue with any number of producers and a single consumer.
+     *
+     * Pushing never blocks and can be done from any thread. Popping must only ever be done by one thread at a time.
+     * Based on Dmitry Vyukov's intrusive MPSC node-based queue.
+     *
+     * @tparam T type of the queued values
+     */
+    template<typename T>
+    class MpscQueue {
+        Q_DISABLE_COPY_MOVE(MpscQueue)
+
+      public:
+        MpscQueue() : m_head(new QueueNode), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+        ~MpscQueue() {
+            while (tryPop().has_value()) {}
+            delete m_tail;
+        }
+
+        /**
+         * @brief Appends a value to the queue. Safe to call from any thread.
+         *
+         * @param value the value to append
+         */
+        void push(T value) {
+            auto* node = new QueueNode{std::move(value)};
+            auto* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        /**
+         * @brief Removes the oldest value from the queue. Must only be called by the consumer.
+         *
+         * A value whose push has not completed yet may not be visible, a later call will return it.
+         *
+         * @return the oldest value or nullopt if the queue is empty
+         */
+        std::optional<T> tryPop() {
+            auto* tail = m_tail;
+            auto* next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return std::nullopt;
+            }
+
+            std::optional<T> value{std::move(next->value)};
+            next->value.reset();
+            m_tail = next;
+            delete tail;
+            return value;
+        }
+
+        /**
+         * @brief Checks if there are values ready to be popped. Must only be called by the consumer.
+         */
+        [[nodiscard]] bool empty() const noexcept {
+            return m_tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+      private:
+        struct QueueNode {
+            std::optional<T>        value;
+            std::atomic<QueueNode*> next{nullptr};
+        };
+
+        std::atomic<QueueNode*> m_head;
+        QueueNode*              m_tail;
+    };
+} // namespace magnesia::opcua_qt
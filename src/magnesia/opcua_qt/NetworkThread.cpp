@@ -0,0 +1,158 @@
+#include "NetworkThread.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include <open62541/client.h>
+#include <open62541/client_config.h>
+#include <open62541/network_tcp.h>
+#include <open62541/plugin/network.h>
+#include <open62541pp/Client.h>
+#include <open62541pp/ErrorHandling.h>
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtTypes>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_network, "magnesia.opcua.network")
+
+    // Where the network thread running on this thread wants the connection of its client reported.
+    thread_local UA_Connection** t_connection{nullptr};
+
+    // open62541 doesn't expose the connection of a client. It is passed to this function while the TCP connection is
+    // opened, which only happens when the client is iterated.
+    UA_StatusCode poll_tcp_connection(UA_Connection* connection, UA_UInt32 timeout, const UA_Logger* logger) {
+        if (t_connection != nullptr) {
+            *t_connection = connection;
+        }
+        return UA_ClientConnectionTCP_poll(connection, timeout, logger);
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    NetworkThread::NetworkThread(opcua::Client& client, std::recursive_mutex& client_mutex,
+                                 const std::atomic<std::size_t>& client_waiters, std::chrono::milliseconds interval,
+                                 std::function<void()> on_iterated, QObject* parent)
+        : QThread(parent), m_client(client), m_client_mutex(client_mutex), m_client_waiters(client_waiters),
+          m_interval(interval), m_on_iterated(std::move(on_iterated)) {
+        setObjectName("opcua network");
+    }
+
+    NetworkThread::~NetworkThread() {
+        stop();
+    }
+
+    void NetworkThread::stop() {
+        quit();
+        wait();
+    }
+
+    void NetworkThread::run() {
+        {
+            const std::unique_lock client_lock(m_client_mutex);
+            auto*                  config = UA_Client_getConfig(m_client.handle());
+            // other connection plugins aren't known to use sockets, they are only iterated by the fallback timer
+            if (config->pollConnectionFunc == UA_ClientConnectionTCP_poll) {
+                config->pollConnectionFunc = poll_tcp_connection;
+            }
+        }
+        t_connection = &m_connection;
+
+        // Created on this thread, so their events are delivered to the event loop below.
+        QTimer          fallback_timer;
+        QSocketNotifier read_notifier{QSocketNotifier::Read};
+        QSocketNotifier write_notifier{QSocketNotifier::Write};
+        fallback_timer.setSingleShot(true);
+        m_fallback_timer = &fallback_timer;
+        m_read_notifier  = &read_notifier;
+        m_write_notifier = &write_notifier;
+
+        connect(&fallback_timer, &QTimer::timeout, &fallback_timer, [this] { iterate(); });
+        connect(&read_notifier, &QSocketNotifier::activated, &read_notifier, [this] { iterate(); });
+        connect(&write_notifier, &QSocketNotifier::activated, &write_notifier, [this] { iterate(); });
+
+        iterate();
+        exec();
+
+        m_fallback_timer = nullptr;
+        m_read_notifier  = nullptr;
+        m_write_notifier = nullptr;
+        t_connection     = nullptr;
+    }
+
+    void NetworkThread::iterate() {
+        yieldToClientWaiters();
+
+        bool               failed{false};
+        bool               progressed{false};
+        UA_SOCKET          socket{UA_INVALID_SOCKET};
+        UA_ConnectionState connection_state{UA_CONNECTIONSTATE_CLOSED};
+        {
+            const std::unique_lock client_lock(m_client_mutex);
+            try {
+                // Doesn't wait for the socket, that happens in the event loop without holding the client mutex.
+                m_client.runIterate(0);
+            } catch (const opcua::BadStatus& status) {
+                qCDebug(lc_opcua_network) << "Failed to iterate client:" << status.what();
+                failed = true;
+            }
+            if (m_on_iterated) {
+                std::invoke(m_on_iterated);
+            }
+
+            if (m_connection != nullptr) {
+                socket           = m_connection->sockfd;
+                connection_state = m_connection->state;
+            }
+            UA_SecureChannelState channel_state{};
+            UA_SessionState       session_state{};
+            UA_Client_getState(m_client.handle(), &channel_state, &session_state, nullptr);
+            // The next step of a connection attempt might not need data from the server, e.g. sending HEL once the
+            // TCP connection is established.
+            progressed = std::tie(connection_state, channel_state, session_state)
+                      != std::tie(m_connection_state, m_channel_state, m_session_state);
+            m_connection_state = connection_state;
+            m_channel_state    = channel_state;
+            m_session_state    = session_state;
+        }
+
+        // Re-registers the socket, it may have been closed and its descriptor reused.
+        m_read_notifier->setEnabled(false);
+        m_write_notifier->setEnabled(false);
+        // A failing client might keep its socket readable, don't spin on it.
+        if (!failed && socket != UA_INVALID_SOCKET) {
+            // a connecting socket becomes writable once the TCP connection is established
+            auto* notifier = connection_state == UA_CONNECTIONSTATE_OPENING ? m_write_notifier : m_read_notifier;
+            notifier->setSocket(static_cast<qintptr>(socket));
+            notifier->setEnabled(true);
+        }
+
+        if (progressed && !failed) {
+            m_fallback_timer->start(0);
+        } else {
+            // Timers of the client, like secure channel renewal and request timeouts, aren't tied to the socket.
+            // open62541 doesn't tell when the next one is due, so the interval bounds how late they run.
+            m_fallback_timer->start(m_interval);
+        }
+    }
+
+    void NetworkThread::yieldToClientWaiters() const {
+        for (auto waiters = m_client_waiters.load(); waiters != 0; waiters = m_client_waiters.load()) {
+            m_client_waiters.wait(waiters);
+        }
+    }
+} // namespace magnesia::opcua_qt
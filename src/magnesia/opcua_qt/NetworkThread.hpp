@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+#include <open62541/client.h>
+#include <open62541/plugin/network.h>
+#include <open62541pp/Client.h>
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class NetworkThread
+     * @brief Worker thread driving the event loop of an OPC UA client.
+     *
+     * The thread runs a Qt event loop that watches the socket of the client. The client is only iterated when its
+     * socket becomes readable, a connection attempt made progress or the fallback interval elapsed. Waiting happens
+     * without holding the client mutex, it is only held for the non-blocking iterations, so other threads can use
+     * the client in between. Threads waiting for the client mutex are given precedence over the next iteration.
+     *
+     * @see Connection
+     */
+    class NetworkThread : public QThread {
+        Q_DISABLE_COPY_MOVE(NetworkThread)
+
+      public:
+        /**
+         * @param client the client to drive
+         * @param client_mutex the mutex protecting every access to the client
+         * @param client_waiters number of threads currently waiting for the client mutex
+         * @param interval longest time between two iterations and back-off after failed iterations. Timers of the
+         *                 client that aren't tied to its socket run at most this late.
+         * @param on_iterated called on the network thread after every iteration while still holding the client mutex
+         * @param parent the QObject parent
+         */
+        NetworkThread(opcua::Client& client, std::recursive_mutex& client_mutex,
+                      const std::atomic<std::size_t>& client_waiters, std::chrono::milliseconds interval,
+                      std::function<void()> on_iterated, QObject* parent = nullptr);
+        ~NetworkThread() override;
+
+        /**
+         * @brief Stops iterating the client and waits for the thread to finish.
+         *
+         * Must not be called while holding the client mutex.
+         */
+        void stop();
+
+      protected:
+        void run() override;
+
+      private:
+        /**
+         * @brief Iterates the client without waiting and decides when to iterate next.
+         */
+        void iterate();
+
+        /**
+         * @brief Blocks until no other thread is waiting for the client mutex.
+         */
+        void yieldToClientWaiters() const;
+
+        opcua::Client&                  m_client;
+        std::recursive_mutex&           m_client_mutex;
+        const std::atomic<std::size_t>& m_client_waiters;
+        std::chrono::milliseconds       m_interval;
+        std::function<void()>           m_on_iterated;
+
+        // reported while the client opens its TCP connection, lives as long as the client
+        UA_Connection* m_connection{nullptr};
+        // state after the last iteration, a change means a connection attempt made progress
+        UA_ConnectionState    m_connection_state{UA_CONNECTIONSTATE_CLOSED};
+        UA_SecureChannelState m_channel_state{UA_SECURECHANNELSTATE_FRESH};
+        UA_SessionState       m_session_state{UA_SESSIONSTATE_CLOSED};
+
+        // only exist on the network thread while it runs
+        QTimer*          m_fallback_timer{nullptr};
+        QSocketNotifier* m_read_notifier{nullptr};
+        QSocketNotifier* m_write_notifier{nullptr};
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,144 @@
+#include "RecordingReplay.hpp"
+
+#include "RecordingSegment.hpp"
+#include "RecordingWriter.hpp"
+#include "TimeSeries.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <QDir>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QTimer>
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_recording_replay, "magnesia.opcua.recording_replay")
+
+    constexpr std::chrono::milliseconds c_step_interval{20};
+    // bounds the time spent in a single step, so the UI stays responsive at maximum speed
+    constexpr std::size_t               c_max_records_per_step = 20000;
+    constexpr int                       c_fast_factor          = 10;
+} // namespace
+
+namespace magnesia::opcua_qt {
+    RecordingReplay::RecordingReplay(std::vector<std::unique_ptr<RecordingSegment>> segments, QObject* parent)
+        : QObject(parent), m_segments(std::move(segments)),
+          m_offset(m_segments.front()->seek(TimeSeries::TimePoint::min())),
+          m_position(getStart().value_or(TimeSeries::TimePoint{})), m_timer(new QTimer(this)) {
+        m_timer->setInterval(c_step_interval);
+        connect(m_timer, &QTimer::timeout, this, &RecordingReplay::step);
+    }
+
+    RecordingReplay* RecordingReplay::open(const QDir& directory, QObject* parent) {
+        std::vector<std::unique_ptr<RecordingSegment>> segments;
+        // the numbered names sort in recording order
+        for (const auto& name : directory.entryList({RecordingWriter::segmentNameFilter()}, QDir::Files, QDir::Name)) {
+            if (auto segment = RecordingSegment::open(directory.absoluteFilePath(name)); segment != nullptr) {
+                segments.push_back(std::move(segment));
+            }
+        }
+        if (segments.empty()) {
+            qCWarning(lc_opcua_recording_replay) << "No recording in" << directory.absolutePath();
+            return nullptr;
+        }
+        return new RecordingReplay{std::move(segments), parent};
+    }
+
+    void RecordingReplay::start() {
+        m_last_step = std::chrono::steady_clock::now();
+        m_timer->start();
+    }
+
+    void RecordingReplay::pause() {
+        m_timer->stop();
+    }
+
+    bool RecordingReplay::isRunning() const {
+        return m_timer->isActive();
+    }
+
+    void RecordingReplay::setSpeed(Speed speed) {
+        m_speed = speed;
+    }
+
+    RecordingReplay::Speed RecordingReplay::getSpeed() const noexcept {
+        return m_speed;
+    }
+
+    std::optional<TimeSeries::TimePoint> RecordingReplay::getStart() const {
+        for (const auto& segment : m_segments) {
+            if (const auto start = segment->getStart(); start.has_value()) {
+                return start;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<TimeSeries::TimePoint> RecordingReplay::getEnd() const {
+        for (auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment) {
+            if (const auto end = (*segment)->getEnd(); end.has_value()) {
+                return end;
+            }
+        }
+        return std::nullopt;
+    }
+
+    TimeSeries::TimePoint RecordingReplay::getPosition() const noexcept {
+        return m_position;
+    }
+
+    void RecordingReplay::step() {
+        const auto now     = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<TimeSeries::Duration>(now - m_last_step);
+        m_last_step        = now;
+
+        auto until = TimeSeries::TimePoint::max();
+        switch (m_speed) {
+            case Speed::REAL_TIME:
+                until = m_position + elapsed;
+                break;
+            case Speed::TEN_TIMES:
+                until = m_position + elapsed * c_fast_factor;
+                break;
+            case Speed::MAXIMUM:
+                break;
+        }
+
+        m_batch.clear();
+        while (m_segment < m_segments.size() && m_batch.size() < c_max_records_per_step) {
+            const auto& segment = *m_segments[m_segment];
+            m_offset = segment.read(m_offset, until, c_max_records_per_step - m_batch.size(),
+                                    [this](RecordingSegment::Record&& record) {
+                                        m_batch.push_back(std::move(record));
+                                    });
+            if (m_offset < segment.getEndOffset()) {
+                break;
+            }
+            if (++m_segment < m_segments.size()) {
+                m_offset = m_segments[m_segment]->seek(TimeSeries::TimePoint::min());
+            }
+        }
+
+        // Limited by the batch size the replay falls behind and continues from the last replayed record.
+        if (m_batch.size() == c_max_records_per_step || until == TimeSeries::TimePoint::max()) {
+            if (!m_batch.empty()) {
+                m_position = m_batch.back().time;
+            }
+        } else {
+            m_position = until;
+        }
+
+        if (!m_batch.empty()) {
+            Q_EMIT recordsReplayed(m_batch);
+        }
+        if (m_segment >= m_segments.size()) {
+            m_timer->stop();
+            Q_EMIT finished();
+        }
+    }
+} // namespace magnesia::opcua_qt
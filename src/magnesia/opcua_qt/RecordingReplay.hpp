@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+#include "RecordingSegment.hpp"
+#include "TimeSeries.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QDir>
+#include <QObject>
+#include <QTimer>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class RecordingReplay
+     * @brief Plays back a recording written by RecordingWriter.
+     *
+     * The segments are memory-mapped and read a batch at a time, the recording is never loaded as a whole. Replayed
+     * records are emitted in batches, e.g. for SubscriptionManager::replay.
+     */
+    class RecordingReplay : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(RecordingReplay)
+
+      public:
+        /**
+         * @brief Playback speeds.
+         */
+        enum class Speed : std::uint8_t {
+            /// As fast as the values were recorded.
+            REAL_TIME,
+            /// Ten times as fast as the values were recorded.
+            TEN_TIMES,
+            /// As fast as possible.
+            MAXIMUM,
+        };
+        Q_ENUM(Speed)
+
+        /**
+         * @brief Opens a recording. The replay is paused at its start.
+         *
+         * @param directory directory of the recording
+         * @param parent the QObject parent
+         *
+         * @return the replay or nullptr if the directory contains no readable segment
+         */
+        [[nodiscard]] static RecordingReplay* open(const QDir& directory, QObject* parent = nullptr);
+
+        /**
+         * @brief Starts or continues the playback.
+         */
+        void start();
+
+        /**
+         * @brief Pauses the playback.
+         */
+        void pause();
+
+        /**
+         * @brief Checks if the playback is running.
+         */
+        [[nodiscard]] bool isRunning() const;
+
+        /**
+         * @brief Changes the playback speed, also while running.
+         */
+        void setSpeed(Speed speed);
+
+        /**
+         * @brief Gets the playback speed.
+         */
+        [[nodiscard]] Speed getSpeed() const noexcept;
+
+        /**
+         * @brief Gets the receive time of the first recorded value.
+         */
+        [[nodiscard]] std::optional<TimeSeries::TimePoint> getStart() const;
+
+        /**
+         * @brief Gets the receive time of the last recorded value.
+         */
+        [[nodiscard]] std::optional<TimeSeries::TimePoint> getEnd() const;
+
+        /**
+         * @brief Gets the recorded time up to which values have been replayed.
+         */
+        [[nodiscard]] TimeSeries::TimePoint getPosition() const noexcept;
+
+      signals:
+        /**
+         * Emitted for every batch of replayed records.
+         *
+         * @param records the records in the order they were recorded. Only valid during the call.
+         */
+        void recordsReplayed(const std::vector<magnesia::opcua_qt::RecordingSegment::Record>& records);
+
+        /**
+         * Emitted once all records have been replayed.
+         */
+        void finished();
+
+      private:
+        RecordingReplay(std::vector<std::unique_ptr<RecordingSegment>> segments, QObject* parent);
+
+        /**
+         * @brief Replays the records due since the last step.
+         */
+        void step();
+
+      private:
+        // in recording order
+        std::vector<std::unique_ptr<RecordingSegment>> m_segments;
+        std::size_t                                    m_segment{0};
+        std::uint64_t                                  m_offset;
+        TimeSeries::TimePoint                          m_position;
+
+        QTimer*                               m_timer;
+        Speed                                 m_speed{Speed::REAL_TIME};
+        std::chrono::steady_clock::time_point m_last_step{};
+        // reused for every batch
+        std::vector<RecordingSegment::Record> m_batch;
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,396 @@
+#include "RecordingSegment.hpp"
+
+#include "../qt_version_check.hpp"
+#include "SegmentFile.hpp"
+#include "TimeSeries.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <open62541/types.h>
+#include <open62541/types_generated.h>
+#include <open62541pp/ErrorHandling.h>
+#include <open62541pp/types/DataValue.h>
+#include <open62541pp/types/NodeId.h>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QLoggingCategory>
+#include <QString>
+#include <QtEndian>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_recording, "magnesia.opcua.recording")
+
+    using magnesia::opcua_qt::SegmentFile;
+    using magnesia::opcua_qt::TimeSeries;
+
+    constexpr SegmentFile::Magic c_index_magic{'M', 'G', 'N', 'I', 'D', 'X', '0', '1'};
+
+    // time (8), node index (4), attribute id (4)
+    constexpr std::uint64_t c_value_header_size = 16;
+    // value records per block of the index
+    constexpr std::uint64_t c_block_records     = 1024;
+
+    enum class RecordKind : std::uint8_t {
+        NODE  = 1,
+        VALUE = 2,
+    };
+
+    void append_encoded(QByteArray& buffer, const void* value, const UA_DataType& type) {
+        const auto size  = UA_calcSizeBinary(value, &type);
+        const auto start = buffer.size();
+        buffer.resize(start + static_cast<qsizetype>(size));
+        // encodes into the given buffer since it isn't empty
+        UA_ByteString target{size, reinterpret_cast<UA_Byte*>(buffer.data() + start)};
+        opcua::throwIfBad(UA_encodeBinary(value, &type, &target));
+    }
+
+    bool decode(const uchar* data, std::size_t size, void* target, const UA_DataType& type) {
+        // shallow, decoding copies
+        const UA_ByteString encoded{size, const_cast<UA_Byte*>(data)};
+        return UA_decodeBinary(&encoded, target, &type, nullptr) == UA_STATUSCODE_GOOD;
+    }
+
+    // Validates the record at offset. Returns nullopt if it is incomplete, corrupt or not a recording record.
+    std::optional<SegmentFile::Record> parse_record(const SegmentFile& file, std::uint64_t end, std::uint64_t offset) {
+        auto record = file.parseRecord(offset, end);
+        if (!record.has_value()) {
+            return std::nullopt;
+        }
+        const auto kind = static_cast<RecordKind>(record->kind);
+        if (kind != RecordKind::NODE && kind != RecordKind::VALUE) {
+            return std::nullopt;
+        }
+        if (kind == RecordKind::VALUE && record->size < c_value_header_size) {
+            return std::nullopt;
+        }
+        return record;
+    }
+
+    bool is_value(const SegmentFile::Record& record) {
+        return static_cast<RecordKind>(record.kind) == RecordKind::VALUE;
+    }
+
+    TimeSeries::TimePoint value_time(const SegmentFile::Record& record) {
+        return TimeSeries::TimePoint{TimeSeries::Duration{qFromLittleEndian<std::int64_t>(record.payload)}};
+    }
+
+    std::uint32_t value_node_index(const SegmentFile::Record& record) {
+        return qFromLittleEndian<std::uint32_t>(record.payload + 8);
+    }
+
+    std::optional<magnesia::opcua_qt::RecordingSegment::Record>
+    decode_value(const SegmentFile::Record&                            record,
+                 const std::vector<magnesia::opcua_qt::abstraction::NodeId>& node_ids) {
+        const auto node_index = value_node_index(record);
+        if (node_index >= node_ids.size()) {
+            return std::nullopt;
+        }
+        opcua::DataValue value;
+        if (!decode(record.payload + c_value_header_size, record.size - c_value_header_size, value.handle(),
+                    UA_TYPES[UA_TYPES_DATAVALUE])) {
+            return std::nullopt;
+        }
+        return magnesia::opcua_qt::RecordingSegment::Record{
+            .time         = value_time(record),
+            .node_id      = node_ids[node_index],
+            .attribute_id = static_cast<magnesia::opcua_qt::abstraction::AttributeId>(
+                qFromLittleEndian<std::int32_t>(record.payload + 12)),
+            .value        = std::make_shared<const magnesia::opcua_qt::abstraction::DataValue>(std::move(value)),
+        };
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    using abstraction::AttributeId;
+    using abstraction::DataValue;
+    using abstraction::NodeId;
+
+    RecordingSegment::RecordingSegment(std::unique_ptr<SegmentFile> file) : m_file(std::move(file)) {}
+
+    std::unique_ptr<RecordingSegment> RecordingSegment::open(const QString& path) {
+        auto file = SegmentFile::open(path, c_magic);
+        if (file == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<RecordingSegment> segment{new RecordingSegment{std::move(file)}};
+        if (!segment->loadIndex()) {
+            segment->scan();
+        }
+        return segment;
+    }
+
+    std::size_t RecordingSegment::size() const noexcept {
+        return m_index.record_count;
+    }
+
+    std::optional<TimeSeries::TimePoint> RecordingSegment::getStart() const noexcept {
+        if (m_index.blocks.empty()) {
+            return std::nullopt;
+        }
+        return m_index.blocks.front().first;
+    }
+
+    std::optional<TimeSeries::TimePoint> RecordingSegment::getEnd() const noexcept {
+        if (m_index.blocks.empty()) {
+            return std::nullopt;
+        }
+        return m_index.blocks.back().last;
+    }
+
+    const std::vector<NodeId>& RecordingSegment::getNodeIds() const noexcept {
+        return m_index.node_ids;
+    }
+
+    std::uint64_t RecordingSegment::seek(TimeSeries::TimePoint time) const {
+        // the first block that isn't entirely before time
+        const auto block = std::ranges::partition_point(m_index.blocks,
+                                                        [time](const Block& block) { return block.last < time; });
+        if (block == m_index.blocks.end()) {
+            return getEndOffset();
+        }
+
+        auto offset = block->offset;
+        while (const auto record = parse_record(*m_file, m_index.data_size, offset)) {
+            if (is_value(*record) && value_time(*record) >= time) {
+                return offset;
+            }
+            offset = record->next;
+        }
+        return getEndOffset();
+    }
+
+    std::uint64_t RecordingSegment::getEndOffset() const noexcept {
+        return m_index.data_size;
+    }
+
+    std::uint64_t RecordingSegment::read(std::uint64_t offset, TimeSeries::TimePoint until, std::size_t max_count,
+                                         const std::function<void(Record&&)>& on_record) const {
+        std::size_t count{0};
+        while (offset < m_index.data_size && count < max_count) {
+            const auto record = parse_record(*m_file, m_index.data_size, offset);
+            if (!record.has_value()) {
+                // corrupted since the index was built
+                qCWarning(lc_opcua_recording) << "Corrupt record in" << m_file->getPath() << "at" << offset;
+                return getEndOffset();
+            }
+            if (is_value(*record)) {
+                if (value_time(*record) >= until) {
+                    break;
+                }
+                if (auto value = decode_value(*record, m_index.node_ids); value.has_value()) {
+                    on_record(std::move(*value));
+                }
+                ++count;
+            }
+            offset = record->next;
+        }
+        return offset;
+    }
+
+    void RecordingSegment::readNode(const NodeId& node_id, TimeSeries::TimePoint from, TimeSeries::TimePoint to,
+                                    const std::function<void(Record&&)>& on_record) const {
+        const auto node = std::ranges::find(m_index.node_ids, node_id);
+        if (node == m_index.node_ids.end()) {
+            return;
+        }
+        const auto node_index = static_cast<std::uint32_t>(node - m_index.node_ids.begin());
+
+        for (const auto block_number : m_index.node_blocks[node_index]) {
+            const auto& block = m_index.blocks[block_number];
+            if (block.last < from || block.first >= to) {
+                continue;
+            }
+            auto          offset = block.offset;
+            std::uint64_t values{0};
+            while (values < c_block_records) {
+                const auto record = parse_record(*m_file, m_index.data_size, offset);
+                if (!record.has_value()) {
+                    break;
+                }
+                offset = record->next;
+                if (!is_value(*record)) {
+                    continue;
+                }
+                ++values;
+                const auto time = value_time(*record);
+                if (value_node_index(*record) != node_index || time < from || time >= to) {
+                    continue;
+                }
+                if (auto value = decode_value(*record, m_index.node_ids); value.has_value()) {
+                    on_record(std::move(*value));
+                }
+            }
+        }
+    }
+
+    void RecordingSegment::appendNodeRecord(QByteArray& buffer, std::uint32_t node_index, const NodeId& node_id) {
+        const auto start = SegmentFile::beginRecord(buffer);
+        SegmentFile::appendLittleEndian(buffer, node_index);
+        append_encoded(buffer, node_id.handle().handle(), UA_TYPES[UA_TYPES_NODEID]);
+        SegmentFile::endRecord(buffer, start, static_cast<std::uint8_t>(RecordKind::NODE));
+    }
+
+    void RecordingSegment::appendValueRecord(QByteArray& buffer, TimeSeries::TimePoint time, std::uint32_t node_index,
+                                             AttributeId attribute_id, const DataValue& value) {
+        const auto start = SegmentFile::beginRecord(buffer);
+        SegmentFile::appendLittleEndian(buffer, static_cast<std::int64_t>(time.time_since_epoch().count()));
+        SegmentFile::appendLittleEndian(buffer, node_index);
+        SegmentFile::appendLittleEndian(buffer, static_cast<std::int32_t>(attribute_id));
+        append_encoded(buffer, value.handle().handle(), UA_TYPES[UA_TYPES_DATAVALUE]);
+        SegmentFile::endRecord(buffer, start, static_cast<std::uint8_t>(RecordKind::VALUE));
+    }
+
+    void RecordingSegment::indexRecord(Index& index, std::uint64_t offset, TimeSeries::TimePoint time,
+                                       std::uint32_t node_index) {
+        if (index.record_count % c_block_records == 0) {
+            index.blocks.push_back({.first = time, .last = time, .offset = offset});
+        } else {
+            index.blocks.back().last = time;
+        }
+        ++index.record_count;
+
+        if (index.node_blocks.size() <= node_index) {
+            index.node_blocks.resize(node_index + 1);
+        }
+        const auto block_number = static_cast<std::uint32_t>(index.blocks.size() - 1);
+        auto&      node_blocks  = index.node_blocks[node_index];
+        if (node_blocks.empty() || node_blocks.back() != block_number) {
+            node_blocks.push_back(block_number);
+        }
+    }
+
+    QByteArray RecordingSegment::encodeIndex(const Index& index) {
+        return SegmentFile::encodeIndex(c_index_magic, [&index](QDataStream& out) {
+            out << static_cast<quint64>(index.data_size) << static_cast<quint64>(index.record_count);
+            out << static_cast<quint32>(index.node_ids.size());
+            for (const auto& node_id : index.node_ids) {
+                out << node_id.toString();
+            }
+            out << static_cast<quint32>(index.blocks.size());
+            for (const auto& block : index.blocks) {
+                out << static_cast<qint64>(block.first.time_since_epoch().count())
+                    << static_cast<qint64>(block.last.time_since_epoch().count()) << static_cast<quint64>(block.offset);
+            }
+            // one entry per node, see loadIndex
+            Q_ASSERT(index.node_blocks.size() == index.node_ids.size());
+            for (const auto& node_blocks : index.node_blocks) {
+                out << static_cast<quint32>(node_blocks.size());
+                for (const auto block_number : node_blocks) {
+                    out << static_cast<quint32>(block_number);
+                }
+            }
+        });
+    }
+
+    bool RecordingSegment::loadIndex() {
+        Index      index;
+        const auto read = [this, &index](QDataStream& in) {
+            quint64 data_size{0};
+            quint64 record_count{0};
+            quint32 node_count{0};
+            in >> data_size >> record_count >> node_count;
+            if (in.status() != QDataStream::Ok || data_size > m_file->size()) {
+                return false;
+            }
+            index.data_size    = data_size;
+            index.record_count = record_count;
+            for (quint32 i = 0; i < node_count && in.status() == QDataStream::Ok; ++i) {
+                QString node_id;
+                in >> node_id;
+                auto parsed = NodeId::fromString(node_id);
+                if (!parsed.has_value()) {
+                    return false;
+                }
+                index.node_ids.push_back(std::move(*parsed));
+            }
+
+            quint32 block_count{0};
+            in >> block_count;
+            for (quint32 i = 0; i < block_count && in.status() == QDataStream::Ok; ++i) {
+                qint64  first{0};
+                qint64  last{0};
+                quint64 offset{0};
+                in >> first >> last >> offset;
+                if (offset >= data_size) {
+                    return false;
+                }
+                index.blocks.push_back({.first  = TimeSeries::TimePoint{TimeSeries::Duration{first}},
+                                        .last   = TimeSeries::TimePoint{TimeSeries::Duration{last}},
+                                        .offset = offset});
+            }
+
+            index.node_blocks.resize(index.node_ids.size());
+            for (auto& node_blocks : index.node_blocks) {
+                quint32 count{0};
+                in >> count;
+                for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                    quint32 block_number{0};
+                    in >> block_number;
+                    if (block_number >= index.blocks.size()) {
+                        return false;
+                    }
+                    node_blocks.push_back(block_number);
+                }
+            }
+            return true;
+        };
+        if (!m_file->readIndex(c_index_magic, read)) {
+            return false;
+        }
+
+        m_index = std::move(index);
+        return true;
+    }
+
+    void RecordingSegment::scan() {
+        Index index;
+        auto  offset = SegmentFile::firstRecordOffset();
+        while (const auto record = parse_record(*m_file, m_file->size(), offset)) {
+            if (!is_value(*record)) {
+                if (record->size < sizeof(std::uint32_t)
+                    || qFromLittleEndian<std::uint32_t>(record->payload) != index.node_ids.size()) {
+                    break;
+                }
+                opcua::NodeId node_id;
+                if (!decode(record->payload + sizeof(std::uint32_t), record->size - sizeof(std::uint32_t),
+                            node_id.handle(), UA_TYPES[UA_TYPES_NODEID])) {
+                    break;
+                }
+                index.node_ids.emplace_back(std::move(node_id));
+                index.node_blocks.emplace_back();
+            } else {
+                const auto node_index = value_node_index(*record);
+                if (node_index >= index.node_ids.size()) {
+                    break;
+                }
+                indexRecord(index, offset, value_time(*record), node_index);
+            }
+            offset = record->next;
+        }
+        index.data_size = offset;
+
+        if (offset < m_file->size()) {
+            qCInfo(lc_opcua_recording) << "Ignoring" << m_file->size() - offset
+                                       << "bytes after the last complete record of" << m_file->getPath();
+        }
+        m_index = std::move(index);
+    }
+} // namespace magnesia::opcua_qt
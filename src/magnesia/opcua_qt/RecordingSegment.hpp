@@ -0,0 +1,184 @@
+#pragma once
+
+#include "SegmentFile.hpp"
+#include "TimeSeries.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class RecordingSegment
+     * @brief A read-only, memory-mapped segment of a recording of data changes.
+     *
+     * A segment is a SegmentFile, so a segment cut short by a crash is read up to its last complete record. There are
+     * two kinds of records:
+     *  - node records assign a segment-local index to a NodeId. They come before the first value of the node, so
+     *    every segment can be read on its own.
+     *  - value records hold the receive time, node index, attribute id and the binary encoded DataValue.
+     *
+     * The index of a segment is written to a file next to it once the segment is complete. It holds the time range
+     * of every block of value records and the blocks each node has values in. Segments without an index, e.g. after a
+     * crash, are scanned once when opened.
+     *
+     * @see RecordingWriter
+     * @see RecordingReplay
+     */
+    class RecordingSegment {
+      public:
+        /// Magic number every segment starts with.
+        static constexpr SegmentFile::Magic c_magic{'M', 'G', 'N', 'R', 'E', 'C', '0', '1'};
+
+        /**
+         * @brief A value record.
+         */
+        struct Record {
+            /// Time the value was received.
+            TimeSeries::TimePoint                         time;
+            abstraction::NodeId                           node_id;
+            abstraction::AttributeId                      attribute_id;
+            std::shared_ptr<const abstraction::DataValue> value;
+        };
+
+        /**
+         * @brief A block of consecutive value records.
+         */
+        struct Block {
+            TimeSeries::TimePoint first;
+            TimeSeries::TimePoint last;
+            /// Offset of the first record of the block.
+            std::uint64_t         offset;
+        };
+
+        /**
+         * @brief The index of a segment, built by the writer while appending and by open for segments without index.
+         */
+        struct Index {
+            /// Size of the segment data covered by the index.
+            std::uint64_t                           data_size{0};
+            std::uint64_t                           record_count{0};
+            /// Node ids by node index.
+            std::vector<abstraction::NodeId>        node_ids;
+            std::vector<Block>                      blocks;
+            /// Numbers of the blocks every node has values in, by node index.
+            std::vector<std::vector<std::uint32_t>> node_blocks;
+        };
+
+        /**
+         * @brief Opens a segment and maps it into memory.
+         *
+         * @param path path of the segment
+         *
+         * @return the segment or nullptr if it can't be opened or isn't a segment
+         */
+        [[nodiscard]] static std::unique_ptr<RecordingSegment> open(const QString& path);
+
+        /**
+         * @brief Gets the number of value records.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Gets the receive time of the first value record.
+         */
+        [[nodiscard]] std::optional<TimeSeries::TimePoint> getStart() const noexcept;
+
+        /**
+         * @brief Gets the receive time of the last value record.
+         */
+        [[nodiscard]] std::optional<TimeSeries::TimePoint> getEnd() const noexcept;
+
+        /**
+         * @brief Gets the ids of all nodes with values in this segment.
+         */
+        [[nodiscard]] const std::vector<abstraction::NodeId>& getNodeIds() const noexcept;
+
+        /**
+         * @brief Gets the offset of the first value record received at or after a time.
+         *
+         * @return the offset or getEndOffset if there is no such record
+         */
+        [[nodiscard]] std::uint64_t seek(TimeSeries::TimePoint time) const;
+
+        /**
+         * @brief Gets the offset behind the last record.
+         */
+        [[nodiscard]] std::uint64_t getEndOffset() const noexcept;
+
+        /**
+         * @brief Reads value records in the order they were recorded.
+         *
+         * @param offset offset of the first record to read, see seek
+         * @param until the first record received at or after this time isn't read
+         * @param max_count maximum number of records to read
+         * @param on_record called for every record read
+         *
+         * @return the offset of the first record that wasn't read
+         */
+        std::uint64_t read(std::uint64_t offset, TimeSeries::TimePoint until, std::size_t max_count,
+                           const std::function<void(Record&&)>& on_record) const;
+
+        /**
+         * @brief Reads the value records of a node received in [from, to). Only blocks with values of the node are
+         * visited.
+         */
+        void readNode(const abstraction::NodeId& node_id, TimeSeries::TimePoint from, TimeSeries::TimePoint to,
+                      const std::function<void(Record&&)>& on_record) const;
+
+        /**
+         * @brief Appends a node record.
+         */
+        static void appendNodeRecord(QByteArray& buffer, std::uint32_t node_index, const abstraction::NodeId& node_id);
+
+        /**
+         * @brief Appends a value record.
+         */
+        static void appendValueRecord(QByteArray& buffer, TimeSeries::TimePoint time, std::uint32_t node_index,
+                                      abstraction::AttributeId attribute_id, const abstraction::DataValue& value);
+
+        /**
+         * @brief Adds a value record to an index. Records have to be added in the order they were appended.
+         *
+         * @param index the index to add the record to
+         * @param offset offset of the record
+         * @param time receive time of the record
+         * @param node_index node index of the record, the node has to be in index.node_ids already
+         */
+        static void indexRecord(Index& index, std::uint64_t offset, TimeSeries::TimePoint time,
+                                std::uint32_t node_index);
+
+        /**
+         * @brief Serializes an index for the index file.
+         */
+        [[nodiscard]] static QByteArray encodeIndex(const Index& index);
+
+      private:
+        explicit RecordingSegment(std::unique_ptr<SegmentFile> file);
+
+        /**
+         * @brief Loads the index file of the segment.
+         *
+         * @return false if there is no complete index file for this segment
+         */
+        bool loadIndex();
+
+        /**
+         * @brief Builds the index by reading all records, up to the first incomplete or corrupt one.
+         */
+        void scan();
+
+      private:
+        std::unique_ptr<SegmentFile> m_file;
+        Index                        m_index;
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,104 @@
+#include "RecordingWriter.hpp"
+
+#include "RecordingSegment.hpp"
+#include "SegmentWriter.hpp"
+#include "TimeSeries.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <QDir>
+#include <QString>
+
+namespace {
+    constexpr auto c_segment_suffix = ".mgnrec";
+} // namespace
+
+namespace magnesia::opcua_qt {
+    using abstraction::AttributeId;
+    using abstraction::DataValue;
+    using abstraction::NodeId;
+
+    RecordingWriter::RecordingWriter(std::unique_ptr<SegmentWriter> segments) : m_segments(std::move(segments)) {}
+
+    std::unique_ptr<RecordingWriter> RecordingWriter::open(const QDir& directory, std::size_t max_segment_size) {
+        auto segments = SegmentWriter::open(directory, c_segment_suffix, RecordingSegment::c_magic, max_segment_size);
+        if (segments == nullptr) {
+            return nullptr;
+        }
+        return std::unique_ptr<RecordingWriter>{new RecordingWriter{std::move(segments)}};
+    }
+
+    RecordingWriter::~RecordingWriter() {
+        flush();
+        finishSegment();
+    }
+
+    void RecordingWriter::append(TimeSeries::TimePoint time, const NodeId& node_id, AttributeId attribute_id,
+                                 const DataValue& value) {
+        if (!m_segments->isOpen()) {
+            return;
+        }
+
+        auto& buffer          = m_segments->getBuffer();
+        auto [node, inserted] = m_node_indexes.try_emplace(node_id, static_cast<std::uint32_t>(m_node_indexes.size()));
+        if (inserted) {
+            RecordingSegment::appendNodeRecord(buffer, node->second, node_id);
+            m_index.node_ids.push_back(node_id);
+            m_index.node_blocks.emplace_back();
+        }
+
+        m_last_time       = std::max(time, m_last_time);
+        const auto offset = m_segments->getOffset();
+        RecordingSegment::appendValueRecord(buffer, m_last_time, node->second, attribute_id, value);
+        RecordingSegment::indexRecord(m_index, offset, m_last_time, node->second);
+    }
+
+    bool RecordingWriter::flush() {
+        if (!m_segments->write()) {
+            return false;
+        }
+        m_index.data_size = m_segments->getSegmentSize();
+
+        if (m_segments->isFull()) {
+            finishSegment();
+            return startSegment();
+        }
+        return true;
+    }
+
+    const QDir& RecordingWriter::getDirectory() const noexcept {
+        return m_segments->getDirectory();
+    }
+
+    std::uint64_t RecordingWriter::getBytesWritten() const noexcept {
+        return m_segments->getBytesWritten();
+    }
+
+    QString RecordingWriter::segmentName(std::uint32_t number) {
+        return SegmentWriter::segmentName(c_segment_suffix, number);
+    }
+
+    QString RecordingWriter::segmentNameFilter() {
+        return SegmentWriter::segmentNameFilter(c_segment_suffix);
+    }
+
+    bool RecordingWriter::startSegment() {
+        if (!m_segments->startSegment()) {
+            return false;
+        }
+        m_index = {};
+        m_node_indexes.clear();
+        return true;
+    }
+
+    void RecordingWriter::finishSegment() {
+        m_segments->finishSegment(RecordingSegment::encodeIndex(m_index));
+    }
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "RecordingSegment.hpp"
+#include "SegmentWriter.hpp"
+#include "TimeSeries.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include <QDir>
+#include <QString>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class RecordingWriter
+     * @brief Appends data changes to the segments of a recording.
+     *
+     * Records are collected in memory and written with flush, which should be called once per batch of data changes.
+     * A new segment is started once the current one reached its maximum size. The index of a segment is written when
+     * the segment is complete, so a crash loses at most the records that weren't flushed yet.
+     *
+     * @see RecordingSegment
+     * @see SegmentWriter
+     */
+    class RecordingWriter {
+      public:
+        /**
+         * @brief Opens a recording for writing.
+         *
+         * @param directory directory of the recording, created if it doesn't exist. Existing segments are kept, new
+         *                  ones are numbered after them.
+         * @param max_segment_size size in bytes after which a new segment is started
+         *
+         * @return the writer or nullptr if the directory or first segment can't be created
+         */
+        [[nodiscard]] static std::unique_ptr<RecordingWriter> open(const QDir& directory, std::size_t max_segment_size);
+
+        ~RecordingWriter();
+
+        /**
+         * @brief Appends a data change. It is written with the next flush.
+         *
+         * @param time the time the value was received. Times before the previous record are recorded as the time of
+         *             the previous record, so the segment stays sorted.
+         * @param node_id the node the value belongs to
+         * @param attribute_id the attribute the value belongs to
+         * @param value the value
+         */
+        void append(TimeSeries::TimePoint time, const abstraction::NodeId& node_id,
+                    abstraction::AttributeId attribute_id, const abstraction::DataValue& value);
+
+        /**
+         * @brief Writes the appended records to disk, starting a new segment if the current one is full.
+         *
+         * @return false if writing failed. The recording should be stopped then.
+         */
+        bool flush();
+
+        /**
+         * @brief Gets the directory of the recording.
+         */
+        [[nodiscard]] const QDir& getDirectory() const noexcept;
+
+        /**
+         * @brief Gets the number of bytes written to all segments so far.
+         */
+        [[nodiscard]] std::uint64_t getBytesWritten() const noexcept;
+
+        /**
+         * @brief Gets the name of a segment file.
+         *
+         * @param number number of the segment, segments are replayed in the order of their numbers
+         */
+        [[nodiscard]] static QString segmentName(std::uint32_t number);
+
+        /**
+         * @brief Gets the name filter matching all segment files of a recording.
+         */
+        [[nodiscard]] static QString segmentNameFilter();
+
+      private:
+        explicit RecordingWriter(std::unique_ptr<SegmentWriter> segments);
+
+        bool startSegment();
+        void finishSegment();
+
+      private:
+        std::unique_ptr<SegmentWriter> m_segments;
+
+        RecordingSegment::Index                                  m_index;
+        std::unordered_map<abstraction::NodeId, std::uint32_t> m_node_indexes;
+        TimeSeries::TimePoint                                    m_last_time{};
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,135 @@
+#include "SegmentFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QDataStream>
+#include <QFile>
+#include <QIODevice>
+#include <QLoggingCategory>
+#include <QString>
+#include <QtEndian>
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_segment, "magnesia.opcua.segment")
+} // namespace
+
+namespace magnesia::opcua_qt {
+    SegmentFile::SegmentFile(std::unique_ptr<QFile> file, const uchar* data, std::uint64_t size)
+        : m_file(std::move(file)), m_data(data), m_size(size) {}
+
+    std::unique_ptr<SegmentFile> SegmentFile::open(const QString& path, const Magic& magic) {
+        auto file = std::make_unique<QFile>(path);
+        if (!file->open(QIODevice::ReadOnly)) {
+            qCWarning(lc_opcua_segment) << "Failed to open segment" << path << file->errorString();
+            return nullptr;
+        }
+        const auto size = static_cast<std::uint64_t>(file->size());
+        if (size < magic.size()) {
+            qCWarning(lc_opcua_segment) << "Unknown segment format:" << path;
+            return nullptr;
+        }
+        // the mapping stays valid after closing the file, but the file object has to live as long as the mapping
+        const auto* data = file->map(0, file->size());
+        if (data == nullptr) {
+            qCWarning(lc_opcua_segment) << "Failed to map segment" << path << file->errorString();
+            return nullptr;
+        }
+        if (std::memcmp(data, magic.data(), magic.size()) != 0) {
+            qCWarning(lc_opcua_segment) << "Unknown segment format:" << path;
+            return nullptr;
+        }
+        return std::unique_ptr<SegmentFile>{new SegmentFile{std::move(file), data, size}};
+    }
+
+    QString SegmentFile::getPath() const {
+        return m_file->fileName();
+    }
+
+    std::uint64_t SegmentFile::size() const noexcept {
+        return m_size;
+    }
+
+    std::optional<SegmentFile::Record> SegmentFile::parseRecord(std::uint64_t offset, std::uint64_t end) const {
+        end = std::min(end, m_size);
+        if (end < c_record_header_size || offset > end - c_record_header_size) {
+            return std::nullopt;
+        }
+        const auto* header = m_data + offset;
+        const auto  size   = qFromLittleEndian<std::uint32_t>(header);
+        const auto  next   = offset + c_record_header_size + size;
+        if (size > c_max_payload_size || next > end) {
+            return std::nullopt;
+        }
+        const auto* payload = header + c_record_header_size;
+        if (qChecksum(QByteArrayView{payload, size}) != qFromLittleEndian<std::uint16_t>(header + 4)) {
+            return std::nullopt;
+        }
+        return Record{.kind = header[6], .payload = payload, .size = size, .next = next};
+    }
+
+    std::optional<std::uint64_t> SegmentFile::skipRecord(std::uint64_t offset, std::uint64_t end) const {
+        end = std::min(end, m_size);
+        if (end < c_record_header_size || offset > end - c_record_header_size) {
+            return std::nullopt;
+        }
+        return offset + c_record_header_size + qFromLittleEndian<std::uint32_t>(m_data + offset);
+    }
+
+    bool SegmentFile::readIndex(const Magic& magic, const std::function<bool(QDataStream&)>& read) const {
+        QFile file{indexPath(m_file->fileName())};
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        QDataStream in{&file};
+        in.setVersion(QDataStream::Qt_6_0);
+
+        Magic file_magic{};
+        const auto read_size = in.readRawData(file_magic.data(), static_cast<int>(file_magic.size()));
+        if (read_size != static_cast<int>(file_magic.size()) || file_magic != magic) {
+            return false;
+        }
+        return read(in) && in.status() == QDataStream::Ok;
+    }
+
+    void SegmentFile::appendMagic(QByteArray& buffer, const Magic& magic) {
+        buffer.append(magic.data(), static_cast<qsizetype>(magic.size()));
+    }
+
+    qsizetype SegmentFile::beginRecord(QByteArray& buffer) {
+        const auto start = buffer.size();
+        buffer.append(static_cast<qsizetype>(c_record_header_size), '\0');
+        return start;
+    }
+
+    void SegmentFile::endRecord(QByteArray& buffer, qsizetype start, std::uint8_t kind) {
+        const auto payload_start = start + static_cast<qsizetype>(c_record_header_size);
+        const auto checksum      = qChecksum(QByteArrayView{buffer}.sliced(payload_start));
+        auto*      header        = reinterpret_cast<uchar*>(buffer.data() + start);
+        qToLittleEndian(static_cast<std::uint32_t>(buffer.size() - payload_start), header);
+        qToLittleEndian(checksum, header + 4);
+        header[6] = kind;
+    }
+
+    QByteArray SegmentFile::encodeIndex(const Magic& magic, const std::function<void(QDataStream&)>& write) {
+        QByteArray  bytes;
+        QDataStream out{&bytes, QIODevice::WriteOnly};
+        out.setVersion(QDataStream::Qt_6_0);
+
+        out.writeRawData(magic.data(), static_cast<int>(magic.size()));
+        write(out);
+        return bytes;
+    }
+
+    QString SegmentFile::indexPath(const QString& segment_path) {
+        return segment_path + ".idx";
+    }
+} // namespace magnesia::opcua_qt
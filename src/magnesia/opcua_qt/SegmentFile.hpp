@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+#include <QtEndian>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class SegmentFile
+     * @brief A read-only, memory-mapped, append-only file of checksummed records.
+     *
+     * This is the container of recording and log segments. The file starts with a magic number identifying its format,
+     * followed by records. Every record has a header with the size, checksum and kind of its payload, so a file cut
+     * short by a crash is read up to its last complete record. The payload is up to the format.
+     *
+     * The index of a segment is written to a file next to it once the segment is complete, see SegmentWriter. It
+     * starts with a magic number as well, the rest is up to the format.
+     *
+     * @see SegmentWriter
+     * @see RecordingSegment
+     * @see LogSegment
+     */
+    class SegmentFile {
+      public:
+        using Magic = std::array<char, 8>;
+
+        /// Size of the header in front of every payload: payload size (4), checksum (2), kind (1), reserved (1).
+        static constexpr std::uint64_t c_record_header_size = 8;
+        /// Maximum size of a payload.
+        static constexpr std::uint32_t c_max_payload_size   = 16U * 1024U * 1024U;
+
+        /**
+         * @brief A record whose header and checksum have been validated.
+         */
+        struct Record {
+            std::uint8_t  kind;
+            const uchar*  payload;
+            std::uint32_t size;
+            /// Offset of the next record.
+            std::uint64_t next;
+        };
+
+        /**
+         * @brief Opens a file and maps it into memory.
+         *
+         * @param path path of the file
+         * @param magic the magic number the file has to start with
+         *
+         * @return the file or nullptr if it can't be opened or doesn't start with the magic number
+         */
+        [[nodiscard]] static std::unique_ptr<SegmentFile> open(const QString& path, const Magic& magic);
+
+        /**
+         * @brief Gets the path of the file.
+         */
+        [[nodiscard]] QString getPath() const;
+
+        /**
+         * @brief Gets the size of the file, including an incomplete last record.
+         */
+        [[nodiscard]] std::uint64_t size() const noexcept;
+
+        /**
+         * @brief Gets the offset of the first record.
+         */
+        [[nodiscard]] static constexpr std::uint64_t firstRecordOffset() noexcept {
+            return std::tuple_size_v<Magic>;
+        }
+
+        /**
+         * @brief Validates the record at an offset.
+         *
+         * @param offset offset of the record
+         * @param end the record has to end at or before this offset
+         *
+         * @return the record or nullopt if it is incomplete or corrupt
+         */
+        [[nodiscard]] std::optional<Record> parseRecord(std::uint64_t offset, std::uint64_t end) const;
+
+        /**
+         * @brief Gets the offset of the record after the one at an offset. Only its size is read, so it should have
+         * been validated before, e.g. while indexing.
+         *
+         * @return the offset or nullopt if the record's header doesn't end before end
+         */
+        [[nodiscard]] std::optional<std::uint64_t> skipRecord(std::uint64_t offset, std::uint64_t end) const;
+
+        /**
+         * @brief Reads the index file of the file.
+         *
+         * @param magic the magic number the index file has to start with
+         * @param read reads the rest of the index, returns false if it isn't valid for this file
+         *
+         * @return false if there is no index file, it doesn't start with the magic number, read returned false or the
+         *         stream ran out of data
+         */
+        bool readIndex(const Magic& magic, const std::function<bool(QDataStream&)>& read) const;
+
+        /**
+         * @brief Appends a magic number.
+         */
+        static void appendMagic(QByteArray& buffer, const Magic& magic);
+
+        /**
+         * @brief Starts a record. The payload is appended to the buffer afterwards and the record is completed by
+         * endRecord.
+         *
+         * @return the start of the record in the buffer
+         */
+        static qsizetype beginRecord(QByteArray& buffer);
+
+        /**
+         * @brief Appends an integer in little endian byte order, e.g. to a payload.
+         */
+        template<typename T>
+        static void appendLittleEndian(QByteArray& buffer, T value) {
+            std::array<uchar, sizeof(T)> bytes{};
+            qToLittleEndian(value, bytes.data());
+            buffer.append(reinterpret_cast<const char*>(bytes.data()), static_cast<qsizetype>(bytes.size()));
+        }
+
+        /**
+         * @brief Completes a record by filling in its header.
+         *
+         * @param buffer the buffer the payload has been appended to
+         * @param start the start of the record returned by beginRecord
+         * @param kind the kind of the record, up to the format
+         */
+        static void endRecord(QByteArray& buffer, qsizetype start, std::uint8_t kind);
+
+        /**
+         * @brief Serializes an index for the index file.
+         *
+         * @param magic the magic number the index file starts with
+         * @param write writes the rest of the index
+         */
+        [[nodiscard]] static QByteArray encodeIndex(const Magic& magic, const std::function<void(QDataStream&)>& write);
+
+        /**
+         * @brief Gets the path of the index file belonging to a segment.
+         */
+        [[nodiscard]] static QString indexPath(const QString& segment_path);
+
+      private:
+        SegmentFile(std::unique_ptr<QFile> file, const uchar* data, std::uint64_t size);
+
+      private:
+        // has to live as long as the mapping
+        std::unique_ptr<QFile> m_file;
+        const uchar*           m_data;
+        std::uint64_t          m_size;
+    };
+} // namespace magnesia::opcua_qt
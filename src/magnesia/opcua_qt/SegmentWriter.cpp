@@ -0,0 +1,150 @@
+#include "SegmentWriter.hpp"
+
+#include "SegmentFile.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <QByteArray>
+#include <QChar>
+#include <QDir>
+#include <QFile>
+#include <QIODevice>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QString>
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_segment_writer, "magnesia.opcua.segment_writer")
+
+    constexpr auto c_segment_prefix = "segment-";
+    constexpr int  c_segment_digits = 6;
+    // initial capacity of the buffer, a few batches of records
+    constexpr int  c_buffer_reserve = 64 * 1024;
+} // namespace
+
+namespace magnesia::opcua_qt {
+    SegmentWriter::SegmentWriter(QDir directory, QString suffix, const SegmentFile::Magic& magic,
+                                 std::size_t max_segment_size, std::uint32_t next_segment)
+        : m_directory(std::move(directory)), m_suffix(std::move(suffix)), m_magic(magic),
+          m_max_segment_size(max_segment_size), m_next_segment(next_segment) {
+        m_buffer.reserve(c_buffer_reserve);
+    }
+
+    std::unique_ptr<SegmentWriter> SegmentWriter::open(const QDir& directory, const QString& suffix,
+                                                       const SegmentFile::Magic& magic, std::size_t max_segment_size) {
+        if (!directory.mkpath(".")) {
+            qCWarning(lc_opcua_segment_writer) << "Can't create segment directory" << directory.absolutePath();
+            return nullptr;
+        }
+
+        // continue after existing segments
+        std::uint32_t next_segment{0};
+        for (const auto& name : directory.entryList({segmentNameFilter(suffix)}, QDir::Files)) {
+            const auto number = name.sliced(QString{c_segment_prefix}.size(), c_segment_digits).toUInt();
+            next_segment      = std::max(next_segment, number + 1);
+        }
+
+        std::unique_ptr<SegmentWriter> writer{new SegmentWriter{directory, suffix, magic, max_segment_size,
+                                                                next_segment}};
+        if (!writer->startSegment()) {
+            return nullptr;
+        }
+        return writer;
+    }
+
+    QByteArray& SegmentWriter::getBuffer() noexcept {
+        return m_buffer;
+    }
+
+    std::uint64_t SegmentWriter::getOffset() const noexcept {
+        return m_segment_size + static_cast<std::uint64_t>(m_buffer.size());
+    }
+
+    bool SegmentWriter::write() {
+        if (m_file == nullptr) {
+            return false;
+        }
+        if (m_buffer.isEmpty()) {
+            return true;
+        }
+
+        if (m_file->write(m_buffer) != m_buffer.size() || !m_file->flush()) {
+            qCWarning(lc_opcua_segment_writer) << "Failed to write" << m_file->fileName() << m_file->errorString();
+            m_file.reset();
+            return false;
+        }
+        m_segment_size  += static_cast<std::uint64_t>(m_buffer.size());
+        m_bytes_written += static_cast<std::uint64_t>(m_buffer.size());
+        // keeps the capacity
+        m_buffer.resize(0);
+        return true;
+    }
+
+    bool SegmentWriter::isOpen() const noexcept {
+        return m_file != nullptr;
+    }
+
+    bool SegmentWriter::isFull() const noexcept {
+        return m_segment_size >= m_max_segment_size;
+    }
+
+    void SegmentWriter::finishSegment(const QByteArray& index) {
+        if (m_file == nullptr) {
+            return;
+        }
+
+        // Written atomically, a segment either has a complete index or is scanned when opened.
+        QSaveFile index_file{SegmentFile::indexPath(m_file->fileName())};
+        if (!index_file.open(QIODevice::WriteOnly) || index_file.write(index) < 0 || !index_file.commit()) {
+            qCWarning(lc_opcua_segment_writer) << "Failed to write the index of" << m_file->fileName();
+        }
+        m_file.reset();
+    }
+
+    bool SegmentWriter::startSegment() {
+        auto file = std::make_unique<QFile>(m_directory.absoluteFilePath(segmentName(m_suffix, m_next_segment)));
+        if (!file->open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+            qCWarning(lc_opcua_segment_writer) << "Failed to create" << file->fileName() << file->errorString();
+            return false;
+        }
+        ++m_next_segment;
+
+        m_file         = std::move(file);
+        m_segment_size = 0;
+
+        // the magic number is written with the first records
+        SegmentFile::appendMagic(m_buffer, m_magic);
+        return true;
+    }
+
+    const QDir& SegmentWriter::getDirectory() const noexcept {
+        return m_directory;
+    }
+
+    QString SegmentWriter::getSegmentPath() const {
+        if (m_file == nullptr) {
+            return {};
+        }
+        return m_file->fileName();
+    }
+
+    std::uint64_t SegmentWriter::getSegmentSize() const noexcept {
+        return m_segment_size;
+    }
+
+    std::uint64_t SegmentWriter::getBytesWritten() const noexcept {
+        return m_bytes_written;
+    }
+
+    QString SegmentWriter::segmentName(const QString& suffix, std::uint32_t number) {
+        return QString{"%1%2%3"}.arg(c_segment_prefix).arg(number, c_segment_digits, 10, QChar{'0'}).arg(suffix);
+    }
+
+    QString SegmentWriter::segmentNameFilter(const QString& suffix) {
+        return QString{c_segment_prefix} + '*' + suffix;
+    }
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "SegmentFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QString>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class SegmentWriter
+     * @brief Appends records to numbered segment files in a directory.
+     *
+     * Records are appended to a buffer with SegmentFile::beginRecord and SegmentFile::endRecord and written with
+     * write. The format using the writer decides when a full segment is finished and a new one started, and encodes
+     * the index written next to a finished segment.
+     *
+     * @see SegmentFile
+     * @see RecordingWriter
+     * @see LogWriter
+     */
+    class SegmentWriter {
+      public:
+        /**
+         * @brief Opens a directory for writing and starts the first segment.
+         *
+         * @param directory directory of the segments, created if it doesn't exist. Existing segments are kept, new
+         *                  ones are numbered after them.
+         * @param suffix file name suffix of the segments, identifying their format
+         * @param magic magic number every segment starts with
+         * @param max_segment_size size in bytes after which a segment is full
+         *
+         * @return the writer or nullptr if the directory or first segment can't be created
+         */
+        [[nodiscard]] static std::unique_ptr<SegmentWriter> open(const QDir& directory, const QString& suffix,
+                                                                 const SegmentFile::Magic& magic,
+                                                                 std::size_t               max_segment_size);
+
+        /**
+         * @brief Gets the buffer records are appended to. They are written with the next write.
+         */
+        [[nodiscard]] QByteArray& getBuffer() noexcept;
+
+        /**
+         * @brief Gets the offset in the current segment the next record appended to the buffer is written at.
+         */
+        [[nodiscard]] std::uint64_t getOffset() const noexcept;
+
+        /**
+         * @brief Writes the buffer to the current segment.
+         *
+         * @return false if writing failed. The segment is closed then and nothing is written anymore.
+         */
+        bool write();
+
+        /**
+         * @brief Checks if there is a segment to write to, i.e. nothing failed so far.
+         */
+        [[nodiscard]] bool isOpen() const noexcept;
+
+        /**
+         * @brief Checks if the current segment reached its maximum size.
+         */
+        [[nodiscard]] bool isFull() const noexcept;
+
+        /**
+         * @brief Writes the index of the current segment next to it and closes it. Nothing happens if no segment is
+         * open.
+         *
+         * @param index the index, see SegmentFile::encodeIndex
+         */
+        void finishSegment(const QByteArray& index);
+
+        /**
+         * @brief Starts the next segment. The previous one should have been finished.
+         *
+         * @return false if the segment can't be created
+         */
+        bool startSegment();
+
+        /**
+         * @brief Gets the directory of the segments.
+         */
+        [[nodiscard]] const QDir& getDirectory() const noexcept;
+
+        /**
+         * @brief Gets the path of the current segment.
+         */
+        [[nodiscard]] QString getSegmentPath() const;
+
+        /**
+         * @brief Gets the number of bytes written to the current segment.
+         */
+        [[nodiscard]] std::uint64_t getSegmentSize() const noexcept;
+
+        /**
+         * @brief Gets the number of bytes written to all segments so far.
+         */
+        [[nodiscard]] std::uint64_t getBytesWritten() const noexcept;
+
+        /**
+         * @brief Gets the name of a segment file.
+         *
+         * @param suffix file name suffix of the segment
+         * @param number number of the segment, segments are read in the order of their numbers
+         */
+        [[nodiscard]] static QString segmentName(const QString& suffix, std::uint32_t number);
+
+        /**
+         * @brief Gets the name filter matching all segment files with a suffix.
+         */
+        [[nodiscard]] static QString segmentNameFilter(const QString& suffix);
+
+      private:
+        SegmentWriter(QDir directory, QString suffix, const SegmentFile::Magic& magic, std::size_t max_segment_size,
+                      std::uint32_t next_segment);
+
+      private:
+        QDir                   m_directory;
+        QString                m_suffix;
+        SegmentFile::Magic     m_magic;
+        std::size_t            m_max_segment_size;
+        std::uint32_t          m_next_segment;
+        std::unique_ptr<QFile> m_file;
+        // records appended since the last write
+        QByteArray             m_buffer;
+        // size of the current segment without the buffer
+        std::uint64_t          m_segment_size{0};
+        std::uint64_t          m_bytes_written{0};
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,646 @@
+#include "SubscriptionManager.hpp"
+
+#include "../Application.hpp"
+#include "../qt_version_check.hpp"
+#include "Connection.hpp"
+#include "MonitoredItemSet.hpp"
+#include "RecordingReplay.hpp"
+#include "RecordingSegment.hpp"
+#include "RecordingWriter.hpp"
+#include "TimeSeries.hpp"
+#include "TimeSeriesStore.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/DeadbandType.hpp"
+#include "abstraction/MonitoringMode.hpp"
+#include "abstraction/MonitoringParameters.hpp"
+#include "abstraction/NodeId.hpp"
+#include "abstraction/node/Node.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <open62541/client.h>
+#include <open62541/client_subscriptions.h>
+#include <open62541/types.h>
+#include <open62541pp/types/DataValue.h>
+
+#include <QDir>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QPointer>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#include <QtTypeTraits>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_subscription_manager, "magnesia.opcua.subscription_manager")
+
+    // Number of dispatched batches kept for reuse. One is usually in flight while the next one is filled.
+    constexpr std::size_t c_batch_pool_size = 4;
+
+    // size after which a recording starts a new segment
+    constexpr std::size_t c_recording_segment_size = 64UL * 1024UL * 1024UL;
+
+    // The handle is passed through the client as item context. Unlike a pointer it can't dangle once the item is gone.
+    void* to_item_context(magnesia::opcua_qt::SubscriptionManager::ItemHandle handle) {
+        // NOLINTNEXTLINE(performance-no-int-to-ptr)
+        return reinterpret_cast<void*>(handle);
+    }
+
+    magnesia::opcua_qt::SubscriptionManager::ItemHandle from_item_context(void* context) {
+        return reinterpret_cast<magnesia::opcua_qt::SubscriptionManager::ItemHandle>(context);
+    }
+
+    UA_DataChangeFilter to_data_change_filter(const magnesia::opcua_qt::abstraction::MonitoringParameters& parameters) {
+        UA_DataChangeFilter filter;
+        UA_DataChangeFilter_init(&filter);
+        filter.trigger       = UA_DATACHANGETRIGGER_STATUSVALUE;
+        filter.deadbandType  = static_cast<UA_UInt32>(parameters.getDeadbandType());
+        filter.deadbandValue = parameters.getDeadbandValue();
+        return filter;
+    }
+
+    // Shallow, the filter of target references data_change_filter.
+    void to_monitoring_parameters(const magnesia::opcua_qt::abstraction::MonitoringParameters& parameters,
+                                  magnesia::opcua_qt::abstraction::AttributeId attribute_id,
+                                  UA_DataChangeFilter& data_change_filter, UA_MonitoringParameters& target) {
+        target.samplingInterval = parameters.getSamplingInterval();
+        target.queueSize        = parameters.getQueueSize();
+        target.discardOldest    = parameters.getDiscardOldest();
+
+        // deadbands are only defined for the Value attribute
+        if (parameters.getDeadbandType() == magnesia::opcua_qt::abstraction::DeadbandType::NONE
+            || attribute_id != magnesia::opcua_qt::abstraction::AttributeId::VALUE) {
+            return;
+        }
+        target.filter.encoding             = UA_EXTENSIONOBJECT_DECODED_NODELETE;
+        target.filter.content.decoded.type = &UA_TYPES[UA_TYPES_DATACHANGEFILTER];
+        target.filter.content.decoded.data = &data_change_filter;
+    }
+
+    magnesia::opcua_qt::TimeSeriesStore make_time_series_store() {
+        auto&      settings = magnesia::Application::instance().getSettingsManager();
+        const auto capacity = settings.getIntSetting({.name = "opcua_time_series_capacity", .domain = "general"});
+        const auto max_age  = settings.getIntSetting({.name = "opcua_time_series_max_age", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(capacity && max_age);
+        return {static_cast<std::size_t>(capacity.value()), std::chrono::seconds{max_age.value()}};
+    }
+
+    magnesia::opcua_qt::abstraction::MonitoringParameters
+    revise_parameters(magnesia::opcua_qt::abstraction::MonitoringParameters parameters, UA_Double sampling_interval,
+                      UA_UInt32 queue_size) {
+        parameters.setSamplingInterval(sampling_interval);
+        parameters.setQueueSize(queue_size);
+        return parameters;
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    using abstraction::AttributeId;
+    using abstraction::DataValue;
+    using abstraction::MonitoringMode;
+    using abstraction::MonitoringParameters;
+    using abstraction::Node;
+    using abstraction::NodeId;
+
+    SubscriptionManager::SubscriptionManager(Connection* connection)
+        : QObject(connection), m_connection(connection), m_time_series(make_time_series_store()) {
+        const auto max_items = Application::instance().getSettingsManager().getIntSetting(
+            {.name = "opcua_max_monitored_items_per_subscription", .domain = "general"});
+        // Can only be nullopt if the setting was never defined or is of the wrong type. Both should never happen.
+        Q_ASSERT(max_items);
+        m_max_items_per_subscription = static_cast<std::size_t>(max_items.value());
+
+        connect(connection, &Connection::disconnected, this, &SubscriptionManager::forgetSubscriptions);
+    }
+
+    std::vector<SubscriptionManager::ItemHandle>
+    SubscriptionManager::createItems(MonitoredItemSet* owner, std::chrono::milliseconds publishing_interval,
+                                     std::span<const MonitoredAttribute> attributes,
+                                     const MonitoringParameters& parameters, MonitoringMode mode) {
+        std::vector<ItemHandle> created;
+        created.reserve(attributes.size());
+
+        const auto lock         = m_connection->lockClient();
+        const auto max_per_call = m_connection->getMaxMonitoredItemsPerCall();
+        while (!attributes.empty()) {
+            auto* subscription = findSubscriptionWithCapacity(publishing_interval);
+            if (subscription == nullptr) {
+                qCWarning(lc_opcua_subscription_manager)
+                    << "Failed to monitor" << attributes.size() << "attributes: no subscription available";
+                created.insert(created.end(), attributes.size(), 0);
+                break;
+            }
+
+            auto count = std::min(attributes.size(), m_max_items_per_subscription - subscription->item_count);
+            if (max_per_call != 0) {
+                count = std::min(count, max_per_call);
+            }
+            createItemsIn(*subscription, owner, attributes.first(count), parameters, mode, created);
+            attributes = attributes.subspan(count);
+        }
+        return created;
+    }
+
+    void SubscriptionManager::deleteItems(std::span<const ItemHandle> handles) {
+        std::map<UA_UInt32, std::vector<UA_UInt32>> items_by_subscription;
+        for (const auto handle : handles) {
+            const auto item = m_items.find(handle);
+            if (item == m_items.end()) {
+                continue;
+            }
+            items_by_subscription[item->second.subscription_id].push_back(item->second.monitored_item_id);
+            m_items.erase(item);
+        }
+        if (items_by_subscription.empty()) {
+            return;
+        }
+
+        const auto lock         = m_connection->lockClient();
+        const auto max_per_call = m_connection->getMaxMonitoredItemsPerCall();
+        for (auto& [subscription_id, item_ids] : items_by_subscription) {
+            std::span<UA_UInt32> remaining{item_ids};
+            while (!remaining.empty()) {
+                const auto count = max_per_call != 0 ? std::min(remaining.size(), max_per_call) : remaining.size();
+
+                UA_DeleteMonitoredItemsRequest request;
+                UA_DeleteMonitoredItemsRequest_init(&request);
+                request.subscriptionId       = subscription_id;
+                request.monitoredItemIds     = remaining.data();
+                request.monitoredItemIdsSize = count;
+
+                auto response = UA_Client_MonitoredItems_delete(m_connection->getClientHandle(), request);
+                if (response.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
+                    // the items are gone from the client either way, the server drops them with the subscription
+                    qCDebug(lc_opcua_subscription_manager)
+                        << "Failed to delete" << count
+                        << "monitored items:" << UA_StatusCode_name(response.responseHeader.serviceResult);
+                }
+                UA_DeleteMonitoredItemsResponse_clear(&response);
+                remaining = remaining.subspan(count);
+            }
+            releaseItems(subscription_id, item_ids.size());
+        }
+    }
+
+    bool SubscriptionManager::modifyItems(std::span<const ItemHandle> handles, const MonitoringParameters& parameters) {
+        const auto lock         = m_connection->lockClient();
+        const auto max_per_call = m_connection->getMaxMonitoredItemsPerCall();
+        bool       modified{true};
+        for (const auto& [subscription_id, subscription_handles] : groupBySubscription(handles)) {
+            std::span<const ItemHandle> remaining{subscription_handles};
+            while (!remaining.empty()) {
+                const auto count = max_per_call != 0 ? std::min(remaining.size(), max_per_call) : remaining.size();
+                modified  = modifyItemsIn(subscription_id, remaining.first(count), parameters) && modified;
+                remaining = remaining.subspan(count);
+            }
+        }
+        return modified;
+    }
+
+    bool SubscriptionManager::setMonitoringMode(std::span<const ItemHandle> handles, MonitoringMode mode) {
+        const auto lock         = m_connection->lockClient();
+        const auto max_per_call = m_connection->getMaxMonitoredItemsPerCall();
+        bool       changed{true};
+        for (const auto& [subscription_id, subscription_handles] : groupBySubscription(handles)) {
+            std::span<const ItemHandle> remaining{subscription_handles};
+            while (!remaining.empty()) {
+                const auto count = max_per_call != 0 ? std::min(remaining.size(), max_per_call) : remaining.size();
+                changed   = setMonitoringModeIn(subscription_id, remaining.first(count), mode) && changed;
+                remaining = remaining.subspan(count);
+            }
+        }
+        return changed;
+    }
+
+    std::optional<MonitoringParameters> SubscriptionManager::getItemParameters(ItemHandle handle) const {
+        const auto item = m_items.find(handle);
+        if (item == m_items.end()) {
+            return std::nullopt;
+        }
+        return item->second.parameters;
+    }
+
+    std::size_t SubscriptionManager::getSubscriptionCount() const noexcept {
+        std::size_t count{0};
+        for (const auto& [publishing_interval, subscriptions] : m_subscriptions) {
+            count += subscriptions.size();
+        }
+        return count;
+    }
+
+    SubscriptionManager::ManagedSubscription*
+    SubscriptionManager::findSubscriptionWithCapacity(std::chrono::milliseconds publishing_interval) {
+        auto& group = m_subscriptions[publishing_interval];
+        for (auto& subscription : group) {
+            if (subscription.item_count < m_max_items_per_subscription) {
+                return &subscription;
+            }
+        }
+
+        auto request                        = UA_CreateSubscriptionRequest_default();
+        request.requestedPublishingInterval = static_cast<UA_Double>(publishing_interval.count());
+
+        auto response =
+            UA_Client_Subscriptions_create(m_connection->getClientHandle(), request, this, nullptr, nullptr);
+        const auto status          = response.responseHeader.serviceResult;
+        const auto subscription_id = response.subscriptionId;
+        UA_CreateSubscriptionResponse_clear(&response);
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_subscription_manager) << "Failed to create subscription:" << UA_StatusCode_name(status);
+            if (group.empty()) {
+                m_subscriptions.erase(publishing_interval);
+            }
+            return nullptr;
+        }
+
+        qCDebug(lc_opcua_subscription_manager) << "Created subscription" << subscription_id
+                                               << "with publishing interval" << publishing_interval.count() << "ms";
+        return &group.emplace_back(ManagedSubscription{.id = subscription_id});
+    }
+
+    void SubscriptionManager::createItemsIn(ManagedSubscription& subscription, MonitoredItemSet* owner,
+                                            std::span<const MonitoredAttribute> attributes,
+                                            const MonitoringParameters& parameters, MonitoringMode mode,
+                                            std::vector<ItemHandle>& created) {
+        // the requests reference the node ids and the filter, which have to outlive the service call
+        auto                data_change_filter = to_data_change_filter(parameters);
+        std::vector<NodeId> node_ids;
+        node_ids.reserve(attributes.size());
+        std::vector<UA_MonitoredItemCreateRequest>            items_to_create(attributes.size());
+        std::vector<ItemHandle>                               handles(attributes.size());
+        std::vector<void*>                                    contexts(attributes.size());
+        std::vector<UA_Client_DataChangeNotificationCallback> callbacks(attributes.size(), &onDataChange);
+        std::vector<UA_Client_DeleteMonitoredItemCallback>    delete_callbacks(attributes.size(), nullptr);
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            const auto& [node, attribute_id] = attributes[i];
+            const auto& node_id              = node_ids.emplace_back(node->getNodeId());
+
+            items_to_create[i] = UA_MonitoredItemCreateRequest_default(*node_id.handle().handle());
+            items_to_create[i].itemToMonitor.attributeId = static_cast<UA_UInt32>(attribute_id);
+            items_to_create[i].monitoringMode            = static_cast<UA_MonitoringMode>(mode);
+            to_monitoring_parameters(parameters, attribute_id, data_change_filter,
+                                     items_to_create[i].requestedParameters);
+            handles[i]  = m_next_handle++;
+            contexts[i] = to_item_context(handles[i]);
+        }
+
+        UA_CreateMonitoredItemsRequest request;
+        UA_CreateMonitoredItemsRequest_init(&request);
+        request.subscriptionId     = subscription.id;
+        request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+        request.itemsToCreate      = items_to_create.data();
+        request.itemsToCreateSize  = items_to_create.size();
+
+        auto response = UA_Client_MonitoredItems_createDataChanges(
+            m_connection->getClientHandle(), request, contexts.data(), callbacks.data(), delete_callbacks.data());
+        auto status = response.responseHeader.serviceResult;
+        if (status == UA_STATUSCODE_GOOD && response.resultsSize != attributes.size()) {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_subscription_manager)
+                << "Failed to monitor" << attributes.size() << "attributes:" << UA_StatusCode_name(status);
+            UA_CreateMonitoredItemsResponse_clear(&response);
+            created.insert(created.end(), attributes.size(), 0);
+            return;
+        }
+
+        for (std::size_t i = 0; i < attributes.size(); ++i) {
+            const auto& [node, attribute_id] = attributes[i];
+            const auto& result               = response.results[i];
+            if (result.statusCode != UA_STATUSCODE_GOOD) {
+                if (result.statusCode == UA_STATUSCODE_BADNOTSUPPORTED) {
+                    qCInfo(lc_opcua_subscription_manager)
+                        << "Failed to monitor attribute" << qToUnderlying(attribute_id)
+                        << "reason:" << UA_StatusCode_name(result.statusCode);
+                } else {
+                    qCWarning(lc_opcua_subscription_manager)
+                        << "Failed to monitor attribute" << qToUnderlying(attribute_id)
+                        << "reason:" << UA_StatusCode_name(result.statusCode);
+                }
+                created.push_back(0);
+                continue;
+            }
+
+            m_items.emplace(handles[i], ManagedItem{
+                                            .node              = node,
+                                            .attribute_id      = attribute_id,
+                                            .owner             = owner,
+                                            .subscription_id   = subscription.id,
+                                            .monitored_item_id = result.monitoredItemId,
+                                            .parameters        = revise_parameters(
+                                                parameters, result.revisedSamplingInterval, result.revisedQueueSize),
+                                        });
+            ++subscription.item_count;
+            created.push_back(handles[i]);
+        }
+        UA_CreateMonitoredItemsResponse_clear(&response);
+    }
+
+    bool SubscriptionManager::modifyItemsIn(UA_UInt32 subscription_id, std::span<const ItemHandle> handles,
+                                            const MonitoringParameters& parameters) {
+        // the requests reference the filter, which has to outlive the service call
+        auto                                       data_change_filter = to_data_change_filter(parameters);
+        std::vector<UA_MonitoredItemModifyRequest> items_to_modify(handles.size());
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            const auto& item = m_items.at(handles[i]);
+            UA_MonitoredItemModifyRequest_init(&items_to_modify[i]);
+            items_to_modify[i].monitoredItemId = item.monitored_item_id;
+            to_monitoring_parameters(parameters, item.attribute_id, data_change_filter,
+                                     items_to_modify[i].requestedParameters);
+        }
+
+        UA_ModifyMonitoredItemsRequest request;
+        UA_ModifyMonitoredItemsRequest_init(&request);
+        request.subscriptionId     = subscription_id;
+        request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+        request.itemsToModify      = items_to_modify.data();
+        request.itemsToModifySize  = items_to_modify.size();
+
+        // the client keeps the client handles of the items, they don't have to be set here
+        auto response = UA_Client_MonitoredItems_modify(m_connection->getClientHandle(), request);
+        auto status   = response.responseHeader.serviceResult;
+        if (status == UA_STATUSCODE_GOOD && response.resultsSize != handles.size()) {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_subscription_manager)
+                << "Failed to modify" << handles.size() << "monitored items:" << UA_StatusCode_name(status);
+            UA_ModifyMonitoredItemsResponse_clear(&response);
+            return false;
+        }
+
+        bool modified{true};
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            const auto& result = response.results[i];
+            if (result.statusCode != UA_STATUSCODE_GOOD) {
+                qCWarning(lc_opcua_subscription_manager)
+                    << "Failed to modify monitored item:" << UA_StatusCode_name(result.statusCode);
+                modified = false;
+                continue;
+            }
+            m_items.at(handles[i]).parameters =
+                revise_parameters(parameters, result.revisedSamplingInterval, result.revisedQueueSize);
+        }
+        UA_ModifyMonitoredItemsResponse_clear(&response);
+        return modified;
+    }
+
+    std::map<UA_UInt32, std::vector<SubscriptionManager::ItemHandle>>
+    SubscriptionManager::groupBySubscription(std::span<const ItemHandle> handles) const {
+        std::map<UA_UInt32, std::vector<ItemHandle>> items_by_subscription;
+        for (const auto handle : handles) {
+            if (const auto item = m_items.find(handle); item != m_items.end()) {
+                items_by_subscription[item->second.subscription_id].push_back(handle);
+            }
+        }
+        return items_by_subscription;
+    }
+
+    bool SubscriptionManager::setMonitoringModeIn(UA_UInt32 subscription_id, std::span<const ItemHandle> handles,
+                                                  MonitoringMode mode) {
+        std::vector<UA_UInt32> monitored_item_ids;
+        monitored_item_ids.reserve(handles.size());
+        for (const auto handle : handles) {
+            monitored_item_ids.push_back(m_items.at(handle).monitored_item_id);
+        }
+
+        UA_SetMonitoringModeRequest request;
+        UA_SetMonitoringModeRequest_init(&request);
+        request.subscriptionId       = subscription_id;
+        request.monitoringMode       = static_cast<UA_MonitoringMode>(mode);
+        request.monitoredItemIds     = monitored_item_ids.data();
+        request.monitoredItemIdsSize = monitored_item_ids.size();
+
+        auto response = UA_Client_MonitoredItems_setMonitoringMode(m_connection->getClientHandle(), request);
+        auto status   = response.responseHeader.serviceResult;
+        if (status == UA_STATUSCODE_GOOD && response.resultsSize != handles.size()) {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (status != UA_STATUSCODE_GOOD) {
+            qCWarning(lc_opcua_subscription_manager) << "Failed to change the monitoring mode of" << handles.size()
+                                                     << "monitored items:" << UA_StatusCode_name(status);
+            UA_SetMonitoringModeResponse_clear(&response);
+            return false;
+        }
+
+        bool changed{true};
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            if (response.results[i] != UA_STATUSCODE_GOOD) {
+                qCWarning(lc_opcua_subscription_manager)
+                    << "Failed to change the monitoring mode of a monitored item:"
+                    << UA_StatusCode_name(response.results[i]);
+                changed = false;
+            }
+        }
+        UA_SetMonitoringModeResponse_clear(&response);
+        return changed;
+    }
+
+    void SubscriptionManager::releaseItems(UA_UInt32 subscription_id, std::size_t count) {
+        for (auto group = m_subscriptions.begin(); group != m_subscriptions.end(); ++group) {
+            auto& subscriptions = group->second;
+            auto  subscription  = std::ranges::find(subscriptions, subscription_id, &ManagedSubscription::id);
+            if (subscription == subscriptions.end()) {
+                continue;
+            }
+
+            Q_ASSERT(subscription->item_count >= count);
+            subscription->item_count -= count;
+            if (subscription->item_count != 0) {
+                return;
+            }
+
+            const auto lock   = m_connection->lockClient();
+            const auto status = UA_Client_Subscriptions_deleteSingle(m_connection->getClientHandle(), subscription_id);
+            if (status != UA_STATUSCODE_GOOD) {
+                qCDebug(lc_opcua_subscription_manager)
+                    << "Failed to delete subscription" << subscription_id << "reason:" << UA_StatusCode_name(status);
+            }
+            subscriptions.erase(subscription);
+            if (subscriptions.empty()) {
+                m_subscriptions.erase(group);
+            }
+            return;
+        }
+    }
+
+    void SubscriptionManager::forgetSubscriptions() {
+        m_subscriptions.clear();
+        m_items.clear();
+
+        const auto lock = m_connection->lockClient();
+        m_pending_changes.clear();
+    }
+
+    void SubscriptionManager::flushDataChanges() {
+        if (m_pending_changes.empty()) {
+            return;
+        }
+
+        auto batch = takeBatch();
+        std::swap(batch, m_pending_changes);
+        m_connection->postNotification([manager = QPointer{this}, batch = std::move(batch)]() mutable {
+            if (!manager.isNull()) {
+                manager->dispatch(batch);
+                manager->recycleBatch(std::move(batch));
+            }
+        });
+    }
+
+    void SubscriptionManager::dispatch(std::vector<DataChange>& changes) {
+        if (m_replaying) {
+            return;
+        }
+
+        const auto received_at = std::chrono::time_point_cast<TimeSeries::Duration>(std::chrono::system_clock::now());
+        for (const auto& [handle, value] : changes) {
+            // looked up for every change, receivers of valueChanged for earlier changes may have unmonitored the item
+            const auto item = m_items.find(handle);
+            if (item == m_items.end() || item->second.node.isNull()) {
+                continue;
+            }
+
+            auto*      node         = item->second.node.data();
+            const auto attribute_id = item->second.attribute_id;
+            if (attribute_id == AttributeId::VALUE) {
+                m_time_series.record(node->getNodeId(), *value);
+            }
+            if (m_recording != nullptr) {
+                m_recording->append(received_at, node->getNodeId(), attribute_id, *value);
+            }
+            node->updateCache(attribute_id, value);
+            Q_EMIT item->second.owner->valueChanged(node, attribute_id, value);
+        }
+
+        // one write per batch
+        if (m_recording != nullptr && !m_recording->flush()) {
+            qCWarning(lc_opcua_subscription_manager) << "Stopped recording after a write error";
+            m_recording.reset();
+        }
+    }
+
+    bool SubscriptionManager::startRecording(const QDir& directory) {
+        stopRecording();
+        m_recording = RecordingWriter::open(directory, c_recording_segment_size);
+        return m_recording != nullptr;
+    }
+
+    void SubscriptionManager::stopRecording() {
+        m_recording.reset();
+    }
+
+    bool SubscriptionManager::isRecording() const noexcept {
+        return m_recording != nullptr;
+    }
+
+    void SubscriptionManager::setReplay(const RecordingReplay* replay) {
+        m_replaying = replay != nullptr;
+        m_replay    = replay;
+        m_time_series.clear();
+    }
+
+    bool SubscriptionManager::isReplaying() const noexcept {
+        return m_replaying;
+    }
+
+    TimeSeries::TimePoint SubscriptionManager::getCurrentTime() const {
+        // the recorded values are stored under their own timestamps, which are as old as the replay position
+        if (m_replaying && !m_replay.isNull()) {
+            return m_replay->getPosition();
+        }
+        return std::chrono::time_point_cast<TimeSeries::Duration>(std::chrono::system_clock::now());
+    }
+
+    void SubscriptionManager::replay(std::span<const RecordingSegment::Record> records) {
+        // Recorded values are addressed by node id, items by handle. Built once per batch.
+        std::unordered_map<NodeId, std::vector<ItemHandle>> handles_by_node;
+        for (const auto& [handle, item] : m_items) {
+            if (!item.node.isNull()) {
+                handles_by_node[item.node->getNodeId()].push_back(handle);
+            }
+        }
+
+        for (const auto& record : records) {
+            if (record.attribute_id == AttributeId::VALUE) {
+                m_time_series.record(record.node_id, *record.value);
+            }
+            const auto handles = handles_by_node.find(record.node_id);
+            if (handles == handles_by_node.end()) {
+                continue;
+            }
+            for (const auto handle : handles->second) {
+                // receivers of valueChanged for earlier records may have unmonitored the item
+                const auto item = m_items.find(handle);
+                if (item == m_items.end() || item->second.node.isNull()
+                    || item->second.attribute_id != record.attribute_id) {
+                    continue;
+                }
+
+                auto* node = item->second.node.data();
+                node->updateCache(record.attribute_id, record.value);
+                Q_EMIT item->second.owner->valueChanged(node, record.attribute_id, record.value);
+            }
+        }
+    }
+
+    const TimeSeriesStore& SubscriptionManager::getTimeSeriesStore() const noexcept {
+        return m_time_series;
+    }
+
+    TimeSeriesStore& SubscriptionManager::getTimeSeriesStore() noexcept {
+        return m_time_series;
+    }
+
+    std::vector<SubscriptionManager::DataChange> SubscriptionManager::takeBatch() {
+        const std::unique_lock lock(m_batch_pool_mutex);
+        if (m_batch_pool.empty()) {
+            return {};
+        }
+        auto batch = std::move(m_batch_pool.back());
+        m_batch_pool.pop_back();
+        return batch;
+    }
+
+    void SubscriptionManager::recycleBatch(std::vector<DataChange> batch) {
+        // drops the batch's references to the values
+        batch.clear();
+
+        const std::unique_lock lock(m_batch_pool_mutex);
+        if (m_batch_pool.size() < c_batch_pool_size) {
+            m_batch_pool.push_back(std::move(batch));
+        }
+    }
+
+    void SubscriptionManager::onDataChange(UA_Client* /*client*/, UA_UInt32 /*subscription_id*/,
+                                           void* subscription_context, UA_UInt32 /*monitored_item_id*/,
+                                           void* item_context, UA_DataValue* value) {
+        auto* manager = static_cast<SubscriptionManager*>(subscription_context);
+
+        // Take over the value instead of copying it. The client frees the notification after this returns and is
+        // left with an empty value, so large arrays are never copied.
+        opcua::DataValue taken;
+        std::swap(*taken.handle(), *value);
+        manager->m_pending_changes.push_back({
+            .handle = from_item_context(item_context),
+            .value  = std::make_shared<const DataValue>(std::move(taken)),
+        });
+    }
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "../qt_version_check.hpp"
+#include "RecordingReplay.hpp"
+#include "RecordingSegment.hpp"
+#include "RecordingWriter.hpp"
+#include "TimeSeries.hpp"
+#include "TimeSeriesStore.hpp"
+#include "abstraction/AttributeId.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/MonitoringMode.hpp"
+#include "abstraction/MonitoringParameters.hpp"
+#include "abstraction/node/Node.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <open62541/client.h>
+#include <open62541/types.h>
+
+#include <QDir>
+#include <QObject>
+#include <QPointer>
+#include <qtmetamacros.h>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtClassHelperMacros>
+#else
+#include <QtGlobal>
+#endif
+
+namespace magnesia::opcua_qt {
+    class Connection;
+    class MonitoredItemSet;
+
+    /**
+     * @class SubscriptionManager
+     * @brief Packs the monitored items of a connection into as few subscriptions as possible.
+     *
+     * Monitored items are grouped by publishing interval. Every group fills its subscriptions up to the configured
+     * maximum number of items before creating another one. Items are created and deleted in batches limited by the
+     * server's MaxMonitoredItemsPerCall operation limit, so monitoring thousands of attributes only takes a few round
+     * trips. Empty subscriptions are deleted.
+     *
+     * Items are requested through MonitoredItemSet. Must only be used on the thread the connection lives in.
+     *
+     * Data changes are collected while the client is iterated and handed to the connection's thread in one batch per
+     * iteration. Received values are taken over from the client instead of being copied and are shared between the
+     * node caches and the listeners. Numeric values of the Value attribute are additionally recorded in a
+     * TimeSeriesStore.
+     *
+     * See https://reference.opcfoundation.org/Core/Part4/v105/docs/5.12.2
+     */
+    class SubscriptionManager : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(SubscriptionManager)
+
+      public:
+        /// Identifies a monitored item across all subscriptions of the manager. Never 0.
+        using ItemHandle = std::uintptr_t;
+        /// An attribute of a node to monitor.
+        using MonitoredAttribute = std::pair<abstraction::Node*, abstraction::AttributeId>;
+
+        /**
+         * @param connection the connection to create the subscriptions on, also the QObject parent
+         */
+        explicit SubscriptionManager(Connection* connection);
+
+        /**
+         * @brief Creates monitored items for data changes of the given attributes.
+         *
+         * Changes are cached in the nodes and emitted as MonitoredItemSet::valueChanged of the owner.
+         *
+         * @param owner the set the items belong to
+         * @param publishing_interval the publishing interval of the subscriptions to put the items into
+         * @param attributes the attributes to monitor
+         * @param parameters the requested monitoring parameters of every item
+         * @param mode the monitoring mode of every item
+         *
+         * @return one handle per attribute, in the same order. 0 for attributes that couldn't be monitored.
+         */
+        std::vector<ItemHandle> createItems(MonitoredItemSet* owner, std::chrono::milliseconds publishing_interval,
+                                            std::span<const MonitoredAttribute>      attributes,
+                                            const abstraction::MonitoringParameters& parameters,
+                                            abstraction::MonitoringMode              mode);
+
+        /**
+         * @brief Changes the monitoring parameters of items with batched ModifyMonitoredItems requests.
+         *
+         * @param handles the items to change, unknown handles are ignored
+         * @param parameters the requested monitoring parameters
+         *
+         * @return true if the server accepted the parameters for every item
+         */
+        bool modifyItems(std::span<const ItemHandle> handles, const abstraction::MonitoringParameters& parameters);
+
+        /**
+         * @brief Changes the monitoring mode of items with batched SetMonitoringMode requests.
+         *
+         * Items in sampling mode keep sampling and queueing values but don't report them. Once they are switched back
+         * to reporting, the server reports the queued values with the next publish.
+         *
+         * @param handles the items to change, unknown handles are ignored
+         * @param mode the new monitoring mode
+         *
+         * @return true if the server changed the mode of every item
+         */
+        bool setMonitoringMode(std::span<const ItemHandle> handles, abstraction::MonitoringMode mode);
+
+        /**
+         * @brief Gets the monitoring parameters of an item, with the sampling interval and queue size revised by the
+         * server.
+         *
+         * @return the parameters or nullopt if the item doesn't exist
+         */
+        [[nodiscard]] std::optional<abstraction::MonitoringParameters> getItemParameters(ItemHandle handle) const;
+
+        /**
+         * @brief Deletes monitored items created by createItems. Unknown handles are ignored.
+         *
+         * @param handles the items to delete
+         */
+        void deleteItems(std::span<const ItemHandle> handles);
+
+        /**
+         * @brief Gets the number of subscriptions currently held on the server.
+         */
+        [[nodiscard]] std::size_t getSubscriptionCount() const noexcept;
+
+        /**
+         * @brief Gets the history of the numeric values received for monitored Value attributes.
+         */
+        [[nodiscard]] const TimeSeriesStore& getTimeSeriesStore() const noexcept;
+
+        /**
+         * @brief Gets the history of the numeric values received for monitored Value attributes.
+         */
+        [[nodiscard]] TimeSeriesStore& getTimeSeriesStore() noexcept;
+
+        /**
+         * @brief Starts recording every data change to disk. Stops a recording in progress first.
+         *
+         * @param directory directory of the recording
+         *
+         * @return false if the recording couldn't be started
+         *
+         * @see RecordingWriter
+         */
+        bool startRecording(const QDir& directory);
+
+        /**
+         * @brief Stops recording data changes. Does nothing if not recording.
+         */
+        void stopRecording();
+
+        /**
+         * @brief Checks if data changes are being recorded.
+         */
+        [[nodiscard]] bool isRecording() const noexcept;
+
+        /**
+         * @brief Switches between received and replayed data changes.
+         *
+         * While replaying, received data changes are dropped instead of dispatched and recorded, so only replayed
+         * values are shown. The TimeSeriesStore is cleared on every switch, so received and replayed values don't mix.
+         *
+         * @param replay the replay whose records are passed to replay, nullptr to dispatch received data changes again
+         */
+        void setReplay(const RecordingReplay* replay);
+
+        /**
+         * @brief Checks if received data changes are dropped in favor of replayed ones.
+         */
+        [[nodiscard]] bool isReplaying() const noexcept;
+
+        /**
+         * @brief Gets the time the dispatched data changes belong to. That is the position of the replay while
+         * replaying and the current time otherwise.
+         */
+        [[nodiscard]] TimeSeries::TimePoint getCurrentTime() const;
+
+        /**
+         * @brief Dispatches recorded data changes as if they were received, to the items monitoring their attribute.
+         *
+         * Values of Value attributes are recorded in the TimeSeriesStore, also if no item monitors them.
+         *
+         * @param records the recorded data changes
+         *
+         * @see RecordingReplay
+         */
+        void replay(std::span<const RecordingSegment::Record> records);
+
+        /**
+         * @brief Hands the data changes received since the last call to the connection's thread as a single batch.
+         *
+         * Called by the network thread after every iteration of the client. The client has to be locked.
+         */
+        void flushDataChanges();
+
+      private:
+        struct ManagedSubscription {
+            UA_UInt32   id;
+            std::size_t item_count{0};
+        };
+
+        struct DataChange {
+            ItemHandle                                    handle;
+            std::shared_ptr<const abstraction::DataValue> value;
+        };
+
+        struct ManagedItem {
+            QPointer<abstraction::Node>       node;
+            abstraction::AttributeId          attribute_id;
+            MonitoredItemSet*                 owner;
+            UA_UInt32                         subscription_id;
+            UA_UInt32                         monitored_item_id;
+            // as revised by the server
+            abstraction::MonitoringParameters parameters;
+        };
+
+        /**
+         * @brief Returns a subscription of the group with room for more items, creating one if there is none.
+         *
+         * @return the subscription or nullptr if creating it failed
+         */
+        ManagedSubscription* findSubscriptionWithCapacity(std::chrono::milliseconds publishing_interval);
+        /**
+         * @brief Creates the items in a single CreateMonitoredItems request.
+         */
+        void createItemsIn(ManagedSubscription& subscription, MonitoredItemSet* owner,
+                           std::span<const MonitoredAttribute>      attributes,
+                           const abstraction::MonitoringParameters& parameters, abstraction::MonitoringMode mode,
+                           std::vector<ItemHandle>& created);
+        /**
+         * @brief Groups known items by their subscription, unknown handles are dropped.
+         */
+        [[nodiscard]] std::map<UA_UInt32, std::vector<ItemHandle>>
+        groupBySubscription(std::span<const ItemHandle> handles) const;
+        /**
+         * @brief Modifies items of a single subscription in a single ModifyMonitoredItems request.
+         */
+        bool modifyItemsIn(UA_UInt32 subscription_id, std::span<const ItemHandle> handles,
+                           const abstraction::MonitoringParameters& parameters);
+        /**
+         * @brief Changes the monitoring mode of items of a single subscription in a single SetMonitoringMode request.
+         */
+        bool setMonitoringModeIn(UA_UInt32 subscription_id, std::span<const ItemHandle> handles,
+                                 abstraction::MonitoringMode mode);
+        /**
+         * @brief Accounts for deleted items of a subscription and deletes the subscription once it is empty.
+         */
+        void releaseItems(UA_UInt32 subscription_id, std::size_t count);
+        /**
+         * @brief Drops all subscriptions and items without contacting the server. Used once the client disconnected,
+         * which deletes the subscriptions on the client side.
+         */
+        void forgetSubscriptions();
+        void dispatch(std::vector<DataChange>& changes);
+        /**
+         * @brief Takes an empty batch from the pool, keeping the capacity of earlier batches.
+         */
+        std::vector<DataChange> takeBatch();
+        void                    recycleBatch(std::vector<DataChange> batch);
+
+        static void onDataChange(UA_Client* client, UA_UInt32 subscription_id, void* subscription_context,
+                                 UA_UInt32 monitored_item_id, void* item_context, UA_DataValue* value);
+
+      private:
+        Connection* m_connection;
+        std::size_t m_max_items_per_subscription;
+
+        std::map<std::chrono::milliseconds, std::vector<ManagedSubscription>> m_subscriptions;
+        std::unordered_map<ItemHandle, ManagedItem>                           m_items;
+        ItemHandle                                                            m_next_handle{1};
+
+        // kept across reconnects
+        TimeSeriesStore m_time_series;
+
+        std::unique_ptr<RecordingWriter> m_recording;
+        bool                             m_replaying{false};
+        QPointer<const RecordingReplay>  m_replay;
+
+        // filled by the data change callbacks, which always run while the client is locked
+        std::vector<DataChange>              m_pending_changes;
+        // dispatched batches, reused by the network thread
+        std::mutex                           m_batch_pool_mutex;
+        std::vector<std::vector<DataChange>> m_batch_pool;
+    };
+} // namespace magnesia::opcua_qt
@@ -0,0 +1,242 @@
+#include "TimeSeries.hpp"
+
+#include "../qt_version_check.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtAssert>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    // Samples per block summary. Larger blocks need less memory, smaller ones scan fewer samples at bucket edges.
+    constexpr std::size_t c_block_size = 64;
+} // namespace
+
+namespace magnesia::opcua_qt {
+    TimeSeries::TimeSeries(std::size_t capacity, std::optional<Duration> max_age)
+        : m_capacity(std::max<std::size_t>(capacity, 1)), m_max_age(max_age) {}
+
+    bool TimeSeries::append(TimePoint time, double value) {
+        if (m_size > 0 && time.time_since_epoch().count() < m_times[position(m_size - 1)]) {
+            return false;
+        }
+
+        writeSample(time, value);
+        if (m_max_age.has_value()) {
+            dropOlderThan(time - *m_max_age);
+        }
+        return true;
+    }
+
+    void TimeSeries::clear() noexcept {
+        m_times.clear();
+        m_values.clear();
+        m_blocks.clear();
+        m_first = 0;
+        m_size  = 0;
+    }
+
+    std::size_t TimeSeries::size() const noexcept {
+        return m_size;
+    }
+
+    bool TimeSeries::empty() const noexcept {
+        return m_size == 0;
+    }
+
+    std::size_t TimeSeries::capacity() const noexcept {
+        return m_capacity;
+    }
+
+    TimeSeries::Sample TimeSeries::at(std::size_t index) const {
+        Q_ASSERT(index < m_size);
+        const auto pos = position(index);
+        return {.time = TimePoint{Duration{m_times[pos]}}, .value = m_values[pos]};
+    }
+
+    std::optional<TimeSeries::Sample> TimeSeries::latest() const {
+        if (empty()) {
+            return std::nullopt;
+        }
+        return at(m_size - 1);
+    }
+
+    std::size_t TimeSeries::lowerBound(TimePoint time) const {
+        return lowerBound(time, 0, m_size);
+    }
+
+    std::size_t TimeSeries::lowerBoundAfter(TimePoint time, std::size_t first) const {
+        // gallop ahead first, consecutive buckets are usually close to each other
+        const auto  ticks = time.time_since_epoch().count();
+        std::size_t step{1};
+        while (first + step < m_size && m_times[position(first + step)] < ticks) {
+            first += step;
+            step *= 2;
+        }
+        return lowerBound(time, first, std::min(first + step + 1, m_size));
+    }
+
+    std::size_t TimeSeries::lowerBound(TimePoint time, std::size_t first, std::size_t last) const {
+        const auto  ticks = time.time_since_epoch().count();
+        std::size_t count{last - first};
+        while (count > 0) {
+            const auto step = count / 2;
+            if (m_times[position(first + step)] < ticks) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    std::vector<TimeSeries::Sample> TimeSeries::range(TimePoint from, TimePoint to) const {
+        if (to < from) {
+            return {};
+        }
+
+        const auto          first = lowerBound(from);
+        const auto          last  = lowerBoundAfter(to + Duration{1}, first);
+        std::vector<Sample> samples;
+        samples.reserve(last - first);
+        for (auto index = first; index < last; ++index) {
+            samples.push_back(at(index));
+        }
+        return samples;
+    }
+
+    std::vector<TimeSeries::Bucket> TimeSeries::decimate(TimePoint from, TimePoint to, std::size_t bucket_count) const {
+        if (bucket_count == 0 || to < from || empty()) {
+            return {};
+        }
+
+        // both ends are inclusive
+        const auto length = (to - from).count() + 1;
+        const auto count  = std::min(static_cast<std::int64_t>(bucket_count), length);
+
+        std::vector<Bucket> buckets;
+        auto                first = lowerBound(from);
+        for (std::int64_t i = 0; i < count && first < m_size; ++i) {
+            const auto start = from + Duration{length * i / count};
+            const auto end   = from + Duration{length * (i + 1) / count};
+            const auto last  = lowerBoundAfter(end, first);
+            if (last > first) {
+                const auto summary = aggregate(first, last);
+                buckets.push_back({
+                    .start = start,
+                    .end   = end,
+                    .min   = summary.min,
+                    .max   = summary.max,
+                    .mean  = summary.sum / static_cast<double>(summary.count),
+                    .count = summary.count,
+                });
+            }
+            first = last;
+        }
+        return buckets;
+    }
+
+    void TimeSeries::Aggregate::add(double min_value, double max_value, double sum_value,
+                                    std::size_t sample_count) noexcept {
+        min = std::min(min, min_value);
+        max = std::max(max, max_value);
+        sum += sum_value;
+        count += sample_count;
+    }
+
+    std::size_t TimeSeries::position(std::size_t index) const noexcept {
+        // the columns only wrap around once they are full
+        const auto pos = m_first + index;
+        return pos < m_capacity ? pos : pos - m_capacity;
+    }
+
+    TimeSeries::Aggregate TimeSeries::aggregate(std::size_t first, std::size_t last) const {
+        Aggregate result{
+            .min = std::numeric_limits<double>::infinity(),
+            .max = -std::numeric_limits<double>::infinity(),
+        };
+        if (first >= last) {
+            return result;
+        }
+
+        const auto start      = position(first);
+        const auto count      = last - first;
+        const auto until_wrap = std::min(count, m_capacity - start);
+        aggregatePositions(start, start + until_wrap, result);
+        if (count > until_wrap) {
+            aggregatePositions(0, count - until_wrap, result);
+        }
+        return result;
+    }
+
+    void TimeSeries::aggregatePositions(std::size_t first, std::size_t last, Aggregate& aggregate) const {
+        const auto newest = position(m_size - 1);
+        while (first < last) {
+            const auto block       = first / c_block_size;
+            const auto block_start = block * c_block_size;
+            const auto block_end   = std::min(block_start + c_block_size, m_times.size());
+            // the summary of the newest sample's block ends at the newest sample
+            const auto summary_end = newest >= block_start && newest < block_end ? newest + 1 : block_end;
+
+            if (first == block_start && summary_end <= last) {
+                const auto& summary = m_blocks[block];
+                aggregate.add(summary.min, summary.max, summary.sum, summary_end - block_start);
+                first = summary_end;
+                continue;
+            }
+
+            const auto end = std::min(last, block_end);
+            for (; first < end; ++first) {
+                const auto value = m_values[first];
+                aggregate.add(value, value, value, 1);
+            }
+        }
+    }
+
+    void TimeSeries::writeSample(TimePoint time, double value) {
+        // Samples are always written to consecutive positions, so every block is reset before it is filled again.
+        const auto pos   = position(m_size);
+        const auto ticks = time.time_since_epoch().count();
+        if (pos == m_times.size()) {
+            m_times.push_back(ticks);
+            m_values.push_back(value);
+        } else {
+            m_times[pos]  = ticks;
+            m_values[pos] = value;
+        }
+
+        const auto block = pos / c_block_size;
+        if (block == m_blocks.size()) {
+            m_blocks.push_back({.min = value, .max = value, .sum = value});
+        } else if (pos % c_block_size == 0) {
+            m_blocks[block] = {.min = value, .max = value, .sum = value};
+        } else {
+            auto& summary = m_blocks[block];
+            summary.min   = std::min(summary.min, value);
+            summary.max   = std::max(summary.max, value);
+            summary.sum += value;
+        }
+
+        if (m_size == m_capacity) {
+            // overwrote the oldest sample
+            m_first = position(1);
+        } else {
+            ++m_size;
+        }
+    }
+
+    void TimeSeries::dropOlderThan(TimePoint time) noexcept {
+        const auto count = lowerBound(time);
+        m_first          = position(count);
+        m_size -= count;
+    }
+} // namespace magnesia::opcua_qt
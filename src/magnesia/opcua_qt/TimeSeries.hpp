@@ -0,0 +1,176 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class TimeSeries
+     * @brief Ring buffer of numeric samples ordered by time.
+     *
+     * Timestamps and values are stored in separate columns. Once the capacity is reached the oldest samples are
+     * overwritten. Optionally samples older than a maximum age, relative to the newest sample, are dropped as well.
+     *
+     * Every block of 64 consecutive samples keeps its minimum, maximum and sum, so decimating a range only touches the
+     * samples at the edges of the blocks it covers.
+     */
+    class TimeSeries {
+      public:
+        using Duration  = std::chrono::microseconds;
+        using TimePoint = std::chrono::sys_time<Duration>;
+
+        struct Sample {
+            TimePoint time;
+            double    value;
+        };
+
+        /**
+         * @brief Summary of the samples in a time interval.
+         */
+        struct Bucket {
+            /// Start of the interval, inclusive.
+            TimePoint   start;
+            /// End of the interval, exclusive.
+            TimePoint   end;
+            double      min;
+            double      max;
+            double      mean;
+            std::size_t count;
+        };
+
+        /**
+         * @param capacity maximum number of samples kept, at least 1
+         * @param max_age samples older than this, relative to the newest sample, are dropped. nullopt keeps them until
+         * they are overwritten.
+         */
+        explicit TimeSeries(std::size_t capacity, std::optional<Duration> max_age = std::nullopt);
+
+        /**
+         * @brief Appends a sample. Memory is allocated as needed until the capacity is reached.
+         *
+         * @param time timestamp of the sample
+         * @param value value of the sample
+         *
+         * @return false if the sample is older than the newest sample and was dropped
+         */
+        bool append(TimePoint time, double value);
+
+        /**
+         * @brief Removes all samples.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Gets the number of samples.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Checks if there are no samples.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the maximum number of samples.
+         */
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        /**
+         * @brief Gets a sample.
+         *
+         * @param index index of the sample, 0 being the oldest one. Must be less than size().
+         */
+        [[nodiscard]] Sample at(std::size_t index) const;
+
+        /**
+         * @brief Gets the newest sample.
+         *
+         * @return the sample or nullopt if the series is empty
+         */
+        [[nodiscard]] std::optional<Sample> latest() const;
+
+        /**
+         * @brief Finds the first sample not older than a time.
+         *
+         * @return the index of the sample or size() if all samples are older
+         */
+        [[nodiscard]] std::size_t lowerBound(TimePoint time) const;
+
+        /**
+         * @brief Copies all samples in a time interval.
+         *
+         * @param from start of the interval, inclusive
+         * @param to end of the interval, inclusive
+         */
+        [[nodiscard]] std::vector<Sample> range(TimePoint from, TimePoint to) const;
+
+        /**
+         * @brief Splits a time interval into buckets of equal length and summarizes the samples in each of them.
+         *
+         * Buckets without samples are left out. Used to draw a range at a given width with one bucket per pixel.
+         *
+         * @param from start of the interval, inclusive
+         * @param to end of the interval, inclusive
+         * @param bucket_count number of buckets. Fewer are used if the interval is shorter than bucket_count
+         * microseconds.
+         */
+        [[nodiscard]] std::vector<Bucket> decimate(TimePoint from, TimePoint to, std::size_t bucket_count) const;
+
+      private:
+        struct BlockSummary {
+            double min;
+            double max;
+            double sum;
+        };
+
+        struct Aggregate {
+            double      min;
+            double      max;
+            double      sum{0};
+            std::size_t count{0};
+
+            void add(double min_value, double max_value, double sum_value, std::size_t sample_count) noexcept;
+        };
+
+        /**
+         * @brief Maps a sample index to its position in the columns.
+         */
+        [[nodiscard]] std::size_t position(std::size_t index) const noexcept;
+        /**
+         * @brief Finds the first sample not older than a time among the samples with indices in [first, last).
+         */
+        [[nodiscard]] std::size_t lowerBound(TimePoint time, std::size_t first, std::size_t last) const;
+        /**
+         * @brief Finds the first sample not older than a time, starting at index first. Fast if the sample is close.
+         */
+        [[nodiscard]] std::size_t lowerBoundAfter(TimePoint time, std::size_t first) const;
+        /**
+         * @brief Summarizes the samples with indices in [first, last).
+         */
+        [[nodiscard]] Aggregate aggregate(std::size_t first, std::size_t last) const;
+        /**
+         * @brief Summarizes the samples at the positions [first, last), which must not wrap around.
+         */
+        void aggregatePositions(std::size_t first, std::size_t last, Aggregate& aggregate) const;
+        void writeSample(TimePoint time, double value);
+        void dropOlderThan(TimePoint time) noexcept;
+
+      private:
+        std::size_t             m_capacity;
+        std::optional<Duration> m_max_age;
+
+        // columns of the ring buffer, only grow up to the capacity
+        std::vector<std::int64_t> m_times;
+        std::vector<double>       m_values;
+        // m_blocks[i] summarizes the i-th block of positions. The block holding the newest sample only summarizes the
+        // positions up to it, as the ones after it are overwritten next.
+        std::vector<BlockSummary> m_blocks;
+
+        // position of the oldest sample
+        std::size_t m_first{0};
+        std::size_t m_size{0};
+    };
+} // namespace magnesia::opcua_qt
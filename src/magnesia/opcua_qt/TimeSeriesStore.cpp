@@ -0,0 +1,114 @@
+#include "TimeSeriesStore.hpp"
+
+#include "TimeSeries.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <cstddef>
+#include <optional>
+
+#include <open62541/types.h>
+#include <open62541/types_generated.h>
+
+namespace {
+    // Converts a numeric scalar to a sample value. Other types aren't recorded.
+    std::optional<double> to_sample_value(const UA_Variant& variant) {
+        if (!UA_Variant_isScalar(&variant) || variant.type == nullptr) {
+            return std::nullopt;
+        }
+
+        switch (variant.type->typeKind) {
+            case UA_DATATYPEKIND_BOOLEAN:
+                return *static_cast<const UA_Boolean*>(variant.data) ? 1 : 0;
+            case UA_DATATYPEKIND_SBYTE:
+                return *static_cast<const UA_SByte*>(variant.data);
+            case UA_DATATYPEKIND_BYTE:
+                return *static_cast<const UA_Byte*>(variant.data);
+            case UA_DATATYPEKIND_INT16:
+                return *static_cast<const UA_Int16*>(variant.data);
+            case UA_DATATYPEKIND_UINT16:
+                return *static_cast<const UA_UInt16*>(variant.data);
+            case UA_DATATYPEKIND_INT32:
+                return *static_cast<const UA_Int32*>(variant.data);
+            case UA_DATATYPEKIND_UINT32:
+                return *static_cast<const UA_UInt32*>(variant.data);
+            case UA_DATATYPEKIND_INT64:
+                return static_cast<double>(*static_cast<const UA_Int64*>(variant.data));
+            case UA_DATATYPEKIND_UINT64:
+                return static_cast<double>(*static_cast<const UA_UInt64*>(variant.data));
+            case UA_DATATYPEKIND_FLOAT:
+                return *static_cast<const UA_Float*>(variant.data);
+            case UA_DATATYPEKIND_DOUBLE:
+                return *static_cast<const UA_Double*>(variant.data);
+            default:
+                return std::nullopt;
+        }
+    }
+
+    magnesia::opcua_qt::TimeSeries::TimePoint to_time_point(const UA_DataValue& value) {
+        UA_DateTime date_time{0};
+        if (value.hasSourceTimestamp) {
+            date_time = value.sourceTimestamp;
+        } else if (value.hasServerTimestamp) {
+            date_time = value.serverTimestamp;
+        } else {
+            date_time = UA_DateTime_now();
+        }
+        return magnesia::opcua_qt::TimeSeries::TimePoint{
+            magnesia::opcua_qt::TimeSeries::Duration{(date_time - UA_DATETIME_UNIX_EPOCH) / UA_DATETIME_USEC}};
+    }
+} // namespace
+
+namespace magnesia::opcua_qt {
+    using abstraction::DataValue;
+    using abstraction::NodeId;
+
+    TimeSeriesStore::TimeSeriesStore(std::size_t capacity, std::optional<TimeSeries::Duration> max_age)
+        : m_capacity(capacity), m_max_age(max_age) {}
+
+    bool TimeSeriesStore::record(const NodeId& node_id, const DataValue& value) {
+        const auto sample = toSample(*value.handle().handle());
+        if (!sample.has_value()) {
+            return false;
+        }
+
+        auto& series = m_series.try_emplace(node_id, m_capacity, m_max_age).first->second;
+        return series.append(sample->time, sample->value);
+    }
+
+    const TimeSeries* TimeSeriesStore::find(const NodeId& node_id) const {
+        const auto series = m_series.find(node_id);
+        return series != m_series.end() ? &series->second : nullptr;
+    }
+
+    void TimeSeriesStore::remove(const NodeId& node_id) {
+        m_series.erase(node_id);
+    }
+
+    void TimeSeriesStore::clear() noexcept {
+        m_series.clear();
+    }
+
+    std::size_t TimeSeriesStore::getSampleCount() const noexcept {
+        std::size_t count{0};
+        for (const auto& [node_id, series] : m_series) {
+            count += series.size();
+        }
+        return count;
+    }
+
+    std::size_t TimeSeriesStore::getCapacity() const noexcept {
+        return m_capacity;
+    }
+
+    std::optional<TimeSeries::Sample> TimeSeriesStore::toSample(const UA_DataValue& value) {
+        if (!value.hasValue || (value.hasStatus && UA_StatusCode_isBad(value.status))) {
+            return std::nullopt;
+        }
+        const auto sample_value = to_sample_value(value.value);
+        if (!sample_value.has_value()) {
+            return std::nullopt;
+        }
+        return TimeSeries::Sample{.time = to_time_point(value), .value = *sample_value};
+    }
+} // namespace magnesia::opcua_qt
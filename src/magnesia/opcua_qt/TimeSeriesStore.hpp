@@ -0,0 +1,81 @@
+#pragma once
+
+#include "TimeSeries.hpp"
+#include "abstraction/DataValue.hpp"
+#include "abstraction/NodeId.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+#include <open62541/types_generated.h>
+
+namespace magnesia::opcua_qt {
+    /**
+     * @class TimeSeriesStore
+     * @brief In-memory history of the numeric values of a connection's monitored nodes.
+     *
+     * Every node gets its own TimeSeries on its first numeric value. Values are recorded by the SubscriptionManager as
+     * they arrive. Must only be used on the thread the connection lives in.
+     */
+    class TimeSeriesStore {
+      public:
+        /**
+         * @param capacity maximum number of samples kept per node
+         * @param max_age samples older than this, relative to the newest sample of the node, are dropped
+         */
+        TimeSeriesStore(std::size_t capacity, std::optional<TimeSeries::Duration> max_age);
+
+        /**
+         * @brief Records a value of a node.
+         *
+         * The source timestamp is used, or the server timestamp if the source didn't provide one. Only good numeric
+         * scalars, including booleans, are recorded. They are stored as double.
+         *
+         * @param node_id the node the value belongs to
+         * @param value the value of the node's Value attribute
+         *
+         * @return true if the value was recorded
+         */
+        bool record(const abstraction::NodeId& node_id, const abstraction::DataValue& value);
+
+        /**
+         * @brief Gets the recorded values of a node.
+         *
+         * @return the series or nullptr if no numeric value of the node has been recorded
+         */
+        [[nodiscard]] const TimeSeries* find(const abstraction::NodeId& node_id) const;
+
+        /**
+         * @brief Drops the recorded values of a node.
+         */
+        void remove(const abstraction::NodeId& node_id);
+
+        /**
+         * @brief Drops all recorded values.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Gets the number of samples of all nodes.
+         */
+        [[nodiscard]] std::size_t getSampleCount() const noexcept;
+
+        /**
+         * @brief Gets the maximum number of samples kept per node.
+         */
+        [[nodiscard]] std::size_t getCapacity() const noexcept;
+
+        /**
+         * @brief Converts a value to a sample, with the same rules as record.
+         *
+         * @return the sample or nullopt if the value isn't a good numeric scalar
+         */
+        [[nodiscard]] static std::optional<TimeSeries::Sample> toSample(const UA_DataValue& value);
+
+      private:
+        std::size_t                                         m_capacity;
+        std::optional<TimeSeries::Duration>                 m_max_age;
+        std::unordered_map<abstraction::NodeId, TimeSeries> m_series;
+    };
+} // namespace magnesia::opcua_qt
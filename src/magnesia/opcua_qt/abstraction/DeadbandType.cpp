@@ -0,0 +1 @@
+#include "DeadbandType.hpp"
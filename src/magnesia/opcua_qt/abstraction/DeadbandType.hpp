@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace magnesia::opcua_qt::abstraction {
+    /**
+     * @class DeadbandType
+     * @brief How the deadband of a DataChangeFilter is applied.
+     *
+     * @see MonitoringParameters
+     *
+     * See https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+     */
+    enum class DeadbandType : std::uint32_t {
+        /// Every change is reported.
+        NONE,
+        /// Changes smaller than the deadband value are not reported.
+        ABSOLUTE,
+        /// Changes smaller than the deadband value in percent of the EURange are not reported.
+        PERCENT,
+    };
+} // namespace magnesia::opcua_qt::abstraction
@@ -1,5 +1,7 @@
 #include "MonitoringParameters.hpp"
 
+#include "DeadbandType.hpp"
+
 #include <cstdint>
 #include <utility>
 
@@ -21,6 +23,11 @@ namespace magnesia::opcua_qt::abstraction {
         m_parameters.discardOldest = discard;
     }
 
+    void MonitoringParameters::setDeadband(DeadbandType type, double value) noexcept {
+        m_deadband_type  = type;
+        m_deadband_value = value;
+    }
+
     [[nodiscard]] double MonitoringParameters::getSamplingInterval() const noexcept {
         return m_parameters.samplingInterval;
     }
@@ -33,6 +40,14 @@ namespace magnesia::opcua_qt::abstraction {
         return m_parameters.discardOldest;
     }
 
+    [[nodiscard]] DeadbandType MonitoringParameters::getDeadbandType() const noexcept {
+        return m_deadband_type;
+    }
+
+    [[nodiscard]] double MonitoringParameters::getDeadbandValue() const noexcept {
+        return m_deadband_value;
+    }
+
     [[nodiscard]] const opcua::services::MonitoringParametersEx& MonitoringParameters::handle() const noexcept {
         return m_parameters;
     }
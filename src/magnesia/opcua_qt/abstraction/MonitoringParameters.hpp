@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DeadbandType.hpp"
+
 #include <cstdint>
 
 #include <open62541pp/services/MonitoredItem.h>
@@ -15,6 +17,11 @@ namespace magnesia::opcua_qt::abstraction {
      */
     class MonitoringParameters {
       public:
+        /**
+         * Monitoring parameters with the library defaults and no deadband.
+         */
+        MonitoringParameters() = default;
+
         /**
          * @param parameters Monitoring parameters.
          */
@@ -42,6 +49,14 @@ namespace magnesia::opcua_qt::abstraction {
          */
         void setDiscardOldest(bool discard) noexcept;
 
+        /**
+         * Set the deadband of the data change filter. Only applies to the Value attribute.
+         *
+         * @param type how the deadband is applied, NONE to report every change
+         * @param value the deadband, absolute or in percent depending on type
+         */
+        void setDeadband(DeadbandType type, double value) noexcept;
+
         /**
          * Get the sampling interval.
          */
@@ -57,16 +72,28 @@ namespace magnesia::opcua_qt::abstraction {
         [[nodiscard]] bool getDiscardOldest() const noexcept;
 
         /**
-         * Get the underlying monitoring parameters.
+         * Get how the deadband is applied.
+         */
+        [[nodiscard]] DeadbandType getDeadbandType() const noexcept;
+
+        /**
+         * Get the deadband value.
+         */
+        [[nodiscard]] double getDeadbandValue() const noexcept;
+
+        /**
+         * Get the underlying monitoring parameters. The deadband isn't part of them.
          */
         [[nodiscard]] const opcua::services::MonitoringParametersEx& handle() const noexcept;
 
         /**
-         * Get the underlying monitoring parameters.
+         * Get the underlying monitoring parameters. The deadband isn't part of them.
          */
         [[nodiscard]] opcua::services::MonitoringParametersEx& handle() noexcept;
 
       private:
         opcua::services::MonitoringParametersEx m_parameters;
+        DeadbandType                            m_deadband_type{DeadbandType::NONE};
+        double                                  m_deadband_value{0};
     };
 } // namespace magnesia::opcua_qt::abstraction
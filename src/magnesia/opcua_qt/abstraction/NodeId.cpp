@@ -1,14 +1,32 @@
 #include "NodeId.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <utility>
 
+#include <open62541/types.h>
 #include <open62541pp/types/NodeId.h>
 
+#include <QByteArray>
+#include <QString>
 #include <QVariant>
 
 namespace magnesia::opcua_qt::abstraction {
-    NodeId::NodeId(opcua::NodeId node_id) : m_node_id(std::move(node_id)) {}
+    NodeId::NodeId(opcua::NodeId node_id) : m_node_id(std::move(node_id)), m_hash(UA_NodeId_hash(m_node_id.handle())) {}
+
+    std::optional<NodeId> NodeId::fromString(const QString& node_id) {
+        auto      utf8 = node_id.toUtf8();
+        UA_String string;
+        string.length = static_cast<std::size_t>(utf8.size());
+        string.data   = reinterpret_cast<UA_Byte*>(utf8.data());
+
+        opcua::NodeId parsed;
+        if (UA_NodeId_parse(parsed.handle(), string) != UA_STATUSCODE_GOOD) {
+            return std::nullopt;
+        }
+        return NodeId{std::move(parsed)};
+    }
 
     std::uint16_t NodeId::getNamespaceIndex() const noexcept {
         return m_node_id.getNamespaceIndex();
@@ -26,12 +44,13 @@ namespace magnesia::opcua_qt::abstraction {
         return m_node_id;
     }
 
-    opcua::NodeId& NodeId::handle() noexcept {
-        return m_node_id;
+    std::size_t NodeId::hash() const noexcept {
+        return m_hash;
     }
 
     bool NodeId::operator==(const NodeId& other) const {
-        return m_node_id == other.m_node_id;
+        // differing hashes rule out most unequal ids cheaply
+        return m_hash == other.m_hash && m_node_id == other.m_node_id;
     }
 
     bool NodeId::operator<(const NodeId& other) const {
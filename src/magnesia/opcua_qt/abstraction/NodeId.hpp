@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <optional>
 
 #include <open62541pp/types/NodeId.h>
 
@@ -23,6 +26,14 @@ namespace magnesia::opcua_qt::abstraction {
          */
         explicit NodeId(opcua::NodeId node_id);
 
+        /**
+         * Parse a node id from its string representation, see toString.
+         *
+         * @param node_id String representation of the node id, e.g. "ns=1;s=Temperature".
+         * @return The node id or nullopt if the string isn't a valid node id.
+         */
+        [[nodiscard]] static std::optional<NodeId> fromString(const QString& node_id);
+
         /**
          * Get the namespace index.
          */
@@ -44,14 +55,24 @@ namespace magnesia::opcua_qt::abstraction {
         [[nodiscard]] const opcua::NodeId& handle() const noexcept;
 
         /**
-         * Get the underlying node id.
+         * Get a hash of this node id. Equal node ids have equal hashes. Computed once on construction, node ids are
+         * used as keys of hash maps that are looked up often. There is no mutable access to the node id for that
+         * reason.
          */
-        [[nodiscard]] opcua::NodeId& handle() noexcept;
+        [[nodiscard]] std::size_t hash() const noexcept;
 
         bool operator==(const NodeId& other) const;
         bool operator<(const NodeId& other) const;
 
       private:
         opcua::NodeId m_node_id;
+        std::size_t   m_hash;
     };
 } // namespace magnesia::opcua_qt::abstraction
+
+template<>
+struct std::hash<magnesia::opcua_qt::abstraction::NodeId> {
+    std::size_t operator()(const magnesia::opcua_qt::abstraction::NodeId& node_id) const noexcept {
+        return node_id.hash();
+    }
+};
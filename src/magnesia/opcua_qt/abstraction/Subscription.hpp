@@ -24,6 +24,10 @@
 #include <QtGlobal>
 #endif
 
+namespace magnesia::opcua_qt {
+    class Connection;
+} // namespace magnesia::opcua_qt
+
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class Subscription
@@ -40,8 +44,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param subscription Subscription to a client.
+         * @param connection Connection the subscription belongs to.
          */
-        explicit Subscription(opcua::Subscription<opcua::Client> subscription);
+        Subscription(opcua::Subscription<opcua::Client> subscription, Connection* connection);
         ~Subscription() override;
 
         /**
@@ -78,12 +83,16 @@ namespace magnesia::opcua_qt::abstraction {
         MonitoredItem subscribeEvent(Node* node_id);
 
         /**
-         * Get the underlying subscription
+         * Get the underlying subscription. The client needs to be locked while using it.
+         *
+         * @see Connection::lockClient
          */
         [[nodiscard]] const opcua::Subscription<opcua::Client>& handle() const noexcept;
 
         /**
-         * Get the underlying subscription
+         * Get the underlying subscription. The client needs to be locked while using it.
+         *
+         * @see Connection::lockClient
          */
         [[nodiscard]] opcua::Subscription<opcua::Client>& handle() noexcept;
 
@@ -91,10 +100,8 @@ namespace magnesia::opcua_qt::abstraction {
         void valueChanged(Node* node, AttributeId attribute_id, std::shared_ptr<DataValue> value);
         void eventTriggered(Node* node, std::shared_ptr<std::vector<Variant>>);
 
-      private:
-        static void updateNodeCache(Node* node, AttributeId attribute_id, const DataValue& value);
-
       private:
         opcua::Subscription<opcua::Client> m_subscription;
+        Connection*                        m_connection;
     };
 } // namespace magnesia::opcua_qt::abstraction
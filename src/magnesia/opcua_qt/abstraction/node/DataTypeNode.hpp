@@ -7,8 +7,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class DataTypeNode
@@ -23,9 +21,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the DataTypeNode.
+         * @param connection Connection of the DataTypeNode, also used as its parent.
          */
-        explicit DataTypeNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit DataTypeNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] std::optional<bool> isAbstract() override;
     };
@@ -1,5 +1,6 @@
 #include "MethodNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "Node.hpp"
 
 #include <optional>
@@ -9,14 +10,14 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    MethodNode::MethodNode(opcua::Node<opcua::Client> node, QObject* parent) : Node(std::move(node), parent) {}
+    MethodNode::MethodNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     std::optional<bool> MethodNode::isExecutable() {
         try {
-            return wrapCache(&Cache::is_executable, [this] { return handle().readExecutable(); });
+            return wrapCache(AttributeId::EXECUTABLE, &Cache::is_executable,
+                             [this] { return handle().readExecutable(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -24,7 +25,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<bool> MethodNode::isUserExecutable() {
         try {
-            return wrapCache(&Cache::is_user_executable, [this] { return handle().readUserExecutable(); });
+            return wrapCache(AttributeId::USER_EXECUTABLE, &Cache::is_user_executable,
+                             [this] { return handle().readUserExecutable(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -7,8 +7,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class MethodNode
@@ -23,9 +21,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the MethodNode.
+         * @param connection Connection of the MethodNode, also used as its parent.
          */
-        explicit MethodNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit MethodNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] std::optional<bool> isExecutable() override;
         [[nodiscard]] std::optional<bool> isUserExecutable() override;
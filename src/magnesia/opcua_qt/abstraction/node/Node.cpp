@@ -1,6 +1,11 @@
 #include "Node.hpp"
 
+#include "../../../qt_version_check.hpp"
+#include "../../Connection.hpp"
+#include "../../HistoryRead.hpp"
+#include "../../TimeSeries.hpp"
 #include "../AccessLevelBitmask.hpp"
+#include "../AttributeId.hpp"
 #include "../DataValue.hpp"
 #include "../EventNotifierBitmask.hpp"
 #include "../LocalizedText.hpp"
@@ -20,21 +25,110 @@
 #include "VariableTypeNode.hpp"
 #include "ViewNode.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include <open62541/types.h>
 #include <open62541pp/Client.h>
 #include <open62541pp/Common.h>
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
+#include <open62541pp/services/View.h>
+#include <open62541pp/types/Builtin.h>
+#include <open62541pp/types/Composed.h>
 
+#include <QLoggingCategory>
 #include <QObject>
+#include <QPointer>
+#include <QUtf8StringView>
+
+#ifdef MAGNESIA_HAS_QT_6_5
+#include <QtTypeTraits>
+#else
+#include <QtGlobal>
+#endif
+
+namespace {
+    Q_LOGGING_CATEGORY(lc_opcua_node, "magnesia.opcua.node")
+} // namespace
 
 namespace magnesia::opcua_qt::abstraction {
-    Node::Node(opcua::Node<opcua::Client> node, QObject* parent) : QObject(parent), m_node(std::move(node)) {}
+    namespace {
+        /**
+         * Get the attributes a node of the given class has, without the NodeId.
+         *
+         * See https://reference.opcfoundation.org/Core/Part3/v104/docs/5
+         */
+        std::vector<AttributeId> attributes_of(NodeClass node_class) {
+            std::vector<AttributeId> attributes{
+                AttributeId::NODE_CLASS,  AttributeId::BROWSE_NAME, AttributeId::DISPLAY_NAME,
+                AttributeId::DESCRIPTION, AttributeId::WRITE_MASK,  AttributeId::USER_WRITE_MASK,
+            };
+
+            switch (node_class) {
+                case NodeClass::OBJECT:
+                    attributes.push_back(AttributeId::EVENT_NOTFIER);
+                    break;
+                case NodeClass::VARIABLE:
+                    attributes.insert(attributes.end(),
+                                      {AttributeId::VALUE, AttributeId::DATA_TYPE, AttributeId::VALUE_RANK,
+                                       AttributeId::ARRAY_DIMENSIONS, AttributeId::ACCESS_LEVEL,
+                                       AttributeId::USER_ACCESS_LEVEL, AttributeId::MINIMUM_SAMPLING_INTERVAL,
+                                       AttributeId::HISTORIZING});
+                    break;
+                case NodeClass::METHOD:
+                    attributes.insert(attributes.end(), {AttributeId::EXECUTABLE, AttributeId::USER_EXECUTABLE});
+                    break;
+                case NodeClass::OBJECT_TYPE:
+                case NodeClass::DATA_TYPE:
+                    attributes.push_back(AttributeId::IS_ABSTRACT);
+                    break;
+                case NodeClass::VARIABLE_TYPE:
+                    attributes.insert(attributes.end(),
+                                      {AttributeId::VALUE, AttributeId::DATA_TYPE, AttributeId::VALUE_RANK,
+                                       AttributeId::ARRAY_DIMENSIONS, AttributeId::IS_ABSTRACT});
+                    break;
+                case NodeClass::REFERENCE_TYPE:
+                    attributes.insert(attributes.end(),
+                                      {AttributeId::IS_ABSTRACT, AttributeId::SYMMETRIC, AttributeId::INVERSE_NAME});
+                    break;
+                case NodeClass::VIEW:
+                    attributes.insert(attributes.end(), {AttributeId::CONTAINS_NO_LOOPS, AttributeId::EVENT_NOTFIER});
+                    break;
+            }
+            return attributes;
+        }
+
+        /**
+         * Check if reading an attribute failed because of the node itself, so reading it again would fail as well.
+         */
+        bool is_permanent_failure(opcua::StatusCode status) {
+            switch (status.get()) {
+                case UA_STATUSCODE_BADATTRIBUTEIDINVALID:
+                case UA_STATUSCODE_BADNODEIDUNKNOWN:
+                case UA_STATUSCODE_BADNODEIDINVALID:
+                case UA_STATUSCODE_BADNOTREADABLE:
+                case UA_STATUSCODE_BADUSERACCESSDENIED:
+                case UA_STATUSCODE_BADNOTSUPPORTED:
+                case UA_STATUSCODE_BADNOTIMPLEMENTED:
+                case UA_STATUSCODE_BADDATAENCODINGUNSUPPORTED:
+                case UA_STATUSCODE_BADTYPEMISMATCH:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    } // namespace
+
+    Node::Node(opcua::Node<opcua::Client> node, Connection* connection)
+        : QObject(connection), m_node(std::move(node)), m_connection(connection) {}
 
     NodeId Node::getNodeId() const {
         return NodeId(m_node.id());
@@ -42,7 +136,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<NodeClass> Node::getNodeClass() {
         try {
-            return wrapCache(&Cache::node_class, [this] { return static_cast<NodeClass>(m_node.readNodeClass()); });
+            return wrapCache(AttributeId::NODE_CLASS, &Cache::node_class,
+                             [this] { return static_cast<NodeClass>(m_node.readNodeClass()); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -50,7 +145,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     const QualifiedName* Node::getBrowseName() {
         try {
-            return &wrapCache(&Cache::browse_name, [this] { return QualifiedName{m_node.readBrowseName()}; });
+            return &wrapCache(AttributeId::BROWSE_NAME, &Cache::browse_name,
+                              [this] { return QualifiedName{m_node.readBrowseName()}; });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -58,7 +154,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     const LocalizedText* Node::getDisplayName() {
         try {
-            return &wrapCache(&Cache::display_name, [this] { return LocalizedText{m_node.readDisplayName()}; });
+            return &wrapCache(AttributeId::DISPLAY_NAME, &Cache::display_name,
+                              [this] { return LocalizedText{m_node.readDisplayName()}; });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -66,7 +163,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     const LocalizedText* Node::getDescription() {
         try {
-            return &wrapCache(&Cache::description, [this] { return LocalizedText{m_node.readDescription()}; });
+            return &wrapCache(AttributeId::DESCRIPTION, &Cache::description,
+                              [this] { return LocalizedText{m_node.readDescription()}; });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -74,7 +172,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<WriteMaskBitmask> Node::getWriteMask() {
         try {
-            return wrapCache(&Cache::write_mask, [this] { return WriteMaskBitmask{m_node.readWriteMask()}; });
+            return wrapCache(AttributeId::WRITE_MASK, &Cache::write_mask,
+                             [this] { return WriteMaskBitmask{m_node.readWriteMask()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -82,7 +181,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<WriteMaskBitmask> Node::getUserWriteMask() {
         try {
-            return wrapCache(&Cache::write_mask, [this] { return WriteMaskBitmask{m_node.readUserWriteMask()}; });
+            return wrapCache(AttributeId::USER_WRITE_MASK, &Cache::user_write_mask,
+                             [this] { return WriteMaskBitmask{m_node.readUserWriteMask()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -90,7 +190,7 @@ namespace magnesia::opcua_qt::abstraction {
 
     Node* Node::getParent() {
         try {
-            return wrapCache(&Cache::parent, [this] { return fromOPCUANode(m_node.browseParent(), parent()); });
+            return wrapCache(&Cache::parent, [this] { return fromOPCUANode(m_node.browseParent(), m_connection); });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -99,11 +199,21 @@ namespace magnesia::opcua_qt::abstraction {
     const std::vector<Node*>* Node::getChildren() {
         try {
             return &wrapCache(&Cache::children, [this] {
-                std::vector<Node*> nodes;
+                // The result mask makes the server return the node class and names of the children, so the children
+                // can be constructed without reading them.
+                const opcua::BrowseDescription description(m_node.id(), opcua::BrowseDirection::Forward,
+                                                           opcua::ReferenceTypeId::HierarchicalReferences, true,
+                                                           opcua::NodeClass::Unspecified, opcua::BrowseResultMask::All);
 
-                for (const auto& node : m_node.browseChildren()) {
-                    if (auto* specific_node = Node::fromOPCUANode(node, parent()); specific_node != nullptr) {
-                        specific_node->m_cache.parent = this;
+                std::vector<Node*> nodes;
+                for (auto& reference : opcua::services::browseAll(m_node.connection(), description)) {
+                    if (auto* specific_node = Node::fromReferenceDescription(
+                            m_node.connection(), ReferenceDescription{std::move(reference)}, m_connection);
+                        specific_node != nullptr) {
+                        // nodes can have several parents, the first one found is kept
+                        if (!specific_node->m_cache.parent.has_value()) {
+                            specific_node->m_cache.parent = this;
+                        }
                         nodes.push_back(specific_node);
                     }
                 }
@@ -114,6 +224,70 @@ namespace magnesia::opcua_qt::abstraction {
         }
     }
 
+    void Node::browseChildrenAsync(const opcua::ByteString& continuation_point, std::uint32_t max_count,
+                                   std::function<void(std::optional<ChildrenPage>)> on_page) {
+        auto on_result = [node = QPointer{this}, first_page = continuation_point.empty(),
+                          on_page = std::move(on_page)](const opcua::BrowseResult& result) {
+            if (node.isNull()) {
+                return;
+            }
+            if (result.getStatusCode().isBad()) {
+                qCWarning(lc_opcua_node) << "Failed to browse children:"
+                                         << QUtf8StringView{result.getStatusCode().name()};
+                std::invoke(on_page, std::nullopt);
+                return;
+            }
+            auto page = node->makeChildrenPage(result);
+            // a first page without continuation point contains all children
+            if (first_page && page.continuation_point.empty() && !node->m_cache.children.has_value()) {
+                node->m_cache.children = page.children;
+            }
+            std::invoke(on_page, std::move(page));
+        };
+        if (continuation_point.empty()) {
+            const opcua::BrowseDescription description(m_node.id(), opcua::BrowseDirection::Forward,
+                                                       opcua::ReferenceTypeId::HierarchicalReferences, true,
+                                                       opcua::NodeClass::Unspecified, opcua::BrowseResultMask::All);
+            m_connection->browseAsync(description, max_count, std::move(on_result));
+        } else {
+            m_connection->browseNextAsync(continuation_point, false, std::move(on_result));
+        }
+    }
+
+    void Node::releaseChildrenBrowse(const opcua::ByteString& continuation_point) {
+        if (!continuation_point.empty()) {
+            m_connection->browseNextAsync(continuation_point, true, [](const opcua::BrowseResult& /*result*/) {});
+        }
+    }
+
+    HistoryRead* Node::readHistoryRaw(TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                      std::uint32_t values_per_page, QObject* parent) {
+        return HistoryRead::readRaw(m_connection, getNodeId(), start, end, values_per_page, parent);
+    }
+
+    HistoryRead* Node::readHistoryProcessed(TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                            TimeSeries::Duration processing_interval, const NodeId& aggregate_type,
+                                            QObject* parent) {
+        return HistoryRead::readProcessed(m_connection, getNodeId(), start, end, processing_interval, aggregate_type,
+                                          parent);
+    }
+
+    Node::ChildrenPage Node::makeChildrenPage(const opcua::BrowseResult& result) {
+        ChildrenPage page{.children = {}, .continuation_point = result.getContinuationPoint()};
+        for (const auto& reference : result.getReferences()) {
+            if (auto* child =
+                    fromReferenceDescription(m_node.connection(), ReferenceDescription{reference}, m_connection);
+                child != nullptr) {
+                // nodes can have several parents, the first one found is kept
+                if (!child->m_cache.parent.has_value()) {
+                    child->m_cache.parent = this;
+                }
+                page.children.push_back(child);
+            }
+        }
+        return page;
+    }
+
     const std::vector<ReferenceDescription>* Node::getReferences() {
         try {
             return &wrapCache(&Cache::references, [this]() -> std::vector<ReferenceDescription> {
@@ -189,6 +363,255 @@ namespace magnesia::opcua_qt::abstraction {
         return {};
     }
 
+    std::vector<AttributeId> Node::getUncachedAttributes() const {
+        std::vector<AttributeId> attributes;
+        if (!m_cache.node_class.has_value()) {
+            // the applicable attributes depend on the node class
+            attributes.push_back(AttributeId::NODE_CLASS);
+            return attributes;
+        }
+
+        for (const auto attribute_id : attributes_of(*m_cache.node_class)) {
+            if (!isCached(attribute_id)) {
+                attributes.push_back(attribute_id);
+            }
+        }
+        return attributes;
+    }
+
+    bool Node::areAttributesLoaded() const {
+        return getLoadableAttributes().empty();
+    }
+
+    void Node::loadAttributesAsync() {
+        if (m_loading_attributes) {
+            return;
+        }
+        auto attribute_ids = getLoadableAttributes();
+        if (attribute_ids.empty()) {
+            return;
+        }
+        m_loading_attributes = true;
+
+        const auto                                  node_id = getNodeId();
+        std::vector<std::pair<NodeId, AttributeId>> attributes;
+        attributes.reserve(attribute_ids.size());
+        for (const auto attribute_id : attribute_ids) {
+            attributes.emplace_back(node_id, attribute_id);
+        }
+
+        m_connection->readAttributesAsync(attributes, [node = QPointer{this}, attribute_ids = std::move(attribute_ids)](
+                                                          const std::vector<DataValue>& values) {
+            if (!node.isNull()) {
+                node->onAttributesRead(attribute_ids, values);
+            }
+        });
+    }
+
+    void Node::onAttributesRead(const std::vector<AttributeId>& attribute_ids, const std::vector<DataValue>& values) {
+        m_loading_attributes = false;
+
+        const bool node_class_was_cached = m_cache.node_class.has_value();
+        for (std::size_t i = 0; i < attribute_ids.size(); ++i) {
+            if (values[i].getStatusCode().handle().isBad()) {
+                qCDebug(lc_opcua_node) << "Failed to read attribute" << qToUnderlying(attribute_ids[i])
+                                       << "of node:" << values[i].getStatusCode().toString();
+                recordFailure(attribute_ids[i], values[i].getStatusCode().handle());
+                continue;
+            }
+            updateCache(attribute_ids[i], values[i]);
+        }
+        Q_EMIT attributesLoaded();
+
+        // the remaining attributes depend on the node class, which is known now
+        if (!node_class_was_cached && m_cache.node_class.has_value()) {
+            loadAttributesAsync();
+        }
+    }
+
+    std::vector<AttributeId> Node::getLoadableAttributes() const {
+        auto attributes = getUncachedAttributes();
+        std::erase_if(attributes,
+                      [this](AttributeId attribute_id) { return getAttributeFailure(attribute_id).has_value(); });
+        return attributes;
+    }
+
+    std::optional<opcua::StatusCode> Node::getAttributeFailure(AttributeId attribute_id) const {
+        const auto failure = m_attribute_failures.find(attribute_id);
+        if (failure == m_attribute_failures.end() || std::chrono::steady_clock::now() >= failure->second.retry_at) {
+            return std::nullopt;
+        }
+        return failure->second.status;
+    }
+
+    void Node::recordFailure(AttributeId attribute_id, opcua::StatusCode status) {
+        const auto retry_at = is_permanent_failure(status)
+                                ? std::chrono::steady_clock::time_point::max()
+                                : std::chrono::steady_clock::now() + m_connection->getAttributeRetryDelay();
+        m_attribute_failures.insert_or_assign(attribute_id, AttributeFailure{.status = status, .retry_at = retry_at});
+    }
+
+    bool Node::isCached(AttributeId attribute_id) const {
+        switch (attribute_id) {
+            case AttributeId::NODE_ID:
+                return true;
+            case AttributeId::NODE_CLASS:
+                return m_cache.node_class.has_value();
+            case AttributeId::BROWSE_NAME:
+                return m_cache.browse_name.has_value();
+            case AttributeId::DISPLAY_NAME:
+                return m_cache.display_name.has_value();
+            case AttributeId::DESCRIPTION:
+                return m_cache.description.has_value();
+            case AttributeId::WRITE_MASK:
+                return m_cache.write_mask.has_value();
+            case AttributeId::USER_WRITE_MASK:
+                return m_cache.user_write_mask.has_value();
+            case AttributeId::IS_ABSTRACT:
+                return m_cache.is_abstract.has_value();
+            case AttributeId::SYMMETRIC:
+                return m_cache.is_symmetric.has_value();
+            case AttributeId::INVERSE_NAME:
+                return m_cache.inverse_name.has_value();
+            case AttributeId::CONTAINS_NO_LOOPS:
+                return m_cache.contains_no_loops.has_value();
+            case AttributeId::EVENT_NOTFIER:
+                return m_cache.event_notifier.has_value();
+            case AttributeId::VALUE:
+                return m_cache.data_value.has_value();
+            case AttributeId::DATA_TYPE:
+                return m_cache.data_type.has_value();
+            case AttributeId::VALUE_RANK:
+                return m_cache.value_rank.has_value();
+            case AttributeId::ARRAY_DIMENSIONS:
+                return m_cache.array_dimensions.has_value();
+            case AttributeId::ACCESS_LEVEL:
+                return m_cache.access_level.has_value();
+            case AttributeId::USER_ACCESS_LEVEL:
+                return m_cache.user_access_level.has_value();
+            case AttributeId::MINIMUM_SAMPLING_INTERVAL:
+                return m_cache.minimum_sampling_interval.has_value();
+            case AttributeId::HISTORIZING:
+                return m_cache.is_historizing.has_value();
+            case AttributeId::EXECUTABLE:
+                return m_cache.is_executable.has_value();
+            case AttributeId::USER_EXECUTABLE:
+                return m_cache.is_user_executable.has_value();
+            case AttributeId::ACCESS_RESTRICTIONS:
+            case AttributeId::ROLE_PERMISSIONS:
+            case AttributeId::USER_ROLE_PERMISSIONS:
+            case AttributeId::DATA_TYPE_DEFINITION:
+            case AttributeId::ACCESS_LEVEL_EX:
+                // not cached, see updateCache
+                return true;
+        }
+        return true;
+    }
+
+    void Node::updateCache(AttributeId attribute_id, const std::shared_ptr<const DataValue>& value) {
+        if (attribute_id != AttributeId::VALUE) {
+            updateCache(attribute_id, *value);
+            return;
+        }
+        m_attribute_failures.erase(attribute_id);
+        setCache(&Cache::data_value, value);
+    }
+
+    void Node::updateCache(AttributeId attribute_id, const DataValue& value) {
+        if (attribute_id == AttributeId::VALUE) {
+            // copies the value only once, the variant isn't needed
+            updateCache(attribute_id, std::make_shared<const DataValue>(value));
+            return;
+        }
+        m_attribute_failures.erase(attribute_id);
+        auto variant = value.getValue();
+
+        // A value of an unexpected type would be misread, the attribute is treated as unavailable instead.
+        try {
+            switch (attribute_id) {
+                case AttributeId::NODE_ID:
+                    // NodeId is the identifier for a node, therefore it will never be updated.
+                    return;
+                case AttributeId::NODE_CLASS:
+                    setCache(&Cache::node_class, variant.getScalar<NodeClass>());
+                    return;
+                case AttributeId::BROWSE_NAME:
+                    setCache(&Cache::browse_name, variant.getScalar<QualifiedName>());
+                    return;
+                case AttributeId::DISPLAY_NAME:
+                    setCache(&Cache::display_name, variant.getScalar<LocalizedText>());
+                    return;
+                case AttributeId::DESCRIPTION:
+                    setCache(&Cache::description, variant.getScalar<LocalizedText>());
+                    return;
+                case AttributeId::WRITE_MASK:
+                    setCache(&Cache::write_mask, variant.getScalar<WriteMaskBitmask>());
+                    return;
+                case AttributeId::USER_WRITE_MASK:
+                    setCache(&Cache::user_write_mask, variant.getScalar<WriteMaskBitmask>());
+                    return;
+                case AttributeId::IS_ABSTRACT:
+                    setCache(&Cache::is_abstract, variant.getScalar<bool>());
+                    return;
+                case AttributeId::SYMMETRIC:
+                    setCache(&Cache::is_symmetric, variant.getScalar<bool>());
+                    return;
+                case AttributeId::INVERSE_NAME:
+                    setCache(&Cache::inverse_name, variant.getScalar<LocalizedText>());
+                    return;
+                case AttributeId::CONTAINS_NO_LOOPS:
+                    setCache(&Cache::contains_no_loops, variant.getScalar<bool>());
+                    return;
+                case AttributeId::EVENT_NOTFIER:
+                    setCache(&Cache::event_notifier, variant.getScalar<EventNotifierBitmask>());
+                    return;
+                case AttributeId::VALUE:
+                    // handled above
+                    return;
+                case AttributeId::DATA_TYPE:
+                    setCache(&Cache::data_type, variant.getScalar<NodeId>());
+                    return;
+                case AttributeId::VALUE_RANK:
+                    setCache(&Cache::value_rank, variant.getScalar<ValueRank>());
+                    return;
+                case AttributeId::ARRAY_DIMENSIONS:
+                    setCache(&Cache::array_dimensions, variant.getArray<std::uint32_t>());
+                    return;
+                case AttributeId::ACCESS_LEVEL:
+                    setCache(&Cache::access_level, variant.getScalar<AccessLevelBitmask>());
+                    return;
+                case AttributeId::USER_ACCESS_LEVEL:
+                    setCache(&Cache::user_access_level, variant.getScalar<AccessLevelBitmask>());
+                    return;
+                case AttributeId::MINIMUM_SAMPLING_INTERVAL:
+                    setCache(&Cache::minimum_sampling_interval, variant.getScalar<double>());
+                    return;
+                case AttributeId::HISTORIZING:
+                    setCache(&Cache::is_historizing, variant.getScalar<bool>());
+                    return;
+                case AttributeId::EXECUTABLE:
+                    setCache(&Cache::is_executable, variant.getScalar<bool>());
+                    return;
+                case AttributeId::USER_EXECUTABLE:
+                    setCache(&Cache::is_user_executable, variant.getScalar<bool>());
+                    return;
+                case AttributeId::ACCESS_RESTRICTIONS:
+                case AttributeId::ROLE_PERMISSIONS:
+                case AttributeId::USER_ROLE_PERMISSIONS:
+                    // TODO: These are optional in base node class but there's no support for them in open62541pp
+
+                case AttributeId::DATA_TYPE_DEFINITION:
+                case AttributeId::ACCESS_LEVEL_EX:
+                    // TODO: These are not implemented in open62541pp
+                    return;
+            }
+        } catch (const opcua::BadVariantAccess& error) {
+            qCDebug(lc_opcua_node) << "Unexpected type of attribute" << qToUnderlying(attribute_id) << "of node:"
+                                   << error.what();
+            recordFailure(attribute_id, UA_STATUSCODE_BADTYPEMISMATCH);
+        }
+    }
+
     const opcua::Node<opcua::Client>& Node::handle() const noexcept {
         return m_node;
     }
@@ -197,28 +620,85 @@ namespace magnesia::opcua_qt::abstraction {
         return m_node;
     }
 
-    Node* Node::fromOPCUANode(opcua::Node<opcua::Client> node, QObject* parent) {
-        switch (node.readNodeClass()) {
-            case opcua::NodeClass::DataType:
-                return new DataTypeNode(node, parent);
-            case opcua::NodeClass::ReferenceType:
-                return new ReferenceTypeNode(node, parent);
-            case opcua::NodeClass::ObjectType:
-                return new ObjectTypeNode(node, parent);
-            case opcua::NodeClass::VariableType:
-                return new VariableTypeNode(node, parent);
-            case opcua::NodeClass::Variable:
-                return new VariableNode(node, parent);
-            case opcua::NodeClass::Object:
-                return new ObjectNode(node, parent);
-            case opcua::NodeClass::Method:
-                return new MethodNode(node, parent);
-            case opcua::NodeClass::View:
-                return new ViewNode(node, parent);
+    Connection* Node::getConnection() const noexcept {
+        return m_connection;
+    }
+
+    std::unique_lock<std::recursive_mutex> Node::lockClient() const {
+        return m_connection->lockClient();
+    }
+
+    Node* Node::fromOPCUANode(opcua::Node<opcua::Client> node, Connection* connection) {
+        if (auto* known_node = connection->findNode(NodeId{node.id()}); known_node != nullptr) {
+            return known_node;
+        }
+
+        const auto lock       = connection->lockClient();
+        const auto node_class = static_cast<NodeClass>(node.readNodeClass());
+        return create(std::move(node), node_class, connection);
+    }
+
+    Node* Node::fromNodeClass(opcua::Node<opcua::Client> node, NodeClass node_class, Connection* connection) {
+        if (auto* known_node = connection->findNode(NodeId{node.id()}); known_node != nullptr) {
+            return known_node;
+        }
+        return create(std::move(node), node_class, connection);
+    }
+
+    Node* Node::fromReferenceDescription(opcua::Client& client, const ReferenceDescription& reference,
+                                         Connection* connection) {
+        const auto& description = reference.handle();
+        if (!description.getNodeId().isLocal()) {
+            return nullptr;
+        }
+
+        auto* node = connection->findNode(NodeId{description.getNodeId().getNodeId()});
+        if (node == nullptr) {
+            node = create({client, description.getNodeId().getNodeId()},
+                          static_cast<NodeClass>(description.getNodeClass()), connection);
+        }
+        if (node != nullptr) {
+            // the browse response already contains these, no need to read them again
+            node->m_cache.browse_name  = QualifiedName{description.getBrowseName()};
+            node->m_cache.display_name = LocalizedText{description.getDisplayName()};
+        }
+        return node;
+    }
+
+    Node* Node::create(opcua::Node<opcua::Client> node, NodeClass node_class, Connection* connection) {
+        Node* specific_node{};
+        switch (node_class) {
+            case NodeClass::DATA_TYPE:
+                specific_node = new DataTypeNode(std::move(node), connection);
+                break;
+            case NodeClass::REFERENCE_TYPE:
+                specific_node = new ReferenceTypeNode(std::move(node), connection);
+                break;
+            case NodeClass::OBJECT_TYPE:
+                specific_node = new ObjectTypeNode(std::move(node), connection);
+                break;
+            case NodeClass::VARIABLE_TYPE:
+                specific_node = new VariableTypeNode(std::move(node), connection);
+                break;
+            case NodeClass::VARIABLE:
+                specific_node = new VariableNode(std::move(node), connection);
+                break;
+            case NodeClass::OBJECT:
+                specific_node = new ObjectNode(std::move(node), connection);
+                break;
+            case NodeClass::METHOD:
+                specific_node = new MethodNode(std::move(node), connection);
+                break;
+            case NodeClass::VIEW:
+                specific_node = new ViewNode(std::move(node), connection);
+                break;
                 // takes care of opcua::NodeClass::Unspecified
             default:
                 return nullptr;
         }
+        specific_node->m_cache.node_class = node_class;
+        connection->addNode(specific_node);
+        return specific_node;
     }
 
     std::optional<std::size_t> Node::childrenCountCached() const {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "../../TimeSeries.hpp"
 #include "../AccessLevelBitmask.hpp"
+#include "../AttributeId.hpp"
 #include "../DataValue.hpp"
 #include "../EventNotifierBitmask.hpp"
 #include "../LocalizedText.hpp"
@@ -12,18 +14,32 @@
 #include "../Variant.hpp"
 #include "../WriteMaskBitmask.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <open62541pp/Client.h>
+#include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
+#include <open62541pp/types/Builtin.h>
+#include <open62541pp/types/Composed.h>
 
 #include <QObject>
 #include <qtmetamacros.h>
 
+namespace magnesia::opcua_qt {
+    class Connection;
+    class HistoryRead;
+} // namespace magnesia::opcua_qt
+
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class Node
@@ -81,7 +97,7 @@ namespace magnesia::opcua_qt::abstraction {
         [[nodiscard]] std::optional<WriteMaskBitmask> getUserWriteMask();
 
         /**
-         * Get the parent node of this node.
+         * Get the parent node of this node. If the node has several parents, this is one of them.
          */
         [[nodiscard]] Node* getParent();
 
@@ -90,6 +106,52 @@ namespace magnesia::opcua_qt::abstraction {
          */
         [[nodiscard]] const std::vector<Node*>* getChildren();
 
+        /**
+         * A page of child nodes browsed by browseChildrenAsync.
+         */
+        struct ChildrenPage {
+            std::vector<Node*> children;
+            // continuation point of the next page, empty after the last page
+            opcua::ByteString continuation_point;
+        };
+
+        /**
+         * Browse a page of child nodes in the background. Returns immediately. The pages are independent of
+         * getChildren, every caller keeps track of its own browse.
+         *
+         * @param continuation_point continuation point of the previous page, empty to browse the first page
+         * @param max_count maximum number of children in the page
+         * @param on_page called with the page once it arrived, or with nullopt if browsing failed. Not called if this
+         *                node was deleted in the meantime.
+         */
+        void browseChildrenAsync(const opcua::ByteString& continuation_point, std::uint32_t max_count,
+                                 std::function<void(std::optional<ChildrenPage>)> on_page);
+
+        /**
+         * Release a continuation point of browseChildrenAsync that isn't continued. Continuation points are a limited
+         * resource on the server.
+         *
+         * @param continuation_point the continuation point
+         */
+        void releaseChildrenBrowse(const opcua::ByteString& continuation_point);
+
+        /**
+         * Read the raw values of this node's history in the background, page by page.
+         *
+         * @see HistoryRead::readRaw
+         */
+        HistoryRead* readHistoryRaw(TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                    std::uint32_t values_per_page, QObject* parent = nullptr);
+
+        /**
+         * Read aggregates of this node's history in the background, page by page.
+         *
+         * @see HistoryRead::readProcessed
+         */
+        HistoryRead* readHistoryProcessed(TimeSeries::TimePoint start, TimeSeries::TimePoint end,
+                                          TimeSeries::Duration processing_interval, const NodeId& aggregate_type,
+                                          QObject* parent = nullptr);
+
         /**
          * Get all references to and from this node.
          */
@@ -197,14 +259,107 @@ namespace magnesia::opcua_qt::abstraction {
          */
         virtual std::vector<Variant> callMethod(const NodeId& method_id, const std::vector<Variant>& args);
 
+        /**
+         * Get the attributes of this node that are not cached yet. Only contains the node class if that isn't known
+         * yet, as the other attributes depend on it.
+         */
+        [[nodiscard]] std::vector<AttributeId> getUncachedAttributes() const;
+
+        /**
+         * Check if an attribute is cached. Getters of cached attributes don't access the network.
+         *
+         * @param attribute_id the attribute to check
+         */
+        [[nodiscard]] bool isCached(AttributeId attribute_id) const;
+
+        /**
+         * Check if all attributes of this node are either cached or known to fail, so no background read is needed at
+         * the moment.
+         */
+        [[nodiscard]] bool areAttributesLoaded() const;
+
+        /**
+         * Read all uncached attributes of this node in the background and cache them. Returns immediately, the
+         * signal attributesLoaded is emitted once the values arrived. Attributes that failed to be read are skipped
+         * according to the retry policy, see getAttributeFailure.
+         *
+         * Does nothing if such a read is already pending or all attributes are loaded.
+         *
+         * @see Connection::readAttributesAsync
+         */
+        void loadAttributesAsync();
+
+        /**
+         * Get the status code the last read of an attribute failed with, as long as the attribute isn't read again.
+         *
+         * Failed reads are remembered so that known-bad attributes don't cause a read on every access. Attributes the
+         * node doesn't have or the user may not read are never read again. Other failures, e.g. timeouts, are retried
+         * once the connection's attribute retry delay has passed.
+         *
+         * @param attribute_id the attribute to check
+         *
+         * @return the status code or nullopt if the attribute may be read
+         */
+        [[nodiscard]] std::optional<opcua::StatusCode> getAttributeFailure(AttributeId attribute_id) const;
+
+        /**
+         * Update the cache of an attribute with a value received from the server.
+         *
+         * @param attribute_id the attribute the value belongs to
+         * @param value the new value of the attribute
+         */
+        void updateCache(AttributeId attribute_id, const DataValue& value);
+
+        /**
+         * Update the cache of an attribute with a value received from the server. A value of the Value attribute is
+         * shared with the cache instead of being copied.
+         *
+         * @param attribute_id the attribute the value belongs to
+         * @param value the new value of the attribute
+         */
+        void updateCache(AttributeId attribute_id, const std::shared_ptr<const DataValue>& value);
+
         /**
          * Create a Node from a opcua Node. The returned node will be a subclass of Node, according to its node class.
+         * Returns the existing Node if the connection already has one with the same NodeId.
          * Returns nullptr if the node has an invalid node class.
          *
          * @param node the opcua Node to wrap
-         * @param parent the parent QObject
+         * @param connection the connection the node belongs to, it becomes the node's QObject parent
          */
-        [[nodiscard]] static Node* fromOPCUANode(opcua::Node<opcua::Client> node, QObject* parent);
+        [[nodiscard]] static Node* fromOPCUANode(opcua::Node<opcua::Client> node, Connection* connection);
+
+        /**
+         * Create a Node from the target of a reference returned by a Browse request. Unlike fromOPCUANode, this
+         * doesn't read anything from the server. The node class, browse name and display name are taken from the
+         * reference description, which must have been browsed with all result mask bits set.
+         * Returns the existing Node if the connection already has one with the same NodeId.
+         * Returns nullptr if the target is on another server or has an invalid node class.
+         *
+         * @param client the client the reference was browsed with
+         * @param reference the reference to the node
+         * @param connection the connection the node belongs to, it becomes the node's QObject parent
+         */
+        [[nodiscard]] static Node*
+        fromReferenceDescription(opcua::Client& client, const ReferenceDescription& reference, Connection* connection);
+
+        /**
+         * Create a Node whose node class is already known, e.g. read with Connection::readAttributesAsync. Unlike
+         * fromOPCUANode, this doesn't read anything from the server.
+         * Returns the existing Node if the connection already has one with the same NodeId.
+         * Returns nullptr if the node class is invalid.
+         *
+         * @param node the opcua Node to wrap
+         * @param node_class the node class of the node
+         * @param connection the connection the node belongs to, it becomes the node's QObject parent
+         */
+        [[nodiscard]] static Node* fromNodeClass(opcua::Node<opcua::Client> node, NodeClass node_class,
+                                                 Connection* connection);
+
+        /**
+         * Get the connection this node belongs to.
+         */
+        [[nodiscard]] Connection* getConnection() const noexcept;
 
         /**
          * Retrieves the underlying node.
@@ -225,14 +380,29 @@ namespace magnesia::opcua_qt::abstraction {
          */
         [[nodiscard]] std::optional<std::size_t> childrenCountCached() const;
 
+      signals:
+        /**
+         * Emitted when a read started by loadAttributesAsync finished. The read attributes are now cached or known to
+         * be unavailable.
+         */
+        void attributesLoaded();
+
       protected:
-        explicit Node(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit Node(opcua::Node<opcua::Client> node, Connection* connection);
+
+        /**
+         * Lock the client of this node's connection. Needs to be held while using the underlying node.
+         *
+         * @see Connection::lockClient
+         */
+        [[nodiscard]] std::unique_lock<std::recursive_mutex> lockClient() const;
 
         struct Cache {
             template<typename T>
             using CacheType = std::optional<T>;
 
-            CacheType<DataValue>                         data_value;
+            // shared with the listeners of data changes, never modified
+            CacheType<std::shared_ptr<const DataValue>>  data_value;
             CacheType<LocalizedText>                     display_name;
             CacheType<LocalizedText>                     description;
             CacheType<LocalizedText>                     inverse_name;
@@ -263,22 +433,88 @@ namespace magnesia::opcua_qt::abstraction {
             std::invoke(std::forward<CacheEntry>(cache_entry), m_cache) = std::forward<ValueType>(value);
         }
 
+        /**
+         * Return the cached attribute, reading it with getter first if it isn't cached. Failed reads are remembered,
+         * reading an attribute that is known to fail throws without accessing the network.
+         *
+         * @throws opcua::BadStatus if the attribute couldn't be read
+         *
+         * @see getAttributeFailure
+         */
+        template<typename CacheEntry, typename Getter,
+                 typename TargetType = std::remove_cvref_t<std::invoke_result_t<CacheEntry, Cache>>::value_type>
+        const TargetType& wrapCache(AttributeId attribute_id, CacheEntry&& cache_entry, Getter&& getter) {
+            auto& entry = std::invoke(std::forward<CacheEntry>(cache_entry), m_cache);
+            if (!entry.has_value()) {
+                if (const auto failure = getAttributeFailure(attribute_id); failure.has_value()) {
+                    throw opcua::BadStatus(*failure);
+                }
+
+                const auto lock = lockClient();
+                try {
+                    entry = std::invoke(std::forward<Getter>(getter));
+                } catch (const opcua::BadStatus& status) {
+                    recordFailure(attribute_id, status.code());
+                    throw;
+                }
+                m_attribute_failures.erase(attribute_id);
+            }
+
+            return *entry;
+        }
+
+        /**
+         * Like the other overload, but for cache entries that aren't attributes. Failed reads aren't remembered.
+         */
         template<typename CacheEntry, typename Getter,
                  typename TargetType = std::remove_cvref_t<std::invoke_result_t<CacheEntry, Cache>>::value_type>
         const TargetType& wrapCache(CacheEntry&& cache_entry, Getter&& getter) {
             auto& entry = std::invoke(std::forward<CacheEntry>(cache_entry), m_cache);
             if (!entry.has_value()) {
-                entry = std::invoke(std::forward<Getter>(getter));
+                const auto lock = lockClient();
+                entry           = std::invoke(std::forward<Getter>(getter));
             }
 
             return *entry;
         }
 
       private:
-        // Subscription updates the cache directly to reduce network round-trips
-        friend class Subscription;
+        /**
+         * Get the uncached attributes that haven't failed to be read before.
+         */
+        [[nodiscard]] std::vector<AttributeId> getLoadableAttributes() const;
+
+        /**
+         * Remember that reading an attribute failed, see getAttributeFailure.
+         */
+        void recordFailure(AttributeId attribute_id, opcua::StatusCode status);
+
+        void onAttributesRead(const std::vector<AttributeId>& attribute_ids, const std::vector<DataValue>& values);
+
+        /**
+         * Create the child nodes of a browse result.
+         */
+        [[nodiscard]] ChildrenPage makeChildrenPage(const opcua::BrowseResult& result);
+
+        /**
+         * Create the Node subclass matching the node class, with the node class already cached.
+         */
+        [[nodiscard]] static Node*
+        create(opcua::Node<opcua::Client> node, NodeClass node_class, Connection* connection);
+
+      private:
         Cache m_cache;
 
+        struct AttributeFailure {
+            opcua::StatusCode status;
+            // time_point::max() if the attribute is never read again
+            std::chrono::steady_clock::time_point retry_at;
+        };
+
+        std::unordered_map<AttributeId, AttributeFailure> m_attribute_failures;
+        bool                                              m_loading_attributes{false};
+
         opcua::Node<opcua::Client> m_node;
+        Connection*                m_connection;
     };
 } // namespace magnesia::opcua_qt::abstraction
@@ -1,5 +1,6 @@
 #include "ObjectNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "../EventNotifierBitmask.hpp"
 #include "Node.hpp"
 
@@ -10,14 +11,13 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    ObjectNode::ObjectNode(opcua::Node<opcua::Client> node, QObject* parent) : Node(std::move(node), parent) {}
+    ObjectNode::ObjectNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     std::optional<EventNotifierBitmask> ObjectNode::getEventNotifierType() {
         try {
-            return wrapCache(&Cache::event_notifier,
+            return wrapCache(AttributeId::EVENT_NOTFIER, &Cache::event_notifier,
                              [this] { return EventNotifierBitmask{handle().readEventNotifier()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
@@ -8,8 +8,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class ObjectNode
@@ -24,9 +22,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the ObjectNode.
+         * @param connection Connection of the ObjectNode, also used as its parent.
          */
-        explicit ObjectNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit ObjectNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] std::optional<EventNotifierBitmask> getEventNotifierType() override;
     };
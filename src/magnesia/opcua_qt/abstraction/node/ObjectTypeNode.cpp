@@ -1,5 +1,6 @@
 #include "ObjectTypeNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "Node.hpp"
 
 #include <optional>
@@ -9,14 +10,14 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    ObjectTypeNode::ObjectTypeNode(opcua::Node<opcua::Client> node, QObject* parent) : Node(std::move(node), parent) {}
+    ObjectTypeNode::ObjectTypeNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     std::optional<bool> ObjectTypeNode::isAbstract() {
         try {
-            return wrapCache(&Cache::is_abstract, [this] { return handle().readIsAbstract(); });
+            return wrapCache(AttributeId::IS_ABSTRACT, &Cache::is_abstract,
+                             [this] { return handle().readIsAbstract(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
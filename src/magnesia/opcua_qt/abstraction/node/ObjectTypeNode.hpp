@@ -7,8 +7,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class ObjectTypeNode
@@ -23,9 +21,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node.
-         * @param parent Parent of the ObjectTypeNode
+         * @param connection Connection of the ObjectTypeNode, also used as its parent.
          */
-        explicit ObjectTypeNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit ObjectTypeNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] std::optional<bool> isAbstract() override;
     };
@@ -1,5 +1,6 @@
 #include "ReferenceTypeNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "../LocalizedText.hpp"
 #include "Node.hpp"
 
@@ -10,15 +11,14 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    ReferenceTypeNode::ReferenceTypeNode(opcua::Node<opcua::Client> node, QObject* parent)
-        : Node(std::move(node), parent) {}
+    ReferenceTypeNode::ReferenceTypeNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     const LocalizedText* ReferenceTypeNode::getInverseName() {
         try {
-            return &wrapCache(&Cache::inverse_name, [this] { return LocalizedText{handle().readInverseName()}; });
+            return &wrapCache(AttributeId::INVERSE_NAME, &Cache::inverse_name,
+                              [this] { return LocalizedText{handle().readInverseName()}; });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -26,7 +26,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<bool> ReferenceTypeNode::isAbstract() {
         try {
-            return wrapCache(&Cache::is_abstract, [this] { return handle().readIsAbstract(); });
+            return wrapCache(AttributeId::IS_ABSTRACT, &Cache::is_abstract,
+                             [this] { return handle().readIsAbstract(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -34,7 +35,7 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<bool> ReferenceTypeNode::isSymmetric() {
         try {
-            return wrapCache(&Cache::is_symmetric, [this] { return handle().readSymmetric(); });
+            return wrapCache(AttributeId::SYMMETRIC, &Cache::is_symmetric, [this] { return handle().readSymmetric(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -8,8 +8,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class ReferenceTypeNode
@@ -24,9 +22,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the ReferenceTypeNode.
+         * @param connection Connection of the ReferenceTypeNode, also used as its parent.
          */
-        explicit ReferenceTypeNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit ReferenceTypeNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] const LocalizedText* getInverseName() override;
         [[nodiscard]] std::optional<bool>  isAbstract() override;
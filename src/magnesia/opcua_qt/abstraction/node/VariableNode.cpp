@@ -2,12 +2,14 @@
 
 #include "../../../qt_version_check.hpp"
 #include "../AccessLevelBitmask.hpp"
+#include "../AttributeId.hpp"
 #include "../DataValue.hpp"
 #include "../NodeId.hpp"
 #include "../ValueRank.hpp"
 #include "Node.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -16,8 +18,6 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 #ifdef MAGNESIA_HAS_QT_6_5
 #include <QtAssert>
 #else
@@ -25,11 +25,14 @@
 #endif
 
 namespace magnesia::opcua_qt::abstraction {
-    VariableNode::VariableNode(opcua::Node<opcua::Client> node, QObject* parent) : Node(std::move(node), parent) {}
+    VariableNode::VariableNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     const DataValue* VariableNode::getDataValue() {
         try {
-            return &wrapCache(&Cache::data_value, [this] { return DataValue{handle().readDataValue()}; });
+            return wrapCache(AttributeId::VALUE, &Cache::data_value,
+                             [this] { return std::make_shared<const DataValue>(handle().readDataValue()); })
+                .get();
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -37,7 +40,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<NodeId> VariableNode::getDataType() {
         try {
-            return wrapCache(&Cache::data_type, [this] { return NodeId{handle().readDataType()}; });
+            return wrapCache(AttributeId::DATA_TYPE, &Cache::data_type,
+                             [this] { return NodeId{handle().readDataType()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -45,7 +49,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<ValueRank> VariableNode::getValueRank() {
         try {
-            return wrapCache(&Cache::value_rank, [this] { return static_cast<ValueRank>(handle().readValueRank()); });
+            return wrapCache(AttributeId::VALUE_RANK, &Cache::value_rank,
+                             [this] { return static_cast<ValueRank>(handle().readValueRank()); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -53,7 +58,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     const std::vector<std::uint32_t>* VariableNode::getArrayDimensions() {
         try {
-            return &wrapCache(&Cache::array_dimensions, [this] { return handle().readArrayDimensions(); });
+            return &wrapCache(AttributeId::ARRAY_DIMENSIONS, &Cache::array_dimensions,
+                              [this] { return handle().readArrayDimensions(); });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -61,7 +67,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<AccessLevelBitmask> VariableNode::getAccessLevel() {
         try {
-            return wrapCache(&Cache::access_level, [this] { return AccessLevelBitmask{handle().readAccessLevel()}; });
+            return wrapCache(AttributeId::ACCESS_LEVEL, &Cache::access_level,
+                             [this] { return AccessLevelBitmask{handle().readAccessLevel()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -69,7 +76,7 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<AccessLevelBitmask> VariableNode::getUserAccessLevel() {
         try {
-            return wrapCache(&Cache::user_access_level,
+            return wrapCache(AttributeId::USER_ACCESS_LEVEL, &Cache::user_access_level,
                              [this] { return AccessLevelBitmask{handle().readUserAccessLevel()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
@@ -78,7 +85,7 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<double> VariableNode::getMinimumSamplingInterval() {
         try {
-            return wrapCache(&Cache::minimum_sampling_interval,
+            return wrapCache(AttributeId::MINIMUM_SAMPLING_INTERVAL, &Cache::minimum_sampling_interval,
                              [this] { return handle().readMinimumSamplingInterval(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
@@ -87,7 +94,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<bool> VariableNode::isHistorizing() {
         try {
-            return wrapCache(&Cache::is_historizing, [this] { return handle().readHistorizing(); });
+            return wrapCache(AttributeId::HISTORIZING, &Cache::is_historizing,
+                             [this] { return handle().readHistorizing(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
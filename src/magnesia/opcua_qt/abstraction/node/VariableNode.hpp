@@ -13,8 +13,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class VariableNode
@@ -29,9 +27,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the VariableNode.
+         * @param connection Connection of the VariableNode, also used as its parent.
          */
-        explicit VariableNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit VariableNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] const DataValue*                  getDataValue() override;
         [[nodiscard]] std::optional<NodeId>             getDataType() override;
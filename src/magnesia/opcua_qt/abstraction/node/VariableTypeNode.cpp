@@ -1,11 +1,13 @@
 #include "VariableTypeNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "../DataValue.hpp"
 #include "../NodeId.hpp"
 #include "../ValueRank.hpp"
 #include "Node.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -14,15 +16,15 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    VariableTypeNode::VariableTypeNode(opcua::Node<opcua::Client> node, QObject* parent)
-        : Node(std::move(node), parent) {}
+    VariableTypeNode::VariableTypeNode(opcua::Node<opcua::Client> node, Connection* connection)
+        : Node(std::move(node), connection) {}
 
     const DataValue* VariableTypeNode::getDataValue() {
         try {
-            return &wrapCache(&Cache::data_value, [this] { return DataValue{handle().readDataValue()}; });
+            return wrapCache(AttributeId::VALUE, &Cache::data_value,
+                             [this] { return std::make_shared<const DataValue>(handle().readDataValue()); })
+                .get();
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -30,7 +32,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<NodeId> VariableTypeNode::getDataType() {
         try {
-            return wrapCache(&Cache::data_type, [this] { return NodeId{handle().readDataType()}; });
+            return wrapCache(AttributeId::DATA_TYPE, &Cache::data_type,
+                             [this] { return NodeId{handle().readDataType()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -38,7 +41,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<ValueRank> VariableTypeNode::getValueRank() {
         try {
-            return wrapCache(&Cache::value_rank, [this] { return static_cast<ValueRank>(handle().readValueRank()); });
+            return wrapCache(AttributeId::VALUE_RANK, &Cache::value_rank,
+                             [this] { return static_cast<ValueRank>(handle().readValueRank()); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -46,7 +50,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     const std::vector<std::uint32_t>* VariableTypeNode::getArrayDimensions() {
         try {
-            return &wrapCache(&Cache::array_dimensions, [this] { return handle().readArrayDimensions(); });
+            return &wrapCache(AttributeId::ARRAY_DIMENSIONS, &Cache::array_dimensions,
+                              [this] { return handle().readArrayDimensions(); });
         } catch (const opcua::BadStatus&) {
             return nullptr;
         }
@@ -54,7 +59,8 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<bool> VariableTypeNode::isAbstract() {
         try {
-            return wrapCache(&Cache::is_abstract, [this] { return handle().readIsAbstract(); });
+            return wrapCache(AttributeId::IS_ABSTRACT, &Cache::is_abstract,
+                             [this] { return handle().readIsAbstract(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
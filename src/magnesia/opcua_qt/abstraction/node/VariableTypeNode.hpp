@@ -12,8 +12,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class VariableTypeNode
@@ -28,9 +26,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node
-         * @param parent Parent of the VariableTypeNode.
+         * @param connection Connection of the VariableTypeNode, also used as its parent.
          */
-        explicit VariableTypeNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit VariableTypeNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         [[nodiscard]] const DataValue*                  getDataValue() override;
         [[nodiscard]] std::optional<NodeId>             getDataType() override;
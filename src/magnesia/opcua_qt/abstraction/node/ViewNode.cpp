@@ -1,5 +1,6 @@
 #include "ViewNode.hpp"
 
+#include "../AttributeId.hpp"
 #include "../EventNotifierBitmask.hpp"
 #include "Node.hpp"
 
@@ -10,14 +11,13 @@
 #include <open62541pp/ErrorHandling.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
-    ViewNode::ViewNode(opcua::Node<opcua::Client> node, QObject* parent) : Node(std::move(node), parent) {}
+    ViewNode::ViewNode(opcua::Node<opcua::Client> node, Connection* connection) : Node(std::move(node), connection) {}
 
     std::optional<bool> ViewNode::containsNoLoops() {
         try {
-            return wrapCache(&Cache::contains_no_loops, [this] { return handle().readContainsNoLoops(); });
+            return wrapCache(AttributeId::CONTAINS_NO_LOOPS, &Cache::contains_no_loops,
+                             [this] { return handle().readContainsNoLoops(); });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
         }
@@ -25,7 +25,7 @@ namespace magnesia::opcua_qt::abstraction {
 
     std::optional<EventNotifierBitmask> ViewNode::getEventNotifierType() {
         try {
-            return wrapCache(&Cache::event_notifier,
+            return wrapCache(AttributeId::EVENT_NOTFIER, &Cache::event_notifier,
                              [this] { return EventNotifierBitmask{handle().readEventNotifier()}; });
         } catch (const opcua::BadStatus&) {
             return std::nullopt;
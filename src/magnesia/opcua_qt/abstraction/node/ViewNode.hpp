@@ -8,8 +8,6 @@
 #include <open62541pp/Client.h>
 #include <open62541pp/Node.h>
 
-#include <QObject>
-
 namespace magnesia::opcua_qt::abstraction {
     /**
      * @class ViewNode
@@ -24,9 +22,9 @@ namespace magnesia::opcua_qt::abstraction {
       public:
         /**
          * @param node Node
-         * @param parent Parent of the ViewNode.
+         * @param connection Connection of the ViewNode, also used as its parent.
          */
-        explicit ViewNode(opcua::Node<opcua::Client> node, QObject* parent);
+        explicit ViewNode(opcua::Node<opcua::Client> node, Connection* connection);
 
         /**
          * Retrieves weather the ViewNode contains loops or not.
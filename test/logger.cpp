@@ -0,0 +1,224 @@
+#include "opcua_qt/LogArchive.hpp"
+#include "opcua_qt/LogEntry.hpp"
+#include "opcua_qt/LogWriter.hpp"
+#include "opcua_qt/Logger.hpp"
+#include "opcua_qt/abstraction/LogCategory.hpp"
+#include "opcua_qt/abstraction/LogLevel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <gtest/gtest.h>
+#include <memory>
+
+#include <QChar>
+#include <QDir>
+#include <QFileInfo>
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+
+namespace magnesia {
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    using opcua_qt::LogArchive;
+    using opcua_qt::LogCategory;
+    using opcua_qt::LogEntry;
+    using opcua_qt::Logger;
+    using opcua_qt::LogWriter;
+    using opcua_qt::LogLevel;
+
+    TEST(LoggerTest, drops_oldest_entries) {
+        Logger      logger{3, 0};
+        std::size_t dropped_signals{0};
+        QObject::connect(&logger, &Logger::logEntriesDropped, &logger,
+                         [&dropped_signals](std::size_t count) { dropped_signals += count; });
+
+        for (int i = 0; i < 5; ++i) {
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, QString::number(i)});
+            logger.flush();
+        }
+
+        EXPECT_EQ(3U, logger.size());
+        EXPECT_EQ(2U, logger.getFirstIndex());
+        EXPECT_EQ(5U, logger.getEndIndex());
+        EXPECT_EQ(2U, logger.getDroppedCount());
+        EXPECT_EQ(2U, dropped_signals);
+        for (std::uint64_t index = logger.getFirstIndex(); index < logger.getEndIndex(); ++index) {
+            EXPECT_EQ(QString::number(index), logger.at(index).getMessage());
+        }
+    }
+
+    TEST(LoggerTest, adds_queued_entries_at_once) {
+        Logger      logger{3, 0};
+        std::size_t added_signals{0};
+        QObject::connect(&logger, &Logger::logEntriesAdded, &logger,
+                         [&added_signals](std::uint64_t /*first_index*/, std::size_t /*count*/) { ++added_signals; });
+
+        for (int i = 0; i < 10; ++i) {
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, QString::number(i)});
+        }
+        EXPECT_EQ(0U, logger.size());
+
+        logger.flush();
+        EXPECT_EQ(1U, added_signals);
+        EXPECT_EQ(3U, logger.size());
+        EXPECT_EQ(7U, logger.getFirstIndex());
+        EXPECT_EQ(7U, logger.getDroppedCount());
+        EXPECT_EQ(QString{"9"}, logger.at(9).getMessage());
+    }
+
+    TEST(LoggerTest, accounts_bytes) {
+        Logger logger{2, 0};
+        EXPECT_EQ(0U, logger.getBytesUsed());
+
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, QString{100, QChar{'a'}}});
+        logger.flush();
+        const auto one_entry = logger.getBytesUsed();
+        EXPECT_GE(one_entry, sizeof(LogEntry) + 100 * sizeof(QChar));
+
+        // different messages, repeats would be collapsed
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, QString{100, QChar{'b'}}});
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, QString{100, QChar{'c'}}});
+        logger.flush();
+        EXPECT_EQ(2 * one_entry, logger.getBytesUsed());
+    }
+
+    TEST(LoggerTest, collapses_repeated_entries) {
+        Logger        logger{10, 0};
+        std::uint64_t repeated_index{0};
+        QObject::connect(&logger, &Logger::logEntryRepeated, &logger,
+                         [&repeated_index](std::uint64_t index) { repeated_index = index; });
+
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, "a"});
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, "a"});
+        logger.log({LogLevel::WARNING, LogCategory::CLIENT, "a"});
+        logger.log({LogLevel::WARNING, LogCategory::CLIENT, "a"});
+        logger.flush();
+        EXPECT_EQ(2U, logger.size());
+        EXPECT_EQ(2U, logger.at(0).getRepeatCount());
+        EXPECT_EQ(2U, logger.at(1).getRepeatCount());
+
+        // repeats in a later flush are added to the newest kept entry
+        logger.log({LogLevel::WARNING, LogCategory::CLIENT, "a"});
+        logger.flush();
+        EXPECT_EQ(2U, logger.size());
+        EXPECT_EQ(1U, repeated_index);
+        EXPECT_EQ(3U, logger.at(1).getRepeatCount());
+        EXPECT_EQ(2U, logger.at(1).getRepeatTimes().size());
+        EXPECT_LE(logger.at(1).getTime(), logger.at(1).getLastTime());
+
+        logger.log({LogLevel::WARNING, LogCategory::SESSION, "a"});
+        logger.flush();
+        EXPECT_EQ(3U, logger.size());
+    }
+
+    TEST(LoggerTest, indexes_levels_and_categories) {
+        Logger logger{4, 0};
+        logger.log({LogLevel::DEBUG, LogCategory::CLIENT, "0"});
+        logger.log({LogLevel::ERROR, LogCategory::NETWORK, "1"});
+        logger.log({LogLevel::INFO, LogCategory::CLIENT, "2"});
+        logger.flush();
+
+        EXPECT_EQ((std::deque<std::uint64_t>{0, 1, 2}), logger.getIndexesWithMinLevel(LogLevel::TRACE));
+        EXPECT_EQ((std::deque<std::uint64_t>{1, 2}), logger.getIndexesWithMinLevel(LogLevel::INFO));
+        EXPECT_EQ((std::deque<std::uint64_t>{1}), logger.getIndexesWithMinLevel(LogLevel::WARNING));
+        EXPECT_EQ((std::deque<std::uint64_t>{0, 2}), logger.getIndexesOfCategory(LogCategory::CLIENT));
+
+        logger.log({LogLevel::INFO, LogCategory::SESSION, "3"});
+        logger.log({LogLevel::INFO, LogCategory::SESSION, "4"});
+        logger.flush();
+
+        EXPECT_EQ((std::deque<std::uint64_t>{1, 2, 3, 4}), logger.getIndexesWithMinLevel(LogLevel::TRACE));
+        EXPECT_EQ((std::deque<std::uint64_t>{2}), logger.getIndexesOfCategory(LogCategory::CLIENT));
+    }
+
+    TEST(LoggerTest, gates_and_rate_limits) {
+        Logger logger{10, 2};
+        logger.setMinLevel(LogCategory::NETWORK, LogLevel::WARNING);
+
+        logger.log({LogLevel::INFO, LogCategory::NETWORK, "below the minimum level"});
+        logger.log({LogLevel::ERROR, LogCategory::NETWORK, "above the minimum level"});
+        for (int i = 0; i < 5; ++i) {
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, QString::number(i)});
+        }
+        logger.flush();
+
+        // the bucket starts with a second worth of entries
+        EXPECT_EQ(3U, logger.size());
+        EXPECT_EQ(QString{"above the minimum level"}, logger.at(0).getMessage());
+        EXPECT_EQ(QString{"1"}, logger.at(2).getMessage());
+    }
+
+    TEST(LoggerTest, persists_entries) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        {
+            Logger logger{10, 0};
+            ASSERT_TRUE(logger.startPersisting(QDir{directory.path()}, 1024 * 1024));
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, "a"});
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, "a"});
+            logger.log({LogLevel::WARNING, LogCategory::SESSION, "b"});
+            logger.flush();
+            // the last entry is held back for repeats until the Logger is destroyed
+        }
+
+        const auto archive = LogArchive::open(QDir{directory.path()});
+        ASSERT_NE(nullptr, archive);
+        ASSERT_EQ(2U, archive->size());
+        const auto first = archive->at(0);
+        ASSERT_TRUE(first.has_value());
+        EXPECT_EQ(QString{"a"}, first->getMessage());
+        EXPECT_EQ(LogCategory::CLIENT, first->getCategory());
+        EXPECT_EQ(2U, first->getRepeatCount());
+        EXPECT_LE(first->getTime(), first->getLastTime());
+        const auto second = archive->at(1);
+        ASSERT_TRUE(second.has_value());
+        EXPECT_EQ(LogLevel::WARNING, second->getLevel());
+        EXPECT_EQ(QString{"b"}, second->getMessage());
+    }
+
+    TEST(LoggerTest, deletes_oldest_persisted_logs) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const QDir history{directory.path()};
+        for (const auto* name : {"a", "b"}) {
+            Logger logger{10, 0};
+            ASSERT_TRUE(logger.startPersisting(QDir{history.absoluteFilePath(name)}, 1024 * 1024, history));
+            logger.log({LogLevel::INFO, LogCategory::CLIENT, "entry"});
+            logger.flush();
+        }
+
+        // both logs have the same size, only the newer one fits next to a new log
+        const auto size = QFileInfo{QDir{history.absoluteFilePath("b")}.absoluteFilePath(LogWriter::segmentName(0))}
+                              .size();
+        Logger logger{10, 0};
+        ASSERT_TRUE(logger.startPersisting(QDir{history.absoluteFilePath("c")}, static_cast<std::uint64_t>(size),
+                                           history));
+        EXPECT_FALSE(history.exists("a"));
+        EXPECT_TRUE(history.exists("b"));
+        EXPECT_NE(nullptr, LogArchive::open(QDir{history.absoluteFilePath("b")}));
+    }
+
+    TEST(LoggerTest, keeps_logs_being_written) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const QDir history{directory.path()};
+        const QDir written{history.absoluteFilePath("a")};
+        auto       writer = LogWriter::open(written, 1024 * 1024, 1024 * 1024, history);
+        ASSERT_NE(nullptr, writer);
+        writer->append({LogLevel::INFO, LogCategory::CLIENT, "entry"});
+        ASSERT_TRUE(writer->flushPending());
+        EXPECT_EQ(nullptr, LogWriter::open(written, 1024 * 1024, 1024 * 1024, history));
+
+        // nothing fits next to the new log, but the one still being written is kept
+        Logger logger{10, 0};
+        ASSERT_TRUE(logger.startPersisting(QDir{history.absoluteFilePath("b")}, 1, history));
+        EXPECT_TRUE(written.exists(LogWriter::segmentName(0)));
+
+        writer.reset();
+        ASSERT_TRUE(logger.startPersisting(QDir{history.absoluteFilePath("c")}, 1, history));
+        EXPECT_FALSE(history.exists("a"));
+    }
+
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+} // namespace magnesia
@@ -0,0 +1,221 @@
+#include "opcua_qt/RecordingSegment.hpp"
+#include "opcua_qt/RecordingWriter.hpp"
+#include "opcua_qt/SegmentFile.hpp"
+#include "opcua_qt/TimeSeries.hpp"
+#include "opcua_qt/abstraction/AttributeId.hpp"
+#include "opcua_qt/abstraction/DataValue.hpp"
+#include "opcua_qt/abstraction/NodeId.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <open62541pp/types/DataValue.h>
+#include <open62541pp/types/Variant.h>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QString>
+#include <QTemporaryDir>
+
+namespace magnesia {
+    // NOLINTBEGIN(bugprone-unchecked-optional-access,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    using opcua_qt::RecordingSegment;
+    using opcua_qt::RecordingWriter;
+    using opcua_qt::SegmentFile;
+    using opcua_qt::TimeSeries;
+    using opcua_qt::abstraction::AttributeId;
+    using opcua_qt::abstraction::DataValue;
+    using opcua_qt::abstraction::NodeId;
+
+    namespace {
+        TimeSeries::TimePoint at_second(std::int64_t second) {
+            return TimeSeries::TimePoint{std::chrono::seconds{second}};
+        }
+
+        NodeId node_id(int number) {
+            return NodeId::fromString(QString{"ns=1;i=%1"}.arg(number)).value();
+        }
+
+        // Writes one value per second, alternating between two nodes, and finishes the segment.
+        QString write_segment(const QDir& directory, int count) {
+            auto writer = RecordingWriter::open(directory, 1024 * 1024);
+            if (writer == nullptr) {
+                ADD_FAILURE() << "Failed to open " << directory.path().toStdString();
+                return {};
+            }
+            for (int i = 0; i < count; ++i) {
+                writer->append(at_second(i), node_id(i % 2), AttributeId::VALUE,
+                               DataValue{opcua::DataValue{opcua::Variant::fromScalar(i * 0.5)}});
+            }
+            EXPECT_TRUE(writer->flush());
+            return directory.absoluteFilePath(RecordingWriter::segmentName(0));
+        }
+
+        std::vector<RecordingSegment::Record> read_all(const RecordingSegment& segment) {
+            std::vector<RecordingSegment::Record> records;
+            segment.read(segment.seek(TimeSeries::TimePoint::min()), TimeSeries::TimePoint::max(),
+                         std::numeric_limits<std::size_t>::max(),
+                         [&records](RecordingSegment::Record&& record) { records.push_back(std::move(record)); });
+            return records;
+        }
+
+        // Offset of the value record received at second, the segment has to be closed before it is modified.
+        std::uint64_t record_offset(const QString& path, std::int64_t second) {
+            const auto segment = RecordingSegment::open(path);
+            if (segment == nullptr) {
+                ADD_FAILURE() << "Failed to open " << path.toStdString();
+                return 0;
+            }
+            return segment->seek(at_second(second));
+        }
+
+        void flip_byte(const QString& path, std::uint64_t offset) {
+            QFile file{path};
+            ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+            ASSERT_TRUE(file.seek(static_cast<qint64>(offset)));
+            auto byte = file.read(1);
+            ASSERT_EQ(1, byte.size());
+            byte[0] = static_cast<char>(~byte[0]);
+            ASSERT_TRUE(file.seek(static_cast<qint64>(offset)));
+            ASSERT_EQ(1, file.write(byte));
+        }
+
+        void replace_index(const QString& path, const QByteArray& index) {
+            QSaveFile file{SegmentFile::indexPath(path)};
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            ASSERT_EQ(index.size(), file.write(index));
+            ASSERT_TRUE(file.commit());
+        }
+    } // namespace
+
+    TEST(RecordingTest, round_trip) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const auto path = write_segment(QDir{directory.path()}, 10);
+        EXPECT_TRUE(QFile::exists(SegmentFile::indexPath(path)));
+
+        const auto segment = RecordingSegment::open(path);
+        ASSERT_NE(nullptr, segment);
+        EXPECT_EQ(10U, segment->size());
+        EXPECT_EQ(at_second(0), segment->getStart());
+        EXPECT_EQ(at_second(9), segment->getEnd());
+        ASSERT_EQ(2U, segment->getNodeIds().size());
+        EXPECT_EQ(node_id(0), segment->getNodeIds()[0]);
+        EXPECT_EQ(node_id(1), segment->getNodeIds()[1]);
+
+        const auto records = read_all(*segment);
+        ASSERT_EQ(10U, records.size());
+        for (int i = 0; i < 10; ++i) {
+            const auto& record = records[static_cast<std::size_t>(i)];
+            EXPECT_EQ(at_second(i), record.time);
+            EXPECT_EQ(node_id(i % 2), record.node_id);
+            EXPECT_EQ(AttributeId::VALUE, record.attribute_id);
+            EXPECT_DOUBLE_EQ(i * 0.5, record.value->getValue().getScalar<double>().value());
+        }
+
+        std::vector<TimeSeries::TimePoint> times;
+        segment->readNode(node_id(1), at_second(2), at_second(8),
+                          [&times](RecordingSegment::Record&& record) { times.push_back(record.time); });
+        EXPECT_EQ((std::vector{at_second(3), at_second(5), at_second(7)}), times);
+    }
+
+    TEST(RecordingTest, recovers_truncated_record) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const auto path = write_segment(QDir{directory.path()}, 10);
+
+        // a crash leaves the last segment without index and possibly with half a record
+        ASSERT_TRUE(QFile::remove(SegmentFile::indexPath(path)));
+        QFile file{path};
+        ASSERT_TRUE(file.resize(file.size() - 3));
+
+        const auto segment = RecordingSegment::open(path);
+        ASSERT_NE(nullptr, segment);
+        EXPECT_EQ(9U, segment->size());
+        EXPECT_EQ(at_second(8), segment->getEnd());
+        const auto records = read_all(*segment);
+        ASSERT_EQ(9U, records.size());
+        EXPECT_EQ(at_second(8), records.back().time);
+    }
+
+    TEST(RecordingTest, skips_corrupted_records) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const auto path = write_segment(QDir{directory.path()}, 10);
+
+        // the record can't be trusted anymore, neither can the sizes of the records after it
+        flip_byte(path, record_offset(path, 6) + 8);
+
+        {
+            // the index was written before the corruption, reading stops at the corrupted record
+            const auto segment = RecordingSegment::open(path);
+            ASSERT_NE(nullptr, segment);
+            const auto records = read_all(*segment);
+            ASSERT_EQ(6U, records.size());
+            EXPECT_EQ(at_second(5), records.back().time);
+        }
+
+        ASSERT_TRUE(QFile::remove(SegmentFile::indexPath(path)));
+        const auto segment = RecordingSegment::open(path);
+        ASSERT_NE(nullptr, segment);
+        EXPECT_EQ(6U, segment->size());
+        EXPECT_EQ(at_second(5), segment->getEnd());
+        EXPECT_EQ(6U, read_all(*segment).size());
+    }
+
+    TEST(RecordingTest, validates_replaced_index) {
+        const QTemporaryDir directory;
+        ASSERT_TRUE(directory.isValid());
+        const auto path = write_segment(QDir{directory.path()}, 10);
+
+        // an index describing more data than the segment has belongs to another segment
+        RecordingSegment::Index foreign;
+        foreign.data_size    = static_cast<std::uint64_t>(QFile{path}.size()) + 1;
+        foreign.record_count = 20;
+        replace_index(path, RecordingSegment::encodeIndex(foreign));
+        {
+            const auto segment = RecordingSegment::open(path);
+            ASSERT_NE(nullptr, segment);
+            EXPECT_EQ(10U, segment->size());
+            EXPECT_EQ(2U, segment->getNodeIds().size());
+            EXPECT_EQ(10U, read_all(*segment).size());
+        }
+
+        replace_index(path, QByteArray{"not an index"});
+        {
+            const auto segment = RecordingSegment::open(path);
+            ASSERT_NE(nullptr, segment);
+            EXPECT_EQ(10U, segment->size());
+            EXPECT_EQ(at_second(9), segment->getEnd());
+        }
+
+        // a valid index is used as is, it may cover only the start of the segment
+        const auto              end = record_offset(path, 4);
+        RecordingSegment::Index partial;
+        partial.data_size = end;
+        partial.node_ids  = {node_id(0), node_id(1)};
+        partial.node_blocks.resize(2);
+        for (int i = 0; i < 4; ++i) {
+            RecordingSegment::indexRecord(partial, record_offset(path, i), at_second(i),
+                                          static_cast<std::uint32_t>(i % 2));
+        }
+        replace_index(path, RecordingSegment::encodeIndex(partial));
+
+        const auto segment = RecordingSegment::open(path);
+        ASSERT_NE(nullptr, segment);
+        EXPECT_EQ(4U, segment->size());
+        EXPECT_EQ(at_second(3), segment->getEnd());
+        EXPECT_EQ(4U, read_all(*segment).size());
+    }
+
+    // NOLINTEND(bugprone-unchecked-optional-access,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+} // namespace magnesia
@@ -0,0 +1,97 @@
+#include "opcua_qt/TimeSeries.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace magnesia {
+    // NOLINTBEGIN(bugprone-unchecked-optional-access,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    using opcua_qt::TimeSeries;
+
+    namespace {
+        TimeSeries::TimePoint at_second(std::int64_t second) {
+            return TimeSeries::TimePoint{std::chrono::seconds{second}};
+        }
+    } // namespace
+
+    TEST(TimeSeriesTest, append_and_range) {
+        TimeSeries series{10};
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_TRUE(series.append(at_second(i), i * 2.0));
+        }
+        EXPECT_FALSE(series.append(at_second(2), 0));
+
+        EXPECT_EQ(5U, series.size());
+        EXPECT_EQ(at_second(4), series.latest()->time);
+
+        const auto samples = series.range(at_second(1), at_second(3));
+        ASSERT_EQ(3U, samples.size());
+        EXPECT_EQ(at_second(1), samples.front().time);
+        EXPECT_DOUBLE_EQ(6.0, samples.back().value);
+        EXPECT_TRUE(series.range(at_second(5), at_second(9)).empty());
+    }
+
+    TEST(TimeSeriesTest, overwrites_oldest_samples) {
+        TimeSeries series{100};
+        for (int i = 0; i < 250; ++i) {
+            series.append(at_second(i), i);
+        }
+
+        EXPECT_EQ(100U, series.size());
+        EXPECT_EQ(at_second(150), series.at(0).time);
+        EXPECT_EQ(at_second(249), series.at(99).time);
+        EXPECT_EQ(50U, series.lowerBound(at_second(200)));
+    }
+
+    TEST(TimeSeriesTest, drops_samples_by_age) {
+        TimeSeries series{1000, std::chrono::seconds{10}};
+        for (int i = 0; i < 100; ++i) {
+            series.append(at_second(i), i);
+        }
+
+        EXPECT_EQ(11U, series.size());
+        EXPECT_EQ(at_second(89), series.at(0).time);
+    }
+
+    TEST(TimeSeriesTest, decimate) {
+        // wraps around several times, so block summaries and raw samples are mixed
+        TimeSeries series{1000};
+        for (int i = 0; i < 2500; ++i) {
+            series.append(at_second(i), i % 100);
+        }
+
+        const auto buckets = series.decimate(at_second(1500), at_second(2499), 10);
+        ASSERT_EQ(10U, buckets.size());
+        for (const auto& bucket : buckets) {
+            EXPECT_EQ(100U, bucket.count);
+            EXPECT_DOUBLE_EQ(0, bucket.min);
+            EXPECT_DOUBLE_EQ(99, bucket.max);
+            EXPECT_DOUBLE_EQ(49.5, bucket.mean);
+        }
+
+        // bucket edges not aligned with the blocks
+        const auto odd = series.decimate(at_second(1537), at_second(1703), 3);
+        std::size_t count{0};
+        for (const auto& bucket : odd) {
+            const auto samples = series.range(bucket.start, bucket.end - std::chrono::microseconds{1});
+            ASSERT_EQ(samples.size(), bucket.count);
+            double min{samples.front().value};
+            double max{samples.front().value};
+            double sum{0};
+            for (const auto& sample : samples) {
+                min = std::min(min, sample.value);
+                max = std::max(max, sample.value);
+                sum += sample.value;
+            }
+            EXPECT_DOUBLE_EQ(min, bucket.min);
+            EXPECT_DOUBLE_EQ(max, bucket.max);
+            EXPECT_DOUBLE_EQ(sum / static_cast<double>(samples.size()), bucket.mean);
+            count += bucket.count;
+        }
+        EXPECT_EQ(167U, count);
+    }
+
+    // NOLINTEND(bugprone-unchecked-optional-access,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+} // namespace magnesia